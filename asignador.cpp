@@ -0,0 +1,288 @@
+#include "asignador.h"
+
+#include <algorithm> // Para std::sort
+
+using namespace std;
+
+/**
+ * @brief Máscara de los bits de host de un prefijo (la parte variable del bloque).
+ */
+template <typename Direccion>
+static inline Direccion bitsHost(int cidr) {
+    return cidr >= RasgosDireccion<Direccion>::BITS ? Direccion(0) : static_cast<Direccion>(~Direccion(0) >> cidr);
+}
+
+/**
+ * @brief Cantidad de direcciones de un bloque con el prefijo dado (2^32 para el /0 de IPv4; 0, es
+ * decir 2^128 módulo 2^128, para el /0 de IPv6).
+ */
+template <typename Direccion>
+static inline typename RasgosDireccion<Direccion>::Cantidad tamanoBloque(int cidr) {
+    using Cantidad = typename RasgosDireccion<Direccion>::Cantidad;
+    return static_cast<Cantidad>(static_cast<Cantidad>(bitsHost<Direccion>(cidr)) + 1);
+}
+
+template <typename Direccion>
+void rangoABloques(Rango<Direccion> rango, vector<Bloque<Direccion>>& bloques) {
+    Direccion inicio = rango.inicio;
+    const Direccion fin = rango.fin;
+    if (inicio > fin) {
+        return;
+    }
+    while (true) {
+        // El bloque más grande que empieza en 'inicio' alineado y no se pasa de 'fin'
+        int cidr = RasgosDireccion<Direccion>::BITS;
+        while (cidr > 0) {
+            const Direccion host = bitsHost<Direccion>(cidr - 1);
+            if ((inicio & host) != 0 || (inicio | host) > fin) {
+                break;
+            }
+            --cidr;
+        }
+        bloques.push_back({inicio, cidr});
+        // Se compara con la última dirección del bloque para no desbordar al final del espacio
+        const Direccion ultima = inicio | bitsHost<Direccion>(cidr);
+        if (ultima >= fin) {
+            break;
+        }
+        inicio = ultima + 1;
+    }
+}
+
+template <typename Direccion>
+void AsignadorBloquesGenerico<Direccion>::inicializar(Direccion redBase, int cidrBaseRed, const vector<Rango<Direccion>>& reservados) {
+    for (auto& lista : libres) {
+        lista.clear();
+    }
+    nivelesConLibres = {};
+    libresTotales = 0;
+    cidrBase = cidrBaseRed;
+
+    const Direccion broadcastBase = redBase | bitsHost<Direccion>(cidrBase);
+
+    // Recorta y ordena los reservados; el espacio libre son los huecos entre ellos
+    vector<Rango<Direccion>> ocupados;
+    ocupados.reserve(reservados.size());
+    for (const Rango<Direccion>& r : reservados) {
+        if (r.fin < redBase || r.inicio > broadcastBase || r.inicio > r.fin) {
+            continue;
+        }
+        ocupados.push_back({max(r.inicio, redBase), min(r.fin, broadcastBase)});
+    }
+    sort(ocupados.begin(), ocupados.end(), [](const Rango<Direccion>& a, const Rango<Direccion>& b) { return a.inicio < b.inicio; });
+
+    vector<Bloque<Direccion>> bloques;
+    Direccion cursor = redBase; // Primera dirección aún no clasificada
+    bool quedaEspacio = true;   // Falso si un reservado llega hasta el final de la red base
+    for (const Rango<Direccion>& r : ocupados) {
+        if (r.inicio > cursor) {
+            rangoABloques<Direccion>({cursor, r.inicio - 1}, bloques);
+        }
+        if (r.fin >= cursor) {
+            if (r.fin == broadcastBase) {
+                quedaEspacio = false;
+                break;
+            }
+            cursor = r.fin + 1;
+        }
+    }
+    if (quedaEspacio) {
+        rangoABloques<Direccion>({cursor, broadcastBase}, bloques);
+    }
+    for (const Bloque<Direccion>& b : bloques) {
+        insertarLibre(b.red, b.cidr);
+    }
+}
+
+template <typename Direccion>
+void AsignadorBloquesGenerico<Direccion>::insertarLibre(Direccion red, int cidr) {
+    libres[cidr].insert(red);
+    marcarNivel(cidr);
+    libresTotales += tamanoBloque<Direccion>(cidr);
+}
+
+template <typename Direccion>
+int AsignadorBloquesGenerico<Direccion>::nivelMasAjustado(int cidr) const {
+    // El nivel libre más ajustado es el de mayor prefijo que no supere 'cidr'
+    for (int palabra = cidr / 64; palabra >= 0; --palabra) {
+        uint64_t candidatos = nivelesConLibres[palabra];
+        if (palabra == cidr / 64) {
+            const int bit = cidr % 64;
+            candidatos &= (bit == 63) ? ~uint64_t(0) : (uint64_t(2) << bit) - 1;
+        }
+        if (candidatos != 0) {
+            return palabra * 64 + 63 - __builtin_clzll(candidatos);
+        }
+    }
+    return -1;
+}
+
+template <typename Direccion>
+bool AsignadorBloquesGenerico<Direccion>::asignar(int cidr, Direccion& red) {
+    if (cidr < cidrBase || cidr > BITS) {
+        return false;
+    }
+    int nivel = nivelMasAjustado(cidr);
+    if (nivel < 0) {
+        return false;
+    }
+
+    auto& lista = libres[nivel];
+    red = *lista.begin();
+    lista.erase(lista.begin());
+    if (lista.empty()) {
+        desmarcarNivel(nivel);
+    }
+    libresTotales -= tamanoBloque<Direccion>(nivel);
+
+    // Divide el bloque: la mitad inferior sigue bajando, la superior queda libre
+    while (nivel < cidr) {
+        ++nivel;
+        insertarLibre(red | (Direccion(1) << (BITS - nivel)), nivel);
+    }
+    return true;
+}
+
+template <typename Direccion>
+size_t AsignadorBloquesGenerico<Direccion>::asignarConsecutivos(int cidr, size_t cantidad, Direccion& primera) {
+    if (cantidad == 0 || cidr < cidrBase || cidr > BITS) {
+        return 0;
+    }
+    const int nivel = nivelMasAjustado(cidr);
+    if (nivel < 0) {
+        return 0;
+    }
+
+    auto& lista = libres[nivel];
+    if (nivel == cidr) {
+        // Bloques del tamaño exacto: se toman los de menor dirección mientras sean contiguos
+        const Direccion paso = static_cast<Direccion>(bitsHost<Direccion>(cidr) + 1); // 0 si el bloque es todo el espacio
+        auto it = lista.begin();
+        primera = *it;
+        size_t tomados = 0;
+        Direccion siguiente = primera;
+        while (it != lista.end() && tomados < cantidad && *it == siguiente) {
+            siguiente = static_cast<Direccion>(*it + paso);
+            ++tomados;
+            ++it;
+            if (siguiente == 0) {
+                break; // El bloque acaba al final del espacio de direcciones
+            }
+        }
+        lista.erase(lista.begin(), it);
+        if (lista.empty()) {
+            desmarcarNivel(nivel);
+        }
+        libresTotales -= tamanoBloque<Direccion>(cidr) * tomados;
+        return tomados;
+    }
+
+    // Un bloque más grande contiene 2^(cidr - nivel) bloques pedidos: se llenan desde el inicio
+    primera = *lista.begin();
+    lista.erase(lista.begin());
+    if (lista.empty()) {
+        desmarcarNivel(nivel);
+    }
+    libresTotales -= tamanoBloque<Direccion>(nivel);
+    const int bitsCabida = cidr - nivel;
+    const size_t tomados = (bitsCabida >= 63 || cantidad < (size_t(1) << bitsCabida)) ? cantidad : size_t(1) << bitsCabida;
+
+    // El resto del bloque vuelve al espacio libre en bloques alineados (los mismos "buddies"
+    // que dejarían 'tomados' llamadas a asignar())
+    const Direccion finBloque = primera | bitsHost<Direccion>(nivel);
+    const Direccion finTomados = primera + static_cast<Direccion>(tomados) * (Direccion(1) << (BITS - cidr)) - 1;
+    if (finTomados != finBloque) {
+        vector<Bloque<Direccion>> restos;
+        rangoABloques<Direccion>({static_cast<Direccion>(finTomados + 1), finBloque}, restos);
+        for (const Bloque<Direccion>& b : restos) {
+            insertarLibre(b.red, b.cidr);
+        }
+    }
+    return tomados;
+}
+
+template <typename Direccion>
+bool AsignadorBloquesGenerico<Direccion>::asignarEn(Direccion red, int cidr) {
+    if (cidr < cidrBase || cidr > BITS || (red & bitsHost<Direccion>(cidr)) != 0) {
+        return false;
+    }
+    // Busca el bloque libre que lo contiene, del más ajustado al mayor
+    for (int nivel = cidr; nivel >= cidrBase; --nivel) {
+        if (!(nivelesConLibres[nivel / 64] & (uint64_t(1) << (nivel % 64)))) {
+            continue;
+        }
+        auto& lista = libres[nivel];
+        auto it = lista.find(static_cast<Direccion>(red & ~bitsHost<Direccion>(nivel)));
+        if (it == lista.end()) {
+            continue;
+        }
+        lista.erase(it);
+        if (lista.empty()) {
+            desmarcarNivel(nivel);
+        }
+        libresTotales -= tamanoBloque<Direccion>(nivel);
+        // Divide hasta el bloque pedido: la mitad que no lo contiene queda libre
+        while (nivel < cidr) {
+            ++nivel;
+            insertarLibre(static_cast<Direccion>((red & ~bitsHost<Direccion>(nivel)) ^ (Direccion(1) << (BITS - nivel))), nivel);
+        }
+        return true;
+    }
+    return false;
+}
+
+template <typename Direccion>
+void AsignadorBloquesGenerico<Direccion>::liberar(Direccion red, int cidr) {
+    while (cidr > cidrBase) {
+        const Direccion companero = red ^ (Direccion(1) << (BITS - cidr));
+        auto& lista = libres[cidr];
+        auto it = lista.find(companero);
+        if (it == lista.end()) {
+            break;
+        }
+        lista.erase(it);
+        if (lista.empty()) {
+            desmarcarNivel(cidr);
+        }
+        libresTotales -= tamanoBloque<Direccion>(cidr);
+        red = min(red, companero);
+        --cidr;
+    }
+    insertarLibre(red, cidr);
+}
+
+template <typename Direccion>
+int AsignadorBloquesGenerico<Direccion>::mayorBloqueLibre() const {
+    for (int palabra = 0; palabra < PALABRAS_NIVELES; ++palabra) {
+        if (nivelesConLibres[palabra] != 0) {
+            return palabra * 64 + __builtin_ctzll(nivelesConLibres[palabra]);
+        }
+    }
+    return -1;
+}
+
+template <typename Direccion>
+void AsignadorBloquesGenerico<Direccion>::rangosLibres(vector<Rango<Direccion>>& rangos) const {
+    rangos.clear();
+    vector<Bloque<Direccion>> bloques;
+    for (int cidr = 0; cidr <= BITS; ++cidr) {
+        for (Direccion red : libres[cidr]) {
+            bloques.push_back({red, cidr});
+        }
+    }
+    sort(bloques.begin(), bloques.end(), [](const Bloque<Direccion>& a, const Bloque<Direccion>& b) { return a.red < b.red; });
+    for (const Bloque<Direccion>& b : bloques) {
+        const Direccion fin = b.red | bitsHost<Direccion>(b.cidr);
+        // Los bloques libres nunca se solapan: si el anterior acaba justo antes, se extiende
+        if (!rangos.empty() && static_cast<Direccion>(rangos.back().fin + 1) == b.red) {
+            rangos.back().fin = fin;
+        } else {
+            rangos.push_back({b.red, fin});
+        }
+    }
+}
+
+template class AsignadorBloquesGenerico<uint32_t>;
+template class AsignadorBloquesGenerico<uint128_t>;
+template void rangoABloques<uint32_t>(Rango<uint32_t>, vector<Bloque<uint32_t>>&);
+template void rangoABloques<uint128_t>(Rango<uint128_t>, vector<Bloque<uint128_t>>&);
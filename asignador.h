@@ -0,0 +1,164 @@
+#ifndef ASIGNADOR_H
+#define ASIGNADOR_H
+
+#include <array>   // Para std::array
+#include <cstddef> // Para size_t
+#include <cstdint> // Para uint32_t y otros tipos enteros de ancho fijo
+#include <set>     // Para std::set (listas libres ordenadas por dirección)
+#include <vector>  // Para std::vector
+
+/**
+ * @brief Entero sin signo de 128 bits para direcciones IPv6 (extensión de GCC y Clang).
+ */
+using uint128_t = unsigned __int128;
+
+/**
+ * @brief Propiedades de cada ancho de dirección admitido por el asignador.
+ * Cantidad es un tipo capaz de contar las direcciones libres: para IPv4 basta uint64_t
+ * (incluso con un /0); para IPv6 se usan 128 bits y se cuenta módulo 2^128, así que en una red base
+ * /0 el 0 representa también el espacio entero (2^128 direcciones).
+ */
+template <typename Direccion>
+struct RasgosDireccion;
+
+template <>
+struct RasgosDireccion<uint32_t> {
+    static constexpr int BITS = 32;
+    static constexpr int PREFIJO_MINIMO = 0;
+    using Cantidad = uint64_t;
+};
+
+template <>
+struct RasgosDireccion<uint128_t> {
+    static constexpr int BITS = 128;
+    static constexpr int PREFIJO_MINIMO = 0;
+    using Cantidad = uint128_t;
+};
+
+/**
+ * @brief Rango cerrado de direcciones [inicio, fin].
+ */
+template <typename Direccion>
+struct Rango {
+    Direccion inicio;
+    Direccion fin;
+};
+
+/**
+ * @brief Bloque alineado de direcciones: red y prefijo CIDR.
+ */
+template <typename Direccion>
+struct Bloque {
+    Direccion red;
+    int cidr;
+};
+
+using RangoIPv4 = Rango<uint32_t>;
+using BloqueIPv4 = Bloque<uint32_t>;
+using RangoIPv6 = Rango<uint128_t>;
+using BloqueIPv6 = Bloque<uint128_t>;
+
+/**
+ * @brief Descompone un rango en la lista mínima de bloques CIDR alineados que lo cubren exactamente.
+ * @param rango El rango a descomponer.
+ * @param bloques Vector al que se añaden los bloques, en orden de dirección (no se vacía).
+ */
+template <typename Direccion>
+void rangoABloques(Rango<Direccion> rango, std::vector<Bloque<Direccion>>& bloques);
+
+/**
+ * @brief Asignador "buddy" de bloques alineados dentro de una red base, para cualquier ancho de dirección.
+ * Mantiene una lista libre (ordenada por dirección) por cada longitud de prefijo. Cada asignación
+ * toma el bloque libre más ajustado (el de prefijo más largo que aún contiene la solicitud) y de
+ * menor dirección, dividiéndolo a mitades si sobra; al liberar, el bloque se fusiona con su
+ * compañero ("buddy") mientras este también esté libre. Asignar y liberar cuestan O(log n).
+ * Se instancia para IPv4 (AsignadorBloques) e IPv6 (AsignadorBloquesIPv6).
+ */
+template <typename Direccion>
+class AsignadorBloquesGenerico {
+public:
+    static constexpr int BITS = RasgosDireccion<Direccion>::BITS;
+    using Cantidad = typename RasgosDireccion<Direccion>::Cantidad;
+
+    /**
+     * @brief Prepara el asignador para una red base, con todo su espacio libre salvo los rangos reservados.
+     * Reutiliza la memoria de usos anteriores.
+     * @param redBase Dirección de red base (alineada a su prefijo).
+     * @param cidrBase Prefijo CIDR de la red base.
+     * @param reservados Rangos ya ocupados; se recortan a la red base y pueden solaparse entre sí.
+     */
+    void inicializar(Direccion redBase, int cidrBase, const std::vector<Rango<Direccion>>& reservados);
+
+    /**
+     * @brief Asigna un bloque del prefijo indicado.
+     * @param cidr Prefijo CIDR del bloque (debe ser >= cidrBase y <= BITS).
+     * @param red Recibe la dirección de red del bloque asignado.
+     * @return Verdadero si había un bloque libre alineado del tamaño pedido.
+     */
+    bool asignar(int cidr, Direccion& red);
+
+    /**
+     * @brief Asigna de una vez varios bloques consecutivos del prefijo indicado.
+     * Equivale a llamar a asignar() hasta 'cantidad' veces mientras el bloque libre más ajustado alcance,
+     * pero divide ese bloque una sola vez en lugar de una por solicitud.
+     * @param cidr Prefijo CIDR de los bloques (debe ser >= cidrBase y <= BITS).
+     * @param cantidad Número máximo de bloques.
+     * @param primera Recibe la dirección de red del primer bloque; los demás le siguen sin huecos.
+     * @return Bloques asignados (0 si no había ningún bloque libre alineado del tamaño pedido).
+     */
+    size_t asignarConsecutivos(int cidr, size_t cantidad, Direccion& primera);
+
+    /**
+     * @brief Asigna un bloque concreto, si está libre por completo (por ejemplo, para conservar
+     * la dirección de una subred al cambiar su tamaño).
+     * @param red Dirección de red del bloque (alineada a su prefijo).
+     * @param cidr Prefijo CIDR del bloque (debe ser >= cidrBase y <= BITS).
+     * @return Verdadero si el bloque estaba libre y quedó asignado.
+     */
+    bool asignarEn(Direccion red, int cidr);
+
+    /**
+     * @brief Devuelve un bloque asignado al espacio libre, fusionándolo con sus compañeros libres.
+     * @param red Dirección de red del bloque.
+     * @param cidr Prefijo CIDR del bloque.
+     */
+    void liberar(Direccion red, int cidr);
+
+    /** @brief Total de direcciones libres. */
+    Cantidad direccionesLibres() const { return libresTotales; }
+
+    /**
+     * @brief Prefijo del mayor bloque libre.
+     * @return El prefijo CIDR, o -1 si no queda espacio libre.
+     */
+    int mayorBloqueLibre() const;
+
+    /**
+     * @brief Obtiene el espacio libre como rangos contiguos ordenados por dirección.
+     * @param rangos Recibe los rangos (se vacía antes de llenarse).
+     */
+    void rangosLibres(std::vector<Rango<Direccion>>& rangos) const;
+
+private:
+    static constexpr int PALABRAS_NIVELES = (BITS + 1 + 63) / 64;
+
+    int nivelMasAjustado(int cidr) const;
+    void insertarLibre(Direccion red, int cidr);
+    void marcarNivel(int cidr) { nivelesConLibres[cidr / 64] |= uint64_t(1) << (cidr % 64); }
+    void desmarcarNivel(int cidr) { nivelesConLibres[cidr / 64] &= ~(uint64_t(1) << (cidr % 64)); }
+
+    std::array<std::set<Direccion>, BITS + 1> libres;             // Listas libres indexadas por prefijo CIDR
+    std::array<uint64_t, PALABRAS_NIVELES> nivelesConLibres = {}; // Bit i activo si libres[i] no está vacía
+    Cantidad libresTotales = 0;
+    int cidrBase = 0;
+};
+
+using AsignadorBloques = AsignadorBloquesGenerico<uint32_t>;
+using AsignadorBloquesIPv6 = AsignadorBloquesGenerico<uint128_t>;
+
+extern template class AsignadorBloquesGenerico<uint32_t>;
+extern template class AsignadorBloquesGenerico<uint128_t>;
+extern template void rangoABloques<uint32_t>(Rango<uint32_t>, std::vector<Bloque<uint32_t>>&);
+extern template void rangoABloques<uint128_t>(Rango<uint128_t>, std::vector<Bloque<uint128_t>>&);
+
+#endif // ASIGNADOR_H
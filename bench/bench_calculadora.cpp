@@ -0,0 +1,302 @@
+// Benchmarks de la calculadora: micro-benchmarks de cada función auxiliar y macro-benchmarks de
+// planes de 10, 10k y 1M solicitudes, renderizados como tabla de consola y como CSV.
+// No usa red ni archivos: la salida renderizada se descarta en un flujo que solo cuenta bytes.
+// Los resultados se escriben en JSON para poder compararlos entre versiones.
+//
+// Uso: bench_calculadora [--rapido] [--filtro TEXTO] [--repeticiones N] [--salida RUTA]
+//   --rapido          Omite los casos de 1M solicitudes
+//   --filtro TEXTO    Ejecuta solo los casos cuyo nombre contiene TEXTO
+//   --repeticiones N  Repeticiones de cada caso (se informa la mediana y el mínimo; por defecto 5)
+//   --salida RUTA     Escribe el JSON en RUTA en lugar de la salida estándar
+
+#include <algorithm>  // Para std::sort, std::min y std::max
+#include <chrono>     // Para medir tiempos con steady_clock
+#include <cstdint>    // Para uint64_t y otros tipos enteros de ancho fijo
+#include <fstream>    // Para std::ofstream (--salida)
+#include <functional> // Para std::function (cuerpo de cada caso)
+#include <iostream>   // Para std::cout y std::cerr
+#include <random>     // Para std::mt19937 (entradas reproducibles)
+#include <streambuf>  // Para std::streambuf (flujo que solo cuenta bytes)
+#include <string>     // Para std::string
+#include <vector>     // Para std::vector
+
+#include "direcciones.h" // Análisis y formato de direcciones IPv4
+#include "subredes.h"    // Planificación e impresión de subredes
+
+using namespace std;
+
+// Acumulador global para que el compilador no elimine el trabajo medido
+static volatile uint64_t sumidero = 0;
+
+// Búfer de flujo que descarta lo escrito y solo cuenta los bytes
+class ContadorBytes : public streambuf {
+public:
+    uint64_t bytes = 0;
+
+protected:
+    int_type overflow(int_type c) override {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            ++bytes;
+        }
+        return traits_type::not_eof(c);
+    }
+    streamsize xsputn(const char*, streamsize n) override {
+        bytes += static_cast<uint64_t>(n);
+        return n;
+    }
+};
+
+struct Resultado {
+    string nombre;
+    string tipo;           // "micro" o "macro"
+    uint64_t operaciones;  // Operaciones por repetición (direcciones, solicitudes...)
+    vector<double> nsPorOperacion;
+    uint64_t bytesSalida;  // Bytes renderizados por repetición (0 si no aplica)
+};
+
+struct Opciones {
+    bool rapido = false;
+    string filtro;
+    int repeticiones = 5;
+    string rutaSalida;
+};
+
+static vector<Resultado> resultados;
+static Opciones opciones;
+
+/**
+ * @brief Mide un caso: `preparar` se ejecuta antes de cada repetición sin medirse y `medir`
+ * devuelve los bytes de salida generados (0 si no aplica).
+ */
+static void ejecutarCaso(const string& nombre, const string& tipo, uint64_t operaciones, int repeticiones,
+                         const function<void()>& preparar, const function<uint64_t()>& medir) {
+    if (!opciones.filtro.empty() && nombre.find(opciones.filtro) == string::npos) {
+        return;
+    }
+    Resultado r{nombre, tipo, operaciones, {}, 0};
+    for (int i = 0; i < repeticiones; ++i) {
+        preparar();
+        auto inicio = chrono::steady_clock::now();
+        r.bytesSalida = medir();
+        auto fin = chrono::steady_clock::now();
+        r.nsPorOperacion.push_back(chrono::duration<double, nano>(fin - inicio).count() /
+                                   static_cast<double>(operaciones));
+    }
+    cerr << nombre << ": " << *min_element(r.nsPorOperacion.begin(), r.nsPorOperacion.end()) << " ns/op\n";
+    resultados.push_back(move(r));
+}
+
+static void microBenchmarks() {
+    const size_t N = 1000000;
+    mt19937 rng(12345);
+
+    vector<uint32_t> ips(N);
+    vector<string> textos(N);
+    string bufferLote;
+    for (size_t i = 0; i < N; ++i) {
+        ips[i] = rng();
+        textos[i] = intToIp(ips[i]);
+        bufferLote += textos[i];
+        bufferLote += '\n';
+    }
+    vector<int> hosts(N);
+    vector<uint32_t> mascaras(N);
+    vector<int> cidrs(N);
+    vector<string> mascarasTexto(N);
+    for (size_t i = 0; i < N; ++i) {
+        hosts[i] = static_cast<int>(rng() % 5000000) + 1;
+        cidrs[i] = static_cast<int>(rng() % 33);
+        mascaras[i] = cidrs[i] == 0 ? 0 : 0xFFFFFFFFu << (32 - cidrs[i]);
+        mascarasTexto[i] = cidrToMask(cidrs[i]);
+    }
+    const int reps = opciones.repeticiones;
+    auto nada = [] {};
+
+    ejecutarCaso("ipToInt", "micro", N, reps, nada, [&] {
+        uint64_t s = 0;
+        for (const string& t : textos) s += ipToInt(t);
+        sumidero += s;
+        return uint64_t{0};
+    });
+    ejecutarCaso("parseIPv4", "micro", N, reps, nada, [&] {
+        uint64_t s = 0;
+        for (const string& t : textos) {
+            uint32_t ip = 0;
+            parseIPv4(t, ip);
+            s += ip;
+        }
+        sumidero += s;
+        return uint64_t{0};
+    });
+    vector<uint32_t> salidaLote;
+    salidaLote.reserve(N);
+    ejecutarCaso("parseIPv4Lote", "micro", N, reps, [&] { salidaLote.clear(); }, [&] {
+        parseIPv4Lote(bufferLote, salidaLote);
+        sumidero += salidaLote.size();
+        return uint64_t{0};
+    });
+    ejecutarCaso("intToIp", "micro", N, reps, nada, [&] {
+        uint64_t s = 0;
+        for (uint32_t ip : ips) s += intToIp(ip).size();
+        sumidero += s;
+        return uint64_t{0};
+    });
+    ejecutarCaso("formatearIPv4", "micro", N, reps, nada, [&] {
+        char buffer[16];
+        uint64_t s = 0;
+        for (uint32_t ip : ips) s += static_cast<uint64_t>(formatearIPv4(buffer, ip) - buffer);
+        sumidero += s;
+        return uint64_t{0};
+    });
+    vector<char> bufferConsecutivas(static_cast<size_t>(N) * 16);
+    ejecutarCaso("formatearIPv4Consecutivas", "micro", N, reps, nada, [&] {
+        const char* fin = formatearIPv4Consecutivas(bufferConsecutivas.data(), 0x0A000001u, static_cast<uint32_t>(N));
+        sumidero += static_cast<uint64_t>(fin - bufferConsecutivas.data());
+        return static_cast<uint64_t>(fin - bufferConsecutivas.data());
+    });
+    ejecutarCaso("uint32_tToBinaryString", "micro", N, reps, nada, [&] {
+        uint64_t s = 0;
+        for (uint32_t ip : ips) s += uint32_tToBinaryString(ip).size();
+        sumidero += s;
+        return uint64_t{0};
+    });
+    ejecutarCaso("hostsToCidr", "micro", N, reps, nada, [&] {
+        uint64_t s = 0;
+        for (int h : hosts) s += static_cast<uint64_t>(hostsToCidr(h));
+        sumidero += s;
+        return uint64_t{0};
+    });
+    ejecutarCaso("maskToCidr", "micro", N, reps, nada, [&] {
+        uint64_t s = 0;
+        for (const string& m : mascarasTexto) s += static_cast<uint64_t>(maskToCidr(m));
+        sumidero += s;
+        return uint64_t{0};
+    });
+    ejecutarCaso("maskIntToCidr", "micro", N, reps, nada, [&] {
+        uint64_t s = 0;
+        for (uint32_t m : mascaras) s += static_cast<uint64_t>(maskIntToCidr(m));
+        sumidero += s;
+        return uint64_t{0};
+    });
+    ejecutarCaso("cidrToMask", "micro", N, reps, nada, [&] {
+        uint64_t s = 0;
+        for (int c : cidrs) s += cidrToMask(c).size();
+        sumidero += s;
+        return uint64_t{0};
+    });
+}
+
+static void macroBenchmarks() {
+    // Red /8 con solicitudes de 1 a 10 hosts: hasta 1M solicitudes caben en el espacio disponible
+    const string ipBase = "10.0.0.0";
+    const int cidrBase = 8;
+    vector<size_t> tamanos = {10, 10000};
+    if (!opciones.rapido) {
+        tamanos.push_back(1000000);
+    }
+
+    for (size_t n : tamanos) {
+        mt19937 rng(static_cast<uint32_t>(n));
+        vector<int> hosts(n);
+        for (int& h : hosts) h = static_cast<int>(rng() % 10) + 1;
+
+        // Pocas repeticiones para los planes grandes; muchas para los pequeños (menos ruido)
+        const int reps = n >= 1000000 ? min(opciones.repeticiones, 3) : opciones.repeticiones;
+        const uint64_t vueltas = n <= 10 ? 10000 : 1; // Repite los planes diminutos para medir algo
+        const string sufijo = "/" + to_string(n);
+        auto nada = [] {};
+
+        PlanSubredes plan;
+        ejecutarCaso("planificarSubredes" + sufijo, "macro", n * vueltas, reps, nada, [&] {
+            for (uint64_t v = 0; v < vueltas; ++v) {
+                planificarSubredes(plan, ipBase, cidrBase, hosts);
+            }
+            sumidero += plan.subredes.size();
+            return uint64_t{0};
+        });
+
+        for (bool csv : {false, true}) {
+            const string formato = csv ? "csv" : "consola";
+            ejecutarCaso("imprimirPlan/" + formato + sufijo, "macro", n * vueltas, reps, nada, [&] {
+                ContadorBytes contador;
+                ostream os(&contador);
+                for (uint64_t v = 0; v < vueltas; ++v) {
+                    imprimirPlan(os, plan, csv);
+                }
+                return contador.bytes / vueltas;
+            });
+            ejecutarCaso("calcularSubredes/" + formato + sufijo, "macro", n * vueltas, reps, nada, [&] {
+                ContadorBytes contador;
+                ostream os(&contador);
+                for (uint64_t v = 0; v < vueltas; ++v) {
+                    calcularSubredes(os, ipBase, cidrBase, hosts, csv);
+                }
+                return contador.bytes / vueltas;
+            });
+        }
+    }
+}
+
+static string nombreCompilador() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + to_string(_MSC_VER);
+#else
+    return "desconocido";
+#endif
+}
+
+static void escribirJSON(ostream& os) {
+    os << "{\n  \"formato\": 1,\n  \"compilador\": \"" << nombreCompilador()
+       << "\",\n  \"repeticiones\": " << opciones.repeticiones << ",\n  \"resultados\": [";
+    for (size_t i = 0; i < resultados.size(); ++i) {
+        const Resultado& r = resultados[i];
+        vector<double> ordenados = r.nsPorOperacion;
+        sort(ordenados.begin(), ordenados.end());
+        double mediana = ordenados[ordenados.size() / 2];
+        if (ordenados.size() % 2 == 0) {
+            mediana = (ordenados[ordenados.size() / 2 - 1] + mediana) / 2;
+        }
+        os << (i ? ",\n" : "\n") << "    {\"nombre\": \"" << r.nombre << "\", \"tipo\": \"" << r.tipo
+           << "\", \"operaciones\": " << r.operaciones << ", \"ns_por_op_mediana\": " << mediana
+           << ", \"ns_por_op_min\": " << ordenados.front() << ", \"ns_por_op_max\": " << ordenados.back()
+           << ", \"bytes_salida\": " << r.bytesSalida << "}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--rapido") {
+            opciones.rapido = true;
+        } else if (arg == "--filtro" && i + 1 < argc) {
+            opciones.filtro = argv[++i];
+        } else if (arg == "--repeticiones" && i + 1 < argc) {
+            opciones.repeticiones = max(1, atoi(argv[++i]));
+        } else if (arg == "--salida" && i + 1 < argc) {
+            opciones.rutaSalida = argv[++i];
+        } else {
+            cerr << "Uso: " << argv[0] << " [--rapido] [--filtro TEXTO] [--repeticiones N] [--salida RUTA]\n";
+            return 2;
+        }
+    }
+
+    microBenchmarks();
+    macroBenchmarks();
+
+    if (opciones.rutaSalida.empty()) {
+        escribirJSON(cout);
+    } else {
+        ofstream archivo(opciones.rutaSalida);
+        if (!archivo) {
+            cerr << "Error: No se pudo abrir '" << opciones.rutaSalida << "'.\n";
+            return 1;
+        }
+        escribirJSON(archivo);
+    }
+    return 0;
+}
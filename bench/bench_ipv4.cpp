@@ -0,0 +1,94 @@
+// Comparativa del analizador de direcciones IPv4: implementación anterior
+// (split + istringstream + stoi) frente a parseIPv4() y parseIPv4Lote().
+//
+// Compilación: cmake -S . -B build && cmake --build build --target bench_ipv4
+
+#include <chrono>   // Para medir tiempos con steady_clock
+#include <cstdint>  // Para uint32_t y otros tipos enteros de ancho fijo
+#include <iostream> // Para std::cout
+#include <random>   // Para std::mt19937 (direcciones reproducibles)
+#include <sstream>  // Para std::istringstream (implementación anterior)
+#include <string>   // Para std::string
+#include <vector>   // Para std::vector
+
+#include "direcciones.h" // parseIPv4 y parseIPv4Lote
+
+using namespace std;
+
+// Implementación original de ipToInt, conservada únicamente como referencia.
+static vector<string> splitAnterior(const string& s, char delim) {
+    vector<string> tokens;
+    string token;
+    istringstream tokenStream(s);
+    while (getline(tokenStream, token, delim)) {
+        tokens.push_back(token);
+    }
+    return tokens;
+}
+
+static uint32_t ipToIntAnterior(const string& ip) {
+    vector<string> octetos = splitAnterior(ip, '.');
+    if (octetos.size() != 4) {
+        return 0;
+    }
+    uint32_t result = 0;
+    for (int i = 0; i < 4; ++i) {
+        try {
+            int octet_val = stoi(octetos[i]);
+            if (octet_val < 0 || octet_val > 255) {
+                return 0;
+            }
+            result |= static_cast<uint32_t>(octet_val) << (24 - 8 * i);
+        } catch (const exception&) {
+            return 0;
+        }
+    }
+    return result;
+}
+
+template <typename F>
+static double medirNs(size_t n, F&& f) {
+    auto inicio = chrono::steady_clock::now();
+    f();
+    auto fin = chrono::steady_clock::now();
+    return chrono::duration<double, nano>(fin - inicio).count() / static_cast<double>(n);
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = (argc > 1) ? stoul(argv[1]) : 2000000;
+
+    mt19937 rng(12345);
+    vector<string> direcciones;
+    direcciones.reserve(n);
+    string buffer;
+    for (size_t i = 0; i < n; ++i) {
+        direcciones.push_back(intToIp(rng()));
+        buffer += direcciones.back();
+        buffer += '\n';
+    }
+
+    uint64_t control = 0;
+    double anterior = medirNs(n, [&] {
+        for (const string& d : direcciones) control += ipToIntAnterior(d);
+    });
+    double actual = medirNs(n, [&] {
+        for (const string& d : direcciones) {
+            uint32_t ip = 0;
+            parseIPv4(d, ip);
+            control += ip;
+        }
+    });
+    vector<uint32_t> salida;
+    salida.reserve(n);
+    double lote = medirNs(n, [&] {
+        parseIPv4Lote(buffer, salida);
+    });
+    for (uint32_t ip : salida) control -= 2 * static_cast<uint64_t>(ip);
+
+    cout << "direcciones: " << n << "\n"
+         << "ipToInt anterior (split/stoi): " << anterior << " ns/dir\n"
+         << "parseIPv4:                     " << actual << " ns/dir (" << anterior / actual << "x)\n"
+         << "parseIPv4Lote:                 " << lote << " ns/dir (" << anterior / lote << "x)\n"
+         << "control: " << control << "\n";
+    return control == 0 ? 0 : 1;
+}
@@ -0,0 +1,236 @@
+// Generador de carga para el modo servidor: abre varios clientes concurrentes, cada uno envía
+// peticiones de una en una (espera la respuesta antes de enviar la siguiente) y mide la latencia
+// de ida y vuelta de cada petición. El resultado es un JSON con el ritmo total y los percentiles.
+//
+// Uso: carga_servidor SOCKET|PUERTO [--clientes C] [--peticiones N] [--calentamiento N]
+//                     [--peticion TEXTO] [--limite-p99 US] [--salida RUTA]
+//   --clientes C       Conexiones concurrentes (por defecto 1)
+//   --peticiones N     Peticiones medidas por cliente (por defecto 100000)
+//   --calentamiento N  Peticiones previas sin medir por cliente (por defecto 1000)
+//   --peticion TEXTO   Petición a enviar (por defecto "plan 10.0.0.0/16 500 200 50 10")
+//   --limite-p99 US    Termina con código 1 si el p99 supera US microsegundos
+//   --salida RUTA      Escribe el JSON en RUTA en lugar de la salida estándar
+
+#include <algorithm> // Para std::sort, std::min y std::max
+#include <chrono>    // Para medir latencias con steady_clock
+#include <cstdint>   // Para uint64_t y otros tipos enteros de ancho fijo
+#include <cstdlib>   // Para atoi y strtoull
+#include <cstring>   // Para strncpy (ruta del socket Unix)
+#include <fstream>   // Para std::ofstream (--salida)
+#include <iostream>  // Para std::cout y std::cerr
+#include <string>    // Para std::string
+#include <thread>    // Para std::thread (un hilo por cliente)
+#include <vector>    // Para std::vector
+
+#include <netinet/in.h>  // Para sockaddr_in, htons y htonl
+#include <netinet/tcp.h> // Para TCP_NODELAY
+#include <sys/socket.h>  // Para socket, connect, send y recv
+#include <sys/un.h>      // Para sockaddr_un
+#include <unistd.h>      // Para close
+
+using namespace std;
+
+struct Opciones {
+    string direccion;
+    int clientes = 1;
+    long peticiones = 100000;
+    long calentamiento = 1000;
+    string peticion = "plan 10.0.0.0/16 500 200 50 10";
+    double limiteP99 = 0; // En microsegundos; 0 = sin límite
+    string rutaSalida;
+};
+
+static Opciones opciones;
+
+// Resultado de un cliente
+struct ResultadoCliente {
+    vector<uint32_t> latenciasNs;
+    long errores = 0;        // Respuestas "ERROR"
+    bool conexionFallida = false;
+};
+
+static int conectar(const string& direccion) {
+    if (!direccion.empty() && direccion.find_first_not_of("0123456789") == string::npos) {
+        int s = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in destino{};
+        destino.sin_family = AF_INET;
+        destino.sin_port = htons(static_cast<uint16_t>(atoi(direccion.c_str())));
+        destino.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (s >= 0 && connect(s, reinterpret_cast<sockaddr*>(&destino), sizeof(destino)) == 0) {
+            int si = 1;
+            setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &si, sizeof(si));
+            return s;
+        }
+        if (s >= 0) {
+            close(s);
+        }
+        return -1;
+    }
+    int s = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un destino{};
+    destino.sun_family = AF_UNIX;
+    strncpy(destino.sun_path, direccion.c_str(), sizeof(destino.sun_path) - 1);
+    if (s >= 0 && connect(s, reinterpret_cast<sockaddr*>(&destino), sizeof(destino)) == 0) {
+        return s;
+    }
+    if (s >= 0) {
+        close(s);
+    }
+    return -1;
+}
+
+// Lee una respuesta completa ("OK <bytes>\n" y los datos, o "ERROR ...\n").
+// 'pendiente' guarda lo recibido de más (no debería haberlo: hay una sola petición en vuelo).
+// Devuelve 1 si fue OK, 0 si fue ERROR y -1 si la conexión falló.
+static int leerRespuesta(int s, string& pendiente) {
+    char buffer[1 << 16];
+    size_t salto;
+    while ((salto = pendiente.find('\n')) == string::npos) {
+        ssize_t n = recv(s, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            return -1;
+        }
+        pendiente.append(buffer, static_cast<size_t>(n));
+    }
+    if (pendiente.compare(0, 3, "OK ") != 0) {
+        pendiente.erase(0, salto + 1);
+        return 0;
+    }
+    const size_t longitud = strtoull(pendiente.c_str() + 3, nullptr, 10);
+    const size_t total = salto + 1 + longitud;
+    while (pendiente.size() < total) {
+        ssize_t n = recv(s, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            return -1;
+        }
+        pendiente.append(buffer, static_cast<size_t>(n));
+    }
+    pendiente.erase(0, total);
+    return 1;
+}
+
+static void ejecutarCliente(ResultadoCliente& resultado) {
+    int s = conectar(opciones.direccion);
+    if (s < 0) {
+        resultado.conexionFallida = true;
+        return;
+    }
+    const string linea = opciones.peticion + "\n";
+    string pendiente;
+    resultado.latenciasNs.reserve(static_cast<size_t>(opciones.peticiones));
+    for (long i = 0; i < opciones.calentamiento + opciones.peticiones; ++i) {
+        auto inicio = chrono::steady_clock::now();
+        if (send(s, linea.data(), linea.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(linea.size())) {
+            resultado.conexionFallida = true;
+            break;
+        }
+        int r = leerRespuesta(s, pendiente);
+        auto fin = chrono::steady_clock::now();
+        if (r < 0) {
+            resultado.conexionFallida = true;
+            break;
+        }
+        if (i < opciones.calentamiento) {
+            continue;
+        }
+        if (r == 0) {
+            ++resultado.errores;
+        }
+        resultado.latenciasNs.push_back(static_cast<uint32_t>(min<int64_t>(
+            chrono::duration_cast<chrono::nanoseconds>(fin - inicio).count(), UINT32_MAX)));
+    }
+    close(s);
+}
+
+static string escaparJSON(const string& texto) {
+    string r;
+    for (char c : texto) {
+        if (c == '"' || c == '\\') {
+            r += '\\';
+        }
+        r += c;
+    }
+    return r;
+}
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--clientes" && i + 1 < argc) {
+            opciones.clientes = max(1, atoi(argv[++i]));
+        } else if (arg == "--peticiones" && i + 1 < argc) {
+            opciones.peticiones = max(1L, atol(argv[++i]));
+        } else if (arg == "--calentamiento" && i + 1 < argc) {
+            opciones.calentamiento = max(0L, atol(argv[++i]));
+        } else if (arg == "--peticion" && i + 1 < argc) {
+            opciones.peticion = argv[++i];
+        } else if (arg == "--limite-p99" && i + 1 < argc) {
+            opciones.limiteP99 = atof(argv[++i]);
+        } else if (arg == "--salida" && i + 1 < argc) {
+            opciones.rutaSalida = argv[++i];
+        } else if (opciones.direccion.empty() && arg[0] != '-') {
+            opciones.direccion = arg;
+        } else {
+            opciones.direccion.clear();
+            break;
+        }
+    }
+    if (opciones.direccion.empty()) {
+        cerr << "Uso: " << argv[0] << " SOCKET|PUERTO [--clientes C] [--peticiones N] [--calentamiento N]"
+             << " [--peticion TEXTO] [--limite-p99 US] [--salida RUTA]\n";
+        return 2;
+    }
+
+    vector<ResultadoCliente> resultados(static_cast<size_t>(opciones.clientes));
+    vector<thread> clientes;
+    auto inicio = chrono::steady_clock::now();
+    for (ResultadoCliente& r : resultados) {
+        clientes.emplace_back(ejecutarCliente, ref(r));
+    }
+    for (thread& t : clientes) {
+        t.join();
+    }
+    const double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+    vector<uint32_t> latencias;
+    long errores = 0;
+    for (const ResultadoCliente& r : resultados) {
+        if (r.conexionFallida) {
+            cerr << "Error: Falló la conexión con '" << opciones.direccion << "'.\n";
+            return 1;
+        }
+        latencias.insert(latencias.end(), r.latenciasNs.begin(), r.latenciasNs.end());
+        errores += r.errores;
+    }
+    sort(latencias.begin(), latencias.end());
+    auto percentil = [&](double p) {
+        return latencias[min(latencias.size() - 1, static_cast<size_t>(p * static_cast<double>(latencias.size())))];
+    };
+    // El ritmo incluye el calentamiento, que también se envió durante el intervalo medido
+    const double total = static_cast<double>(opciones.clientes) * static_cast<double>(opciones.calentamiento + opciones.peticiones);
+
+    ofstream archivo;
+    if (!opciones.rutaSalida.empty()) {
+        archivo.open(opciones.rutaSalida);
+        if (!archivo) {
+            cerr << "Error: No se pudo abrir '" << opciones.rutaSalida << "'.\n";
+            return 1;
+        }
+    }
+    ostream& os = opciones.rutaSalida.empty() ? cout : archivo;
+    os << "{\n"
+       << "  \"peticion\": \"" << escaparJSON(opciones.peticion) << "\",\n"
+       << "  \"clientes\": " << opciones.clientes << ",\n"
+       << "  \"peticiones\": " << latencias.size() << ",\n"
+       << "  \"errores\": " << errores << ",\n"
+       << "  \"peticiones_por_segundo\": " << total / segundos << ",\n"
+       << "  \"latencia_ns\": {\"p50\": " << percentil(0.50) << ", \"p90\": " << percentil(0.90)
+       << ", \"p99\": " << percentil(0.99) << ", \"p999\": " << percentil(0.999) << ", \"max\": " << latencias.back() << "}\n"
+       << "}\n";
+
+    if (opciones.limiteP99 > 0 && percentil(0.99) > opciones.limiteP99 * 1000) {
+        cerr << "p99 de " << percentil(0.99) / 1000.0 << " us, por encima del límite de " << opciones.limiteP99 << " us\n";
+        return 1;
+    }
+    return 0;
+}
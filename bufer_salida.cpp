@@ -0,0 +1,48 @@
+#include "bufer_salida.h"
+
+#include "direcciones.h" // Para formatearIPv4
+
+using namespace std;
+
+/**
+ * @brief Pares de dígitos "00".."99" para formatear enteros de dos en dos.
+ */
+static const char PARES_DIGITOS[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+char* BuferSalida::formatearEntero(char* destino, uint64_t valor) {
+    char temporal[20];
+    char* p = temporal + sizeof(temporal);
+    while (valor >= 100) {
+        const unsigned par = static_cast<unsigned>(valor % 100) * 2;
+        valor /= 100;
+        *--p = PARES_DIGITOS[par + 1];
+        *--p = PARES_DIGITOS[par];
+    }
+    if (valor >= 10) {
+        const unsigned par = static_cast<unsigned>(valor) * 2;
+        *--p = PARES_DIGITOS[par + 1];
+        *--p = PARES_DIGITOS[par];
+    } else {
+        *--p = static_cast<char>('0' + valor);
+    }
+    const size_t longitud = static_cast<size_t>(temporal + sizeof(temporal) - p);
+    memcpy(destino, p, longitud);
+    return destino + longitud;
+}
+
+void BuferSalida::enteroConSigno(long long valor) {
+    char* p = reservar(21);
+    if (valor < 0) {
+        *p++ = '-';
+        avanzar(formatearEntero(p, 0 - static_cast<uint64_t>(valor)));
+    } else {
+        avanzar(formatearEntero(p, static_cast<uint64_t>(valor)));
+    }
+}
+
+void BuferSalida::ipv4(uint32_t ip) {
+    avanzar(formatearIPv4(reservar(16), ip));
+}
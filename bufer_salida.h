@@ -0,0 +1,124 @@
+#ifndef BUFER_SALIDA_H
+#define BUFER_SALIDA_H
+
+#include <cstddef>     // Para size_t
+#include <cstdint>     // Para uint32_t, uint64_t
+#include <cstring>     // Para memcpy, memset
+#include <memory>      // Para std::unique_ptr
+#include <ostream>     // Para std::ostream
+#include <string_view> // Para std::string_view
+#include <utility>     // Para std::move
+
+#include "instrumentacion.h" // Fase de escritura y bytes escritos
+
+/**
+ * @brief Búfer de salida que formatea directamente en memoria y escribe en el flujo por bloques.
+ *
+ * Sustituye a los operadores << con setw/endl en las rutas de impresión masiva: cada campo se copia
+ * o se formatea en el búfer, sin pasar por el formateo de iostream, y el flujo solo recibe una
+ * escritura cada CAPACIDAD bytes (y al vaciar). El ancho de las columnas se cuenta en bytes, igual
+ * que std::setw con cadenas (una "á" en UTF-8 ocupa dos).
+ */
+class BuferSalida {
+public:
+    static constexpr size_t CAPACIDAD = 1 << 16;
+
+    /**
+     * @brief Crea el búfer.
+     * @param os Flujo de destino. Debe seguir existiendo mientras se use el búfer.
+     */
+    explicit BuferSalida(std::ostream& os) : datos(new char[CAPACIDAD]), os(&os) {}
+    ~BuferSalida() { vaciar(); }
+    BuferSalida(BuferSalida&& otro) noexcept : datos(std::move(otro.datos)), usados(otro.usados), os(otro.os) {
+        otro.usados = 0;
+    }
+    BuferSalida(const BuferSalida&) = delete;
+    BuferSalida& operator=(const BuferSalida&) = delete;
+
+    /**
+     * @brief Garantiza espacio libre contiguo y devuelve dónde escribir.
+     * @param n Bytes que se van a escribir (como mucho CAPACIDAD).
+     * @return Puntero de escritura; hay que confirmar lo escrito con avanzar().
+     */
+    char* reservar(size_t n) {
+        if (usados + n > CAPACIDAD) {
+            vaciar();
+        }
+        return datos.get() + usados;
+    }
+
+    /**
+     * @brief Confirma los bytes escritos tras reservar().
+     * @param fin Puntero al carácter siguiente al último escrito.
+     */
+    void avanzar(const char* fin) { usados = static_cast<size_t>(fin - datos.get()); }
+
+    /** @brief Añade texto tal cual. */
+    void texto(std::string_view s) {
+        if (s.size() > CAPACIDAD - usados) {
+            vaciar();
+            if (s.size() > CAPACIDAD) {
+                MEDIR_FASE(Escritura);
+                CONTAR(BytesEscritos, s.size());
+                os->write(s.data(), static_cast<std::streamsize>(s.size()));
+                return;
+            }
+        }
+        memcpy(datos.get() + usados, s.data(), s.size());
+        usados += s.size();
+    }
+
+    /** @brief Añade un carácter. */
+    void caracter(char c) { *reservar(1) = c; ++usados; }
+
+    /** @brief Añade un entero sin signo en decimal. */
+    void entero(uint64_t valor) { avanzar(formatearEntero(reservar(20), valor)); }
+
+    /** @brief Añade un entero con signo en decimal. */
+    void enteroConSigno(long long valor);
+
+    /** @brief Añade una dirección IPv4 en formato dotted decimal. */
+    void ipv4(uint32_t ip);
+
+    /**
+     * @brief Añade texto alineado a la izquierda en una columna (como std::left << std::setw(ancho)).
+     * Si el texto es más largo que la columna, se escribe completo.
+     */
+    void columna(std::string_view s, size_t ancho) {
+        texto(s);
+        if (s.size() < ancho) {
+            espacios(ancho - s.size());
+        }
+    }
+
+    /** @brief Añade n espacios (como mucho CAPACIDAD). */
+    void espacios(size_t n) {
+        memset(reservar(n), ' ', n);
+        usados += n;
+    }
+
+    /** @brief Escribe en el flujo todo lo pendiente. */
+    void vaciar() {
+        if (usados > 0) {
+            MEDIR_FASE(Escritura);
+            CONTAR(BytesEscritos, usados);
+            os->write(datos.get(), static_cast<std::streamsize>(usados));
+            usados = 0;
+        }
+    }
+
+    /**
+     * @brief Escribe un entero sin signo en decimal en un buffer, sin reservar memoria.
+     * @param destino Buffer con espacio para al menos 20 bytes.
+     * @param valor El entero.
+     * @return Puntero al carácter siguiente al último escrito.
+     */
+    static char* formatearEntero(char* destino, uint64_t valor);
+
+private:
+    std::unique_ptr<char[]> datos; // Sin inicializar: crear un búfer es barato
+    size_t usados = 0;
+    std::ostream* os;
+};
+
+#endif // BUFER_SALIDA_H
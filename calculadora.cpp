@@ -1,463 +1,1952 @@
 #include <iostream>  // Para entrada/salida de consola (cout, cin)
 #include <vector>    // Para usar std::vector
 #include <string>    // Para usar std::string
-#include <cmath>     // Para usar log2 y pow
-#include <sstream>   // Para usar std::istringstream para dividir cadenas
 #include <limits>    // Para numeric_limits, útil en la validación de entrada
 #include <cstdint>   // NECESARIO para uint32_t y otros tipos enteros de ancho fijo
-#include <algorithm> // Para std::sort y std::transform
-#include <iomanip>   // Para std::setw, std::left, std::right para formato de salida
+#include <algorithm> // Para std::transform
 #include <fstream>   // Para std::ofstream para escribir en archivos
+#include <cstring>   // Para memchr
+#include <string_view> // Para std::string_view
+#include <chrono>    // Para medir tiempos de construcción y búsqueda
+#include <cstdio>    // Para fread/fwrite en la lectura masiva de direcciones
+#include <sstream>   // Para std::ostringstream (salida de cada hilo en el modo por lotes)
+#include <memory>    // Para std::unique_ptr (estado del modo servidor)
+#include <cstdlib>   // Para atexit (informe de --stats)
+
+#include "direcciones.h" // Análisis y formato de direcciones IPv4 y máscaras
+#include "calculo_subred.h" // Aritmética de subredes con enteros
+#include "subredes.h"    // Planificación e impresión de subredes
+#include "ipam.h"        // Almacén IPAM persistente
+#include "lpm.h"         // Búsqueda por prefijo más largo
+#include "pool_trabajo.h" // Pool de hilos con robo de trabajo
+#include "plan_binario.h" // Exportación binaria de planes
+#include "ipv6.h"        // Planificación de subredes IPv6
+#include "replanificacion.h" // Replanificación incremental
+#include "resumen.h"     // Resumen (agregación) de prefijos
+#include "conflictos.h"  // Detección de solapamientos con un inventario
+#include "bufer_salida.h" // Escritura de la salida por bloques
+#include "servidor.h"    // Servidor de peticiones por socket
+#include "instrumentacion.h" // Tiempos por fase y contadores (--stats)
+#include "utilizacion.h"  // Análisis de utilización con un mapa de bits
 
 // Usar el espacio de nombres estándar para simplificar el código.
 // En proyectos más grandes, se prefiere calificar con std::
 using namespace std;
 
-// Forward declaration for intToIp, as it's used by other functions early
-string intToIp(uint32_t ip);
-string uint32_tToBinaryString(uint32_t n);
-
-// Estructura para almacenar los detalles de cada subred.
-struct Subred {
-    string direccionRed;
-    string mascaraDecimal;
-    string mascaraBinaria; // Nueva: para la representación binaria
-    int cidr;
-    string hostRangeStart;
-    string hostRangeEnd;
-    string broadcast;
-    int hostsUtilizables;
-    int requestedHosts; // Para mantener el recuento original de hosts solicitados
-};
+/**
+ * @brief Analiza una especificación de red en formato 'IP/CIDR' o 'IP - Máscara Decimal'.
+ * @param entradaRed La especificación de red (sin espacios al inicio/final).
+ * @param ipBaseStr Recibe la dirección IP base.
+ * @param cidrBase Recibe el prefijo CIDR de la red base.
+ * @param error Recibe el mensaje de error si la especificación no es válida.
+ * @return Verdadero si la especificación es válida.
+ */
+bool analizarRed(const string& entradaRed, string& ipBaseStr, int& cidrBase, string& error) {
+    cidrBase = -1; // Valor predeterminado para CIDR inválido
+
+    // Intentar analizar la entrada como formato IP/CIDR primero
+    size_t slash_pos = entradaRed.find('/');
+    if (slash_pos != string::npos) {
+        ipBaseStr = entradaRed.substr(0, slash_pos);
+        string cidrStr = entradaRed.substr(slash_pos + 1);
+        try {
+            cidrBase = stoi(cidrStr);
+            if (cidrBase < 0 || cidrBase > 32) {
+                error = "Error: El prefijo CIDR debe estar entre 0 y 32.";
+                return false;
+            }
+        } catch (const invalid_argument& e) {
+            error = "Error: El prefijo CIDR no es un número válido.";
+            return false;
+        } catch (const out_of_range& e) {
+            error = "Error: El prefijo CIDR está fuera de rango.";
+            return false;
+        }
+    } else { // Si no es IP/CIDR, intenta el formato IP - Máscara decimal
+        size_t dash_pos = entradaRed.find(" - ");
+        if (dash_pos == string::npos) {
+            error = "Error: Formato de entrada de red inválido. Use 'IP/CIDR' o 'IP - Máscara Decimal'.";
+            return false;
+        }
+        ipBaseStr = entradaRed.substr(0, dash_pos);
+        string maskDecimalStr = entradaRed.substr(dash_pos + 3); // +3 para saltar " - "
+        cidrBase = maskToCidr(maskDecimalStr);
+        if (cidrBase == -1) {
+            error = "Error: La máscara de subred ('" + maskDecimalStr + "') no es válida o no es una máscara binaria continua.";
+            return false;
+        }
+    }
+
+    // Validar el formato de la dirección IP base por sí misma, independientemente del estilo de entrada
+    uint32_t ipBaseNum;
+    ErrorIPv4 errorIp = parseIPv4(ipBaseStr, ipBaseNum);
+    if (errorIp != ErrorIPv4::Ninguno) {
+        error = "Error: La dirección IP de base ('" + ipBaseStr + "') no es válida: " + describirErrorIPv4(errorIp) + ".";
+        return false;
+    }
+    return true;
+}
 
 /**
- * @brief Divide una cadena de texto en un vector de cadenas usando un delimitador.
- * @param s La cadena a dividir.
- * @param delim El carácter delimitador.
- * @return Un vector de cadenas.
+ * @brief Analiza un rango reservado en formato 'IP/CIDR' (ej. 10.0.4.0/22) o 'IP-IP' (ej. 10.0.0.1-10.0.0.20).
+ * @param texto El rango a analizar.
+ * @param rango Recibe el rango.
+ * @param error Recibe el mensaje de error si el rango no es válido.
+ * @return Verdadero si el rango es válido.
  */
-vector<string> split(const string& s, char delim) {
-    vector<string> tokens;
-    string token;
-    istringstream tokenStream(s);
-    while (getline(tokenStream, token, delim)) {
-        tokens.push_back(token);
-    }
-    return tokens;
+bool analizarRango(string_view texto, RangoIPv4& rango, string& error) {
+    ErrorIPv4 errorIp;
+    size_t slash_pos = texto.find('/');
+    if (slash_pos != string_view::npos) {
+        uint32_t red;
+        errorIp = parseIPv4(texto.substr(0, slash_pos), red);
+        string_view cidrStr = texto.substr(slash_pos + 1);
+        int cidr = 0;
+        bool cidrValido = !cidrStr.empty() && cidrStr.size() <= 2;
+        for (char c : cidrStr) {
+            cidrValido = cidrValido && c >= '0' && c <= '9';
+            cidr = cidr * 10 + (c - '0');
+        }
+        if (errorIp == ErrorIPv4::Ninguno && (!cidrValido || cidr > 32)) {
+            error = "Error: El prefijo del rango reservado ('" + string(texto) + "') debe estar entre 0 y 32.";
+            return false;
+        }
+        if (errorIp == ErrorIPv4::Ninguno) {
+            uint32_t mascara = mascaraDePrefijo(PrefijoIPv4(cidr));
+            if ((red & mascara) != red) {
+                error = "Error: El rango reservado '" + string(texto) + "' no es una dirección de red válida para su máscara.";
+                return false;
+            }
+            rango = {red, red | ~mascara};
+            return true;
+        }
+    } else {
+        size_t dash_pos = texto.find('-');
+        if (dash_pos == string_view::npos) {
+            dash_pos = texto.size();
+        }
+        errorIp = parseIPv4(texto.substr(0, dash_pos), rango.inicio);
+        rango.fin = rango.inicio;
+        if (errorIp == ErrorIPv4::Ninguno && dash_pos < texto.size()) {
+            errorIp = parseIPv4(texto.substr(dash_pos + 1), rango.fin);
+        }
+        if (errorIp == ErrorIPv4::Ninguno) {
+            if (rango.fin < rango.inicio) {
+                error = "Error: El rango reservado '" + string(texto) + "' termina antes de empezar.";
+                return false;
+            }
+            return true;
+        }
+    }
+    error = "Error: El rango reservado '" + string(texto) + "' no es válido: " + describirErrorIPv4(errorIp) + ".";
+    return false;
 }
 
 /**
- * @brief Convierte una dirección IP en formato dotted decimal (ej. "192.168.1.1") a un entero sin signo de 32 bits.
- * @param ip La dirección IP en formato de cadena.
- * @return La dirección IP como un entero de 32 bits. Retorna 0 si hay un error de formato (excepto para "0.0.0.0").
+ * @brief Analiza un registro de trabajo del modo por lotes.
+ * Formato: la red ('IP/CIDR' o 'IP - Máscara Decimal') seguida de los números de hosts y,
+ * opcionalmente, de rangos ya ocupados ('IP/CIDR' o 'IP-IP'), separados por espacios, tabuladores
+ * o comas. Ej: "10.0.0.0/16 500 200 50 10.0.0.0/20 10.0.64.1-10.0.64.9".
+ * @param linea La línea a analizar (sin comentarios).
+ * @param ipBaseStr Recibe la dirección IP base.
+ * @param cidrBase Recibe el prefijo CIDR de la red base.
+ * @param requestedHostCounts Recibe los números de hosts (se vacía antes de llenarse).
+ * @param reservados Recibe los rangos reservados (se vacía antes de llenarse).
+ * @param error Recibe el mensaje de error si el registro no es válido.
+ * @return Verdadero si el registro es válido.
  */
-uint32_t ipToInt(const string& ip) {
-    vector<string> octetos = split(ip, '.');
-    if (octetos.size() != 4) {
-        return 0; // Formato inválido (no 4 octetos)
+bool analizarTrabajo(const string& linea, string& ipBaseStr, int& cidrBase, vector<int>& requestedHostCounts,
+                     vector<RangoIPv4>& reservados, string& error) {
+    MEDIR_FASE(Analisis);
+    requestedHostCounts.clear();
+    reservados.clear();
+
+    // Tokeniza in situ, sin crear cadenas intermedias por cada número de hosts
+    const char* p = linea.data();
+    const char* fin = p + linea.size();
+    auto esSeparador = [](char c) { return c == ' ' || c == '\t' || c == ',' || c == '\r'; };
+    auto siguienteToken = [&](const char*& inicio, const char*& final) {
+        while (p < fin && esSeparador(*p)) ++p;
+        inicio = p;
+        while (p < fin && !esSeparador(*p)) ++p;
+        final = p;
+        return inicio != final;
+    };
+
+    const char* ini;
+    const char* fen;
+    if (!siguienteToken(ini, fen)) {
+        error = "Error: Registro vacío.";
+        return false;
     }
-    uint32_t result = 0;
-    for (int i = 0; i < 4; ++i) {
-        try {
-            int octet_val = stoi(octetos[i]);
-            if (octet_val < 0 || octet_val > 255) {
-                return 0; // Octeto fuera de rango
+    string entradaRed(ini, fen);
+
+    // Formato 'IP - Máscara Decimal': el separador " - " ocupa un token propio
+    const char* guardado = p;
+    if (entradaRed.find('/') == string::npos) {
+        const char* iniGuion;
+        const char* finGuion;
+        const char* iniMascara;
+        const char* finMascara;
+        if (siguienteToken(iniGuion, finGuion) && finGuion - iniGuion == 1 && *iniGuion == '-' &&
+            siguienteToken(iniMascara, finMascara)) {
+            entradaRed += " - ";
+            entradaRed.append(iniMascara, finMascara);
+        } else {
+            p = guardado;
+        }
+    }
+
+    if (!analizarRed(entradaRed, ipBaseStr, cidrBase, error)) {
+        return false;
+    }
+
+    const uint32_t redBase = ipToInt(ipBaseStr);
+    const uint64_t broadcastBase = redBase + tamanoBloque(PrefijoIPv4(cidrBase)) - 1;
+
+    while (siguienteToken(ini, fen)) {
+        // Un token con '.' es un rango reservado; el resto, números de hosts
+        if (memchr(ini, '.', static_cast<size_t>(fen - ini)) != nullptr) {
+            RangoIPv4 rango;
+            if (!analizarRango(string_view(ini, static_cast<size_t>(fen - ini)), rango, error)) {
+                return false;
             }
-            result |= static_cast<uint32_t>(octet_val) << (24 - 8 * i);
-        } catch (const invalid_argument& e) {
-            return 0; // No es un número
-        } catch (const out_of_range& e) {
-            return 0; // Número fuera de rango
+            if (rango.inicio < redBase || rango.fin > broadcastBase) {
+                error = "Error: El rango reservado '" + string(ini, fen) + "' no está dentro de la red base.";
+                return false;
+            }
+            reservados.push_back(rango);
+            continue;
+        }
+
+        long long hosts = 0;
+        const char* q = ini;
+        for (; q < fen && *q >= '0' && *q <= '9'; ++q) {
+            hosts = hosts * 10 + (*q - '0');
+            if (hosts > numeric_limits<int>::max()) break;
+        }
+        if (q != fen || hosts > numeric_limits<int>::max()) {
+            error = "Error: Número de hosts inválido ('" + string(ini, fen) + "'). Debe ser un entero no negativo.";
+            return false;
         }
+        requestedHostCounts.push_back(static_cast<int>(hosts));
     }
-    return result;
+    if (requestedHostCounts.empty()) {
+        error = "Error: El registro no contiene números de hosts.";
+        return false;
+    }
+    return true;
 }
 
 /**
- * @brief Convierte un entero sin signo de 32 bits a una dirección IP en formato dotted decimal.
- * @param ip La dirección IP como un entero de 32 bits.
- * @return La dirección IP en formato de cadena.
+ * @brief Indica si una ruta es la de un archivo de planes binario (extensión .sbp).
+ * @param ruta La ruta.
+ * @return Verdadero si termina en ".sbp" (y no es solo la extensión).
  */
-string intToIp(uint32_t ip) {
-    return to_string((ip >> 24) & 0xFF) + "." +
-           to_string((ip >> 16) & 0xFF) + "." +
-           to_string((ip >> 8) & 0xFF) + "." +
-           to_string(ip & 0xFF);
+static bool esRutaPlanBinario(const string& ruta) {
+    return ruta.size() > 4 && ruta.compare(ruta.size() - 4, 4, ".sbp") == 0;
 }
 
 /**
- * @brief Convierte un entero sin signo de 32 bits a una cadena binaria con puntos cada 8 bits.
- * @param n El entero de 32 bits.
- * @return La cadena binaria formateada.
+ * @brief Analiza el valor de una opción numérica (--trabajo, --subred, --hilos): un entero positivo escrito
+ * solo con dígitos. stoul aceptaría "-1" (que da la vuelta a un valor enorme), "+5", " 5" o "4abc".
+ * @param opcion Nombre de la opción (para el mensaje).
+ * @param texto El valor.
+ * @param valor Recibe el número.
+ * @param error Recibe el mensaje de error.
+ * @return Verdadero si el valor es válido.
  */
-string uint32_tToBinaryString(uint32_t n) {
-    string binaryString;
-    for (int i = 31; i >= 0; --i) {
-        binaryString += ((n >> i) & 1) ? '1' : '0';
-        if (i % 8 == 0 && i != 0) {
-            binaryString += '.';
-        }
+static bool analizarNumeroOpcion(const string& opcion, const string& texto, size_t& valor, string& error) {
+    bool valido = !texto.empty() && texto.find_first_not_of("0123456789") == string::npos;
+    valor = 0;
+    for (size_t i = 0; valido && i < texto.size(); ++i) {
+        const size_t digito = static_cast<size_t>(texto[i] - '0');
+        valido = valor <= (numeric_limits<size_t>::max() - digito) / 10;
+        valor = valor * 10 + digito;
     }
-    return binaryString;
+    if (!valido || valor == 0) {
+        error = "Error: Valor inválido para " + opcion + " ('" + texto + "'). Debe ser un entero positivo.";
+        return false;
+    }
+    return true;
 }
 
+/** @brief Máximo de '--hilos' (el pool crea un hilo y una cola por cada uno). */
+static const size_t MAXIMO_HILOS = 1024;
+
 /**
- * @brief Convierte una máscara decimal (ej. "255.255.255.0") a un prefijo CIDR (ej. 24).
- * @param maskDecimal La máscara en formato de cadena dotted decimal.
- * @return El prefijo CIDR. Retorna -1 si la máscara no es válida.
+ * @brief Analiza el valor de '--hilos', con las mismas reglas en todos los modos: un entero entre 1 y
+ * MAXIMO_HILOS (sin la opción, los modos usan un hilo por núcleo).
+ * @param texto El valor.
+ * @param hilos Recibe la cantidad de hilos.
+ * @param error Recibe el mensaje de error.
+ * @return Verdadero si el valor es válido.
  */
-int maskToCidr(const string& maskDecimal) {
-    uint32_t maskInt = ipToInt(maskDecimal);
-    if (maskInt == 0 && maskDecimal != "0.0.0.0") { 
-        return -1; // Error en la conversión IP a Int para la máscara
+static bool analizarHilos(const string& texto, unsigned& hilos, string& error) {
+    size_t valor;
+    if (!analizarNumeroOpcion("--hilos", texto, valor, error) || valor > MAXIMO_HILOS) {
+        error = "Error: Valor inválido para --hilos ('" + texto + "'). Debe ser un entero entre 1 y " +
+                to_string(MAXIMO_HILOS) + ".";
+        return false;
     }
+    hilos = static_cast<unsigned>(valor);
+    return true;
+}
 
-    int cidr = 0;
-    bool sawZero = false;
-    for (int i = 31; i >= 0; --i) { // Recorre los bits de izquierda a derecha (MSB a LSB)
-        if ((maskInt >> i) & 1) { // Si el bit actual es 1
-            if (sawZero) {
-                return -1; // Máscara inválida (un 1 después de un 0, ej. 255.0.255.0)
-            }
-            cidr++;
-        } else { // Si el bit actual es 0
-            sawZero = true;
+/**
+ * @brief Obtiene el plan de partida de los modos que reciben un ORIGEN: el plan 'numeroTrabajo' de un
+ * archivo .sbp, o el plan calculado a partir de un TRABAJO.
+ * @param origen Ruta de un archivo .sbp o un TRABAJO ('IP/CIDR HOSTS... [RANGOS...]').
+ * @param numeroTrabajo Número del plan dentro del archivo .sbp (desde 1), o 0 si no se indicó
+ * '--trabajo' (el primer plan). Con un TRABAJO debe ser 0: la opción no tendría efecto.
+ * @param plan Recibe el plan, que puede no ser Correcto (el llamador decide cómo informarlo).
+ * @param error Recibe el mensaje de error.
+ * @return Verdadero si se obtuvo el plan; falso si el archivo, el trabajo o '--trabajo' no son válidos.
+ */
+static bool cargarPlanOrigen(const string& origen, size_t numeroTrabajo, PlanSubredes& plan, string& error) {
+    if (esRutaPlanBinario(origen)) {
+        LectorPlanBinario lector;
+        if (!lector.abrir(origen, error)) {
+            return false;
         }
+        numeroTrabajo = max<size_t>(numeroTrabajo, 1);
+        if (numeroTrabajo > lector.cantidadPlanes()) {
+            error = "Error: El archivo '" + origen + "' no tiene el plan " + to_string(numeroTrabajo) + " (tiene " +
+                    to_string(lector.cantidadPlanes()) + ").";
+            return false;
+        }
+        lector.reconstruirPlan(numeroTrabajo - 1, plan);
+        return true;
+    }
+    if (numeroTrabajo != 0) {
+        error = "Error: --trabajo solo se admite cuando ORIGEN es un archivo .sbp.";
+        return false;
     }
-    return cidr;
+    string ipBaseStr;
+    int cidrBase = -1;
+    vector<int> requestedHostCounts;
+    vector<RangoIPv4> reservados;
+    if (!analizarTrabajo(origen, ipBaseStr, cidrBase, requestedHostCounts, reservados, error)) {
+        return false;
+    }
+    planificarSubredes(plan, ipBaseStr, cidrBase, requestedHostCounts, reservados);
+    return true;
 }
 
-
 /**
- * @brief Convierte un prefijo CIDR (ej. 24) a una máscara de subred en formato dotted decimal (ej. "255.255.255.0").
- * @param cidr El prefijo CIDR.
- * @return La máscara de subred en formato de cadena.
+ * @brief Procesa trabajos de subneteo en modo no interactivo, uno por línea.
+ * Cada resultado se escribe en cuanto se calcula; la memoria usada no depende del número de trabajos.
+ * Las líneas vacías y el texto tras '#' se ignoran. Los registros inválidos se notifican por 'err'
+ * y el procesamiento continúa con la siguiente línea.
+ * Cada plan se calcula una sola vez y se escribe en todos los destinos del impresor.
+ * @param in Flujo de entrada con los registros de trabajo.
+ * @param impresor Impresor con los destinos de salida (consola, texto, CSV).
+ * @param err Flujo para los errores de los registros inválidos.
+ * @param binario Si no es nulo, recibe además cada plan en formato binario.
+ * @param informarProblemas Si es verdadero, los planes no correctos y las solicitudes no asignadas se
+ * notifican también por 'err' (cuando no hay consola, el CSV no los muestra).
+ * @return 0 si todos los registros eran válidos y todos los planes se asignaron completos, 1 en caso contrario.
  */
-string cidrToMask(int cidr) {
-    uint32_t mask = (cidr == 0) ? 0 : (~static_cast<uint32_t>(0) << (32 - cidr));
-    return intToIp(mask);
+int ejecutarModoLote(istream& in, ImpresorPlan& impresor, ostream& err, EscritorPlanBinario* binario = nullptr,
+                     bool informarProblemas = false) {
+    string linea;
+    string ipBaseStr;
+    int cidrBase = -1;
+    vector<int> requestedHostCounts; // Se reutiliza entre trabajos
+    vector<RangoIPv4> reservados;    // Se reutiliza entre trabajos
+    PlanSubredes plan;               // Se reutiliza entre trabajos
+    string titulo;
+    string error;
+    long long numeroLinea = 0;
+    long long numeroTrabajo = 0;
+    int codigo = 0;
+
+    while (getline(in, linea)) {
+        ++numeroLinea;
+        size_t comentario = linea.find('#');
+        if (comentario != string::npos) {
+            linea.erase(comentario);
+        }
+        if (linea.find_first_not_of(" \t\r,") == string::npos) {
+            continue; // Línea vacía o solo comentario
+        }
+
+        if (!analizarTrabajo(linea, ipBaseStr, cidrBase, requestedHostCounts, reservados, error)) {
+            err << "Línea " << numeroLinea << ": " << error << '\n';
+            codigo = 1;
+            continue;
+        }
+
+        ++numeroTrabajo;
+        titulo = "Trabajo " + to_string(numeroTrabajo) + " (línea " + to_string(numeroLinea) + "): " +
+                 ipBaseStr + "/" + to_string(cidrBase);
+        {
+            MEDIR_TRABAJO();
+            planificarSubredes(plan, ipBaseStr, cidrBase, requestedHostCounts, reservados);
+            impresor.imprimirTrabajo(plan, numeroTrabajo, titulo);
+        }
+        if (planConProblemas(plan)) {
+            codigo = 1;
+            if (informarProblemas) {
+                informarProblemasPlan(err, plan, titulo);
+            }
+        }
+        if (binario) {
+            binario->agregar(plan, numeroTrabajo, numeroLinea);
+        }
+    }
+    return codigo;
 }
 
 /**
- * @brief Calcula el prefijo CIDR más pequeño que puede contener un número dado de hosts.
- * @param num_hosts El número de hosts deseado.
- * @return El prefijo CIDR correspondiente. Retorna -1 si no es posible (ej. num_hosts muy grande).
+ * @brief Un registro del modo por lotes paralelo, con su resultado ya formateado.
+ */
+struct TrabajoLote {
+    string linea;
+    long long numeroLinea = 0;
+    bool vacio = false;             // Línea vacía o solo comentario
+    bool valido = false;
+    string error;
+    string ipBaseStr;
+    int cidrBase = -1;
+    vector<int> requestedHostCounts;
+    vector<RangoIPv4> reservados;
+    long long numeroTrabajo = 0;
+    vector<string> salidas;         // Texto generado para cada destino
+    bool conProblemas = false;      // Plan no correcto o con solicitudes no asignadas
+    string problemas;               // Su descripción para 'err' (si se informan)
+    PlanSubredes plan;              // Solo se conserva si hay exportación binaria
+};
+
+/**
+ * @brief Versión paralela de ejecutarModoLote(): reparte el análisis, la planificación y el formato
+ * de los trabajos entre los hilos del pool, por bloques de tamaño fijo (memoria constante).
+ * La salida es idéntica a la secuencial y respeta el orden de entrada.
+ * @param in Flujo de entrada con los registros de trabajo.
+ * @param destinos Flujos de salida y su formato.
+ * @param err Flujo para los errores de los registros inválidos.
+ * @param pool Pool de hilos.
+ * @param binario Si no es nulo, recibe además cada plan en formato binario.
+ * @param informarProblemas Igual que en ejecutarModoLote().
+ * @return 0 si todos los registros eran válidos y todos los planes se asignaron completos, 1 en caso contrario.
  */
-int hostsToCidr(int num_hosts) {
-    if (num_hosts < 0) return -1; // Número de hosts negativo no válido
+int ejecutarModoLoteParalelo(istream& in, const vector<pair<ostream*, FormatoSalida>>& destinos, ostream& err, PoolTrabajo& pool,
+                             EscritorPlanBinario* binario, bool informarProblemas) {
+    const size_t TRABAJOS_POR_BLOQUE = 4096;
+    vector<TrabajoLote> bloque(TRABAJOS_POR_BLOQUE);
+
+    // Memoria propia de cada hilo: un flujo por destino, su impresor y un plan reutilizable
+    struct EstadoHilo {
+        vector<ostringstream> flujos;
+        ImpresorPlan impresor;
+        PlanSubredes plan;
+    };
+    vector<EstadoHilo> estados(pool.cantidadHilos());
+    for (EstadoHilo& estado : estados) {
+        estado.flujos.resize(destinos.size());
+        for (size_t d = 0; d < destinos.size(); ++d) {
+            // El encabezado del CSV lo escribe una sola vez el hilo principal
+            estado.impresor.agregarDestino(estado.flujos[d], destinos[d].second, true);
+        }
+    }
+
+    long long numeroLinea = 0;
+    long long numeroTrabajo = 0;
+    bool encabezadosEscritos = false;
+    int codigo = 0;
 
-    if (num_hosts == 0) return 32; // /32 tiene 1 IP, 0 hosts utilizables
-    
-    int required_addresses = num_hosts + 2;
+    while (in) {
+        size_t cantidad = 0;
+        while (cantidad < TRABAJOS_POR_BLOQUE && getline(in, bloque[cantidad].linea)) {
+            bloque[cantidad].numeroLinea = ++numeroLinea;
+            ++cantidad;
+        }
+        if (cantidad == 0) {
+            break;
+        }
 
-    int bits_for_addresses = static_cast<int>(ceil(log2(required_addresses)));
+        // Fase 1 (paralela): análisis de cada registro
+        pool.paraCada(cantidad, [&](size_t i, unsigned) {
+            TrabajoLote& t = bloque[i];
+            size_t comentario = t.linea.find('#');
+            if (comentario != string::npos) {
+                t.linea.erase(comentario);
+            }
+            t.vacio = t.linea.find_first_not_of(" \t\r,") == string::npos;
+            t.valido = !t.vacio && analizarTrabajo(t.linea, t.ipBaseStr, t.cidrBase, t.requestedHostCounts, t.reservados, t.error);
+        });
 
-    int cidr = 32 - bits_for_addresses;
+        // Numeración de los trabajos válidos (secuencial, O(n))
+        for (size_t i = 0; i < cantidad; ++i) {
+            if (bloque[i].valido) {
+                bloque[i].numeroTrabajo = ++numeroTrabajo;
+            }
+        }
 
-    if (cidr < 0) return 0;   // Si es menor que 0, significa una subred muy grande, usa /0
-    if (cidr > 32) return 32; // Esto no debería ocurrir con la lógica, pero como seguridad
+        // Fase 2 (paralela): planificación y formato en los flujos del hilo
+        pool.paraCada(cantidad, [&](size_t i, unsigned hilo) {
+            TrabajoLote& t = bloque[i];
+            if (!t.valido) {
+                return;
+            }
+            MEDIR_TRABAJO();
+            EstadoHilo& estado = estados[hilo];
+            for (ostringstream& flujo : estado.flujos) {
+                flujo.str(string());
+            }
+            const string titulo = "Trabajo " + to_string(t.numeroTrabajo) + " (línea " + to_string(t.numeroLinea) + "): " +
+                                  t.ipBaseStr + "/" + to_string(t.cidrBase);
+            planificarSubredes(estado.plan, t.ipBaseStr, t.cidrBase, t.requestedHostCounts, t.reservados);
+            estado.impresor.imprimirTrabajo(estado.plan, t.numeroTrabajo, titulo);
+            t.salidas.resize(destinos.size());
+            for (size_t d = 0; d < destinos.size(); ++d) {
+                t.salidas[d] = estado.flujos[d].str();
+            }
+            t.conProblemas = planConProblemas(estado.plan);
+            t.problemas.clear();
+            if (t.conProblemas && informarProblemas) {
+                ostringstream problemas;
+                informarProblemasPlan(problemas, estado.plan, titulo);
+                t.problemas = problemas.str();
+            }
+            if (binario) {
+                swap(t.plan, estado.plan); // El hilo se queda con la memoria del plan anterior de la ranura
+            }
+        });
 
-    return cidr;
+        // Escritura en orden de entrada
+        MEDIR_FASE(Escritura);
+        for (size_t i = 0; i < cantidad; ++i) {
+            const TrabajoLote& t = bloque[i];
+            if (t.vacio) {
+                continue;
+            }
+            if (!t.valido) {
+                err << "Línea " << t.numeroLinea << ": " << t.error << '\n';
+                codigo = 1;
+                continue;
+            }
+            if (!encabezadosEscritos) {
+                for (const auto& destino : destinos) {
+                    if (destino.second == FormatoSalida::CSV) {
+                        imprimirEncabezadoLoteCSV(*destino.first);
+                    }
+                }
+                encabezadosEscritos = true;
+            }
+            for (size_t d = 0; d < destinos.size(); ++d) {
+                destinos[d].first->write(t.salidas[d].data(), static_cast<streamsize>(t.salidas[d].size()));
+            }
+            if (t.conProblemas) {
+                err << t.problemas;
+                codigo = 1;
+            }
+            if (binario) {
+                binario->agregar(t.plan, t.numeroTrabajo, t.numeroLinea);
+            }
+        }
+    }
+    return codigo;
 }
 
 /**
- * @brief Imprime el encabezado de la tabla de subredes, para consola o CSV.
+ * @brief Muestra la ayuda de la línea de comandos.
  * @param os Flujo de salida.
- * @param is_csv Verdadero si se imprime en CSV, falso para consola.
  */
-void printSubnetHeader(ostream& os, bool is_csv) {
-    if (is_csv) {
-        os << "Numero,Red,CIDR,MascaraDecimal,MascaraBinaria,RangoInicio,RangoFin,Broadcast,HostsDisponibles,HostsSolicitados\n";
+void mostrarAyuda(ostream& os) {
+    os << "Uso: calculadora                            Modo interactivo\n"
+       << "     calculadora --lote [ARCHIVO] [OPCIONES] Procesa un trabajo por línea desde ARCHIVO o la entrada estándar\n"
+       << "     calculadora --ipam ARCHIVO COMANDO      Gestiona un archivo IPAM persistente\n"
+       << "     calculadora --buscar TRABAJO [ARCHIVO]  Asigna cada dirección (una por línea) a su subred del plan\n"
+       << "     calculadora --convertir ARCHIVO.sbp [--csv] [SALIDA]\n"
+       << "                                             Convierte un plan binario a tabla (o CSV)\n"
+       << "     calculadora --dimensionar [IP] HOSTS [...] [--csv]\n"
+       << "                                             Calcula la red base más pequeña para esos hosts\n"
+       << "                                             (y, con IP, muestra el plan sobre ella)\n"
+       << "     calculadora --replanificar ORIGEN EDICION [...] [OPCIONES]\n"
+       << "                                             Aplica ediciones a un plan y muestra solo los cambios\n"
+       << "     calculadora --resumir [ARCHIVO] [--hilos N]\n"
+       << "                                             Agrega los prefijos (uno por línea) en el mínimo de superredes\n"
+       << "     calculadora --conflictos INVENTARIO [PLANES] [--hilos N]\n"
+       << "                                             Lista las subredes de los planes (.sbp o trabajos por línea)\n"
+       << "                                             que se solapan con algún prefijo del inventario\n"
+       << "     calculadora --servidor SOCKET|PUERTO [--hilos N]\n"
+       << "                                             Atiende peticiones por un socket Unix (o TCP en 127.0.0.1)\n"
+       << "     calculadora --enumerar ORIGEN [--subred N] [--trabajo K] [--salida RUTA]\n"
+       << "                                             Escribe las direcciones de host utilizables del plan (o de la\n"
+       << "                                             subred N), una por línea; ORIGEN es un TRABAJO o un .sbp\n"
+       << "     calculadora --utilizacion ORIGEN [--trabajo K] [--csv]\n"
+       << "                                             Muestra las IPs usadas y libres, los bloques libres alineados\n"
+       << "                                             de cada prefijo y la fragmentación de la red base del plan\n"
+       << "     calculadora --ipv6 RED SOLICITUD [...] [--csv]\n"
+       << "                                             Divide una red IPv6 (ej. 2001:db8::/32 /48x16 300 /64x1000)\n"
+       << "\n"
+       << "Con cualquier modo:\n"
+       << "  --stats        Al terminar, escribe en la salida de error el tiempo de cada fase, contadores\n"
+       << "                 y el histograma de latencia por trabajo (--stats=json: en JSON)\n"
+       << "\n"
+       << "Opciones del modo por lotes (pueden combinarse; cada plan se calcula una sola vez):\n"
+       << "  --csv RUTA     Escribe además todas las subredes en un CSV con una columna 'Trabajo'\n"
+       << "  --txt RUTA     Escribe además las tablas en un archivo de texto\n"
+       << "  --bin RUTA     Escribe además los planes en formato binario (.sbp)\n"
+       << "  --silencioso   No escribe las tablas en la consola\n"
+       << "  --hilos N      Hilos de planificación, entre 1 y 1024 (por defecto, uno por núcleo; 1 = secuencial)\n"
+       << "\n"
+       << "Formato de cada trabajo: RED HOSTS [HOSTS...] [RESERVADO...]\n"
+       << "  RED:       IP/CIDR (ej. 10.0.0.0/16) o IP - Máscara Decimal (ej. 10.0.0.0 - 255.255.0.0)\n"
+       << "  HOSTS:     números de hosts de cada subred, separados por espacios o comas\n"
+       << "  RESERVADO: rango ya ocupado dentro de la red, IP/CIDR o IP-IP (ej. 10.0.0.0/20 10.0.64.1-10.0.64.9)\n"
+       << "  Las líneas vacías y el texto tras '#' se ignoran.\n"
+       << "\n"
+       << "Comandos IPAM:\n"
+       << "  crear                       Crea un archivo IPAM vacío\n"
+       << "  red RED                     Añade una red base (ej. 10.0.0.0/16)\n"
+       << "  asignar RED HOSTS [...]     Asigna bloques en la red base indicada\n"
+       << "  liberar BLOQUE              Libera un bloque asignado (ej. 10.0.4.0/24)\n"
+       << "  consultar IP [...]          Muestra el bloque que contiene cada dirección\n"
+       << "  listar [--csv]              Muestra las redes base con sus bloques y espacio libre\n"
+       << "\n"
+       << "Replanificación (ORIGEN es un TRABAJO o un archivo .sbp):\n"
+       << "  +HOSTS         Agrega una subred\n"
+       << "  -N             Elimina la subred N (número de la columna '#' del plan de partida)\n"
+       << "  N=HOSTS        Cambia los hosts de la subred N; las demás conservan su dirección\n"
+       << "  --csv          Cambios (y plan) en CSV\n"
+       << "  --plan         Muestra también el plan resultante\n"
+       << "  --bin RUTA     Guarda el plan resultante en formato binario (.sbp)\n"
+       << "  --trabajo K    Plan K del archivo .sbp (por defecto, 1; con un TRABAJO no se admite)\n"
+       << "\n"
+       << "Peticiones del servidor (una por línea; respuesta \"OK <bytes>\" y los datos, o \"ERROR <mensaje>\"):\n"
+       << "  plan TRABAJO        Plan del trabajo en CSV (ERROR si no es válido o alguna solicitud no cabe)\n"
+       << "  cargar TRABAJO      Calcula el plan y lo deja como plan de búsqueda, compartido por todos los clientes\n"
+       << "  buscar IP [...]     Subred del plan cargado para cada dirección (\"IP,RED/CIDR\" o \"IP,-\")\n"
+       << "\n"
+       << "Solicitudes IPv6:\n"
+       << "  /P          Un bloque con prefijo /P\n"
+       << "  N           El bloque más pequeño que contiene N redes /64\n"
+       << "  ...xM       M bloques iguales (ej. /64x1000000)\n";
+}
+
+/**
+ * @brief Interpreta las opciones de '--lote', abre los destinos y ejecuta el modo por lotes.
+ * @param argc Cantidad de argumentos de main().
+ * @param argv Argumentos de main(); argv[1] es "--lote".
+ * @return Código de salida del programa.
+ */
+int ejecutarLineaDeComandosLote(int argc, char* argv[]) {
+    string rutaEntrada = "-";
+    bool entradaIndicada = false;
+    bool consola = true;
+    unsigned hilos = 0; // 0 = uno por núcleo
+    vector<pair<string, FormatoSalida>> rutasSalida;
+    string rutaBinaria;
+
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        if ((arg == "--csv" || arg == "--txt") && i + 1 < argc) {
+            rutasSalida.push_back({argv[++i], arg == "--csv" ? FormatoSalida::CSV : FormatoSalida::Tabla});
+        } else if (arg == "--bin" && i + 1 < argc) {
+            rutaBinaria = argv[++i];
+        } else if (arg == "--silencioso") {
+            consola = false;
+        } else if (arg == "--hilos" && i + 1 < argc) {
+            string error;
+            if (!analizarHilos(argv[++i], hilos, error)) {
+                cerr << error << "\n";
+                return 1;
+            }
+        } else if (!entradaIndicada && (arg == "-" || arg.compare(0, 2, "--") != 0)) {
+            rutaEntrada = arg;
+            entradaIndicada = true;
+        } else {
+            mostrarAyuda(cerr);
+            return 1;
+        }
+    }
+
+    ios::sync_with_stdio(false);
+
+    ifstream archivoLote;
+    if (rutaEntrada != "-") {
+        archivoLote.open(rutaEntrada);
+        if (!archivoLote.is_open()) {
+            cerr << "Error: No se pudo abrir el archivo de trabajos '" << rutaEntrada << "'.\n";
+            return 1;
+        }
+    }
+
+    vector<pair<ostream*, FormatoSalida>> destinos;
+    if (consola) {
+        destinos.push_back({&cout, FormatoSalida::Tabla});
+    }
+    vector<ofstream> archivosSalida(rutasSalida.size());
+    for (size_t i = 0; i < rutasSalida.size(); ++i) {
+        archivosSalida[i].open(rutasSalida[i].first);
+        if (!archivosSalida[i].is_open()) {
+            cerr << "Error: No se pudo abrir el archivo de salida '" << rutasSalida[i].first << "'.\n";
+            return 1;
+        }
+        destinos.push_back({&archivosSalida[i], rutasSalida[i].second});
+    }
+
+    EscritorPlanBinario escritorBinario;
+    EscritorPlanBinario* binario = nullptr;
+    string error;
+    if (!rutaBinaria.empty()) {
+        if (!escritorBinario.abrir(rutaBinaria, true, error)) {
+            cerr << error << "\n";
+            return 1;
+        }
+        binario = &escritorBinario;
+    }
+
+    istream& entrada = (rutaEntrada == "-") ? cin : archivoLote;
+    int codigo;
+    PoolTrabajo pool(hilos);
+    if (pool.cantidadHilos() == 1) {
+        ImpresorPlan impresor;
+        for (const auto& destino : destinos) {
+            impresor.agregarDestino(*destino.first, destino.second);
+        }
+        codigo = ejecutarModoLote(entrada, impresor, cerr, binario, !consola);
     } else {
-        const int COL_WIDTH_NUM = 5;
-        const int COL_WIDTH_NETWORK = 18;
-        const int COL_WIDTH_CIDR = 8;
-        const int COL_WIDTH_MASK_DEC = 18;
-        const int COL_WIDTH_MASK_BIN = 37;
-        const int COL_WIDTH_RANGE_START = 18;
-        const int COL_WIDTH_RANGE_END = 18;
-        const int COL_WIDTH_BROADCAST = 18;
-        const int COL_WIDTH_HOSTS = 10;
-        const int COL_WIDTH_REQ_HOSTS = 12;
-
-        os << left << setw(COL_WIDTH_NUM) << "#"
-           << setw(COL_WIDTH_NETWORK) << "Red"
-           << setw(COL_WIDTH_CIDR) << "CIDR"
-           << setw(COL_WIDTH_MASK_DEC) << "Máscara (Dec)"
-           << setw(COL_WIDTH_MASK_BIN) << "Máscara (Bin)"
-           << setw(COL_WIDTH_RANGE_START) << "Rango Inicio"
-           << setw(COL_WIDTH_RANGE_END) << "Rango Fin"
-           << setw(COL_WIDTH_BROADCAST) << "Broadcast"
-           << setw(COL_WIDTH_HOSTS) << "Hosts Disp."
-           << setw(COL_WIDTH_REQ_HOSTS) << "Hosts Sol." << endl;
-        os << string(COL_WIDTH_NUM + COL_WIDTH_NETWORK + COL_WIDTH_CIDR + COL_WIDTH_MASK_DEC + COL_WIDTH_MASK_BIN +
-                     COL_WIDTH_RANGE_START + COL_WIDTH_RANGE_END + COL_WIDTH_BROADCAST + COL_WIDTH_HOSTS + COL_WIDTH_REQ_HOSTS, '-') << endl;
+        codigo = ejecutarModoLoteParalelo(entrada, destinos, cerr, pool, binario, !consola);
+    }
+    if (binario && !escritorBinario.cerrar(error)) {
+        cerr << error << "\n";
+        codigo = 1;
     }
+    cout.flush();
+    return codigo;
 }
 
 /**
- * @brief Imprime los detalles de una única subred, para consola o CSV.
- * @param os Flujo de salida.
- * @param subnet El objeto Subred que contiene los detalles.
- * @param is_csv Verdadero si se imprime en CSV, falso para consola.
- * @param counter El número de la subred.
+ * @brief Ejecuta una operación sobre un archivo IPAM persistente ('--ipam ARCHIVO COMANDO ...').
+ * @param argc Cantidad de argumentos de main().
+ * @param argv Argumentos de main(); argv[1] es "--ipam".
+ * @return Código de salida del programa.
  */
-void printSubnetRow(ostream& os, const Subred& subnet, bool is_csv, int counter) {
-    if (is_csv) {
-        os << counter << ","
-           << subnet.direccionRed << ","
-           << "/" << subnet.cidr << ","
-           << subnet.mascaraDecimal << ","
-           << subnet.mascaraBinaria << ","
-           << subnet.hostRangeStart << ","
-           << subnet.hostRangeEnd << ","
-           << subnet.broadcast << ","
-           << subnet.hostsUtilizables << ","
-           << subnet.requestedHosts << "\n";
-    } else {
-        const int COL_WIDTH_NUM = 5;
-        const int COL_WIDTH_NETWORK = 18;
-        const int COL_WIDTH_CIDR = 8;
-        const int COL_WIDTH_MASK_DEC = 18;
-        const int COL_WIDTH_MASK_BIN = 37;
-        const int COL_WIDTH_RANGE_START = 18;
-        const int COL_WIDTH_RANGE_END = 18;
-        const int COL_WIDTH_BROADCAST = 18;
-        const int COL_WIDTH_HOSTS = 10;
-        const int COL_WIDTH_REQ_HOSTS = 12;
-
-        os << left << setw(COL_WIDTH_NUM) << counter
-           << setw(COL_WIDTH_NETWORK) << subnet.direccionRed
-           << setw(COL_WIDTH_CIDR) << "/" + to_string(subnet.cidr)
-           << setw(COL_WIDTH_MASK_DEC) << subnet.mascaraDecimal
-           << setw(COL_WIDTH_MASK_BIN) << subnet.mascaraBinaria
-           << setw(COL_WIDTH_RANGE_START) << subnet.hostRangeStart
-           << setw(COL_WIDTH_RANGE_END) << subnet.hostRangeEnd
-           << setw(COL_WIDTH_BROADCAST) << subnet.broadcast
-           << setw(COL_WIDTH_HOSTS) << subnet.hostsUtilizables
-           << setw(COL_WIDTH_REQ_HOSTS) << subnet.requestedHosts << endl;
+int ejecutarModoIPAM(int argc, char* argv[]) {
+    if (argc < 4) {
+        mostrarAyuda(cerr);
+        return 1;
+    }
+    const string ruta = argv[2];
+    const string comando = argv[3];
+    string error;
+    AlmacenIPAM almacen;
+
+    if (comando == "crear") {
+        if (!almacen.crear(ruta, error) || !almacen.sincronizar(error)) {
+            cerr << error << "\n";
+            return 1;
+        }
+        cout << "Archivo IPAM '" << ruta << "' creado.\n";
+        return 0;
+    }
+    if (!almacen.abrir(ruta, error)) {
+        cerr << error << "\n";
+        return 1;
+    }
+
+    string ipBaseStr;
+    int cidrBase = -1;
+    if ((comando == "red" || comando == "liberar") && argc == 5) {
+        if (!analizarRed(argv[4], ipBaseStr, cidrBase, error)) {
+            cerr << error << "\n";
+            return 1;
+        }
+        uint32_t red = ipToInt(ipBaseStr);
+        bool correcto = (comando == "red") ? almacen.agregarRed(red, cidrBase, error) : almacen.liberar(red, cidrBase, error);
+        if (!correcto || !almacen.sincronizar(error)) {
+            cerr << error << "\n";
+            return 1;
+        }
+        cout << (comando == "red" ? "Red base añadida: " : "Bloque liberado: ") << ipBaseStr << "/" << cidrBase << "\n";
+        return 0;
+    }
+    if (comando == "asignar" && argc >= 6) {
+        if (!analizarRed(argv[4], ipBaseStr, cidrBase, error)) {
+            cerr << error << "\n";
+            return 1;
+        }
+        vector<int> hosts;
+        for (int i = 5; i < argc; ++i) {
+            // Solo dígitos: stoi aceptaría "12abc", "+5" o " 5"
+            const string arg = argv[i];
+            try {
+                if (arg.empty() || arg.find_first_not_of("0123456789") != string::npos) {
+                    throw invalid_argument(arg);
+                }
+                hosts.push_back(stoi(arg));
+            } catch (const exception&) {
+                cerr << "Error: Número de hosts inválido ('" << arg << "'). Debe ser un entero no negativo.\n";
+                return 1;
+            }
+        }
+        // Igual que en un plan, los bloques más grandes se asignan primero
+        stable_sort(hosts.begin(), hosts.end(), [](int a, int b) { return a > b; });
+        int codigo = 0;
+        for (int h : hosts) {
+            BloqueIPv4 bloque;
+            if (almacen.asignar(ipToInt(ipBaseStr), cidrBase, h, bloque, error)) {
+                cout << "Asignada: " << intToIp(bloque.red) << "/" << bloque.cidr << " (" << h << " hosts)\n";
+            } else {
+                cout << "No asignada (" << h << " hosts): " << error << "\n";
+                codigo = 1;
+            }
+        }
+        // Las asignaciones se confirman en el disco antes de terminar
+        if (!almacen.sincronizar(error)) {
+            cerr << error << "\n";
+            return 1;
+        }
+        return codigo;
+    }
+    if (comando == "consultar" && argc >= 5) {
+        int codigo = 0;
+        for (int i = 4; i < argc; ++i) {
+            uint32_t ip;
+            RegistroBloqueIPAM registro;
+            if (parseIPv4(argv[i], ip) != ErrorIPv4::Ninguno) {
+                cerr << "Error: Dirección inválida ('" << argv[i] << "').\n";
+                codigo = 1;
+            } else if (almacen.consultar(ip, registro)) {
+                const RegistroRedIPAM& base = almacen.red(registro.indiceRed);
+                cout << argv[i] << " -> " << intToIp(registro.red) << "/" << static_cast<int>(registro.cidr)
+                     << " (" << registro.hostsSolicitados << " hosts, red base " << intToIp(base.red) << "/"
+                     << static_cast<int>(base.cidr) << ")\n";
+            } else {
+                cout << argv[i] << " -> sin asignar\n";
+            }
+        }
+        return codigo;
+    }
+    if (comando == "listar" && argc <= 5) {
+        bool is_csv = argc == 5 && string(argv[4]) == "--csv";
+        if (argc == 5 && !is_csv) {
+            mostrarAyuda(cerr);
+            return 1;
+        }
+        // Cada red base se presenta como un plan, con la misma tabla que un cálculo normal
+        PlanSubredes plan;
+        vector<RegistroBloqueIPAM> registros;
+        for (size_t i = 0; i < almacen.cantidadRedes(); ++i) {
+            const RegistroRedIPAM& base = almacen.red(i);
+            if (!AlmacenIPAM::redValida(base)) {
+                continue; // Registro dañado: se ignora, como sus bloques
+            }
+            plan.ipBaseStr = intToIp(base.red);
+            plan.cidrBase = base.cidr;
+            plan.redBase = base.red;
+            plan.broadcastBase = broadcastDe(DireccionIPv4(base.red), PrefijoIPv4(base.cidr)).valor;
+            plan.subredes.clear();
+            almacen.contenidoRed(i, registros, plan.espacioLibre);
+            for (const RegistroBloqueIPAM& r : registros) {
+                plan.subredes.push_back({r.red, r.hostsSolicitados, r.cidr, {}});
+            }
+            plan.direccionesLibres = 0;
+            for (const RangoIPv4& libre : plan.espacioLibre) {
+                plan.direccionesLibres += uint64_t(libre.fin) - libre.inicio + 1;
+            }
+            imprimirPlan(cout, plan, is_csv);
+        }
+        return 0;
+    }
+    mostrarAyuda(cerr);
+    return 1;
+}
+
+/**
+ * @brief Asigna a su subred, mediante una tabla LPM, cada dirección leída de un archivo o de la
+ * entrada estándar ('--buscar TRABAJO [ARCHIVO]'). El plan se calcula a partir del registro de
+ * trabajo, con el mismo formato que en el modo por lotes.
+ * Escribe "IP,RED/CIDR" por dirección ("IP,-" si no pertenece a ninguna subred) y, por la salida de
+ * error, el tiempo de construcción, la memoria del índice y el ritmo de búsqueda.
+ * @param argc Cantidad de argumentos de main().
+ * @param argv Argumentos de main(); argv[1] es "--buscar".
+ * @return Código de salida del programa.
+ */
+int ejecutarModoBusqueda(int argc, char* argv[]) {
+    if (argc < 3 || argc > 4) {
+        mostrarAyuda(cerr);
+        return 1;
+    }
+    string ipBaseStr;
+    int cidrBase = -1;
+    vector<int> requestedHostCounts;
+    vector<RangoIPv4> reservados;
+    string error;
+    if (!analizarTrabajo(argv[2], ipBaseStr, cidrBase, requestedHostCounts, reservados, error)) {
+        cerr << error << "\n";
+        return 1;
+    }
+    PlanSubredes plan;
+    planificarSubredes(plan, ipBaseStr, cidrBase, requestedHostCounts, reservados);
+    if (plan.resultado != ResultadoPlan::Correcto) {
+        imprimirPlan(cerr, plan, false);
+        return 1;
+    }
+
+    FILE* entrada = stdin;
+    if (argc == 4 && string(argv[3]) != "-") {
+        entrada = fopen(argv[3], "rb");
+        if (!entrada) {
+            cerr << "Error: No se pudo abrir el archivo de direcciones '" << argv[3] << "'.\n";
+            return 1;
+        }
     }
+
+    vector<BloqueIPv4> bloques;
+    vector<string> etiquetas; // "RED/CIDR" de cada subred, generado una sola vez
+    for (const Subred& subnet : plan.subredes) {
+        bloques.push_back({subnet.red, subnet.cidr});
+        etiquetas.push_back(intToIp(subnet.red) + "/" + to_string(subnet.cidr));
+    }
+
+    auto inicioConstruccion = chrono::steady_clock::now();
+    TablaLPM tabla;
+    tabla.construir(bloques);
+    double msConstruccion = chrono::duration<double, milli>(chrono::steady_clock::now() - inicioConstruccion).count();
+    cerr << "Índice LPM (DIR-24-8): " << bloques.size() << " subredes, " << tabla.cantidadGrupos()
+         << " grupos /24, construido en " << msConstruccion << " ms, memoria " << tabla.memoriaUsada() / 1024 << " KiB\n";
+
+    const size_t TAMANO_BLOQUE = size_t(4) << 20;
+    vector<char> buffer(TAMANO_BLOQUE);
+    size_t pendiente = 0; // Bytes de una línea incompleta al final del bloque anterior
+    vector<uint32_t> ips;
+    vector<uint32_t> resultados;
+    string salida;
+    salida.reserve(TAMANO_BLOQUE * 2);
+    size_t totalDirecciones = 0;
+    size_t totalInvalidas = 0;
+    double nsBusqueda = 0;
+
+    while (true) {
+        size_t leidos = fread(buffer.data() + pendiente, 1, buffer.size() - pendiente, entrada);
+        size_t disponibles = pendiente + leidos;
+        if (disponibles == 0) {
+            break;
+        }
+        // Solo se procesan líneas completas, salvo al final del archivo
+        size_t procesables = disponibles;
+        if (leidos != 0) {
+            while (procesables > 0 && buffer[procesables - 1] != '\n') {
+                --procesables;
+            }
+            if (procesables == 0) {
+                if (disponibles < buffer.size()) {
+                    pendiente = disponibles;
+                    continue;
+                }
+                procesables = disponibles; // Línea más larga que el buffer: se analiza tal cual (será inválida)
+            }
+        }
+
+        ips.clear();
+        ResultadoLoteIPv4 r = parseIPv4Lote(string_view(buffer.data(), procesables), ips);
+        totalInvalidas += r.invalidas;
+        totalDirecciones += ips.size();
+        resultados.resize(ips.size());
+
+        auto inicioBusqueda = chrono::steady_clock::now();
+        tabla.buscarLote(ips.data(), ips.size(), resultados.data());
+        nsBusqueda += chrono::duration<double, nano>(chrono::steady_clock::now() - inicioBusqueda).count();
+
+        salida.clear();
+        char ipTexto[16];
+        for (size_t i = 0; i < ips.size(); ++i) {
+            salida.append(ipTexto, formatearIPv4(ipTexto, ips[i]));
+            salida += ',';
+            if (resultados[i] == TablaLPM::SIN_COINCIDENCIA) {
+                salida += '-';
+            } else {
+                salida += etiquetas[resultados[i]];
+            }
+            salida += '\n';
+        }
+        fwrite(salida.data(), 1, salida.size(), stdout);
+
+        pendiente = disponibles - procesables;
+        memmove(buffer.data(), buffer.data() + procesables, pendiente);
+        if (leidos == 0) {
+            break;
+        }
+    }
+    fflush(stdout);
+    if (entrada != stdin) {
+        fclose(entrada);
+    }
+
+    const double segundos = nsBusqueda / 1e9;
+    cerr << "Búsquedas: " << totalDirecciones << " direcciones en " << nsBusqueda / 1e6 << " ms";
+    if (segundos > 0) {
+        cerr << " (" << static_cast<double>(totalDirecciones) / segundos / 1e6 << " millones/s)";
+    }
+    cerr << "\n";
+    if (totalInvalidas > 0) {
+        cerr << "Advertencia: " << totalInvalidas << " líneas no eran direcciones IPv4 válidas y se omitieron.\n";
+    }
+    return 0;
+}
+
+/**
+ * @brief Modo '--convertir': escribe un archivo binario de planes como tabla o CSV.
+ * @param argc Cantidad de argumentos de main().
+ * @param argv Argumentos de main(); argv[1] es "--convertir".
+ * @return Código de salida del programa.
+ */
+int ejecutarModoConversion(int argc, char* argv[]) {
+    string rutaBinaria;
+    string rutaSalida;
+    FormatoSalida formato = FormatoSalida::Tabla;
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--csv") {
+            formato = FormatoSalida::CSV;
+        } else if (rutaBinaria.empty()) {
+            rutaBinaria = arg;
+        } else if (rutaSalida.empty()) {
+            rutaSalida = arg;
+        } else {
+            mostrarAyuda(cerr);
+            return 1;
+        }
+    }
+    if (rutaBinaria.empty()) {
+        mostrarAyuda(cerr);
+        return 1;
+    }
+
+    LectorPlanBinario lector;
+    string error;
+    if (!lector.abrir(rutaBinaria, error)) {
+        cerr << error << "\n";
+        return 1;
+    }
+    if (rutaSalida.empty() || rutaSalida == "-") {
+        convertirPlanBinario(lector, cout, formato);
+        cout.flush();
+        return 0;
+    }
+    ofstream archivo(rutaSalida);
+    if (!archivo.is_open()) {
+        cerr << "Error: No se pudo abrir el archivo de salida '" << rutaSalida << "'.\n";
+        return 1;
+    }
+    convertirPlanBinario(lector, archivo, formato);
+    return 0;
 }
 
 /**
- * @brief Calcula y muestra/exporta las subredes solicitadas.
- * Asigna subredes de mayor tamaño a menor tamaño para optimizar el espacio.
- * Los resultados se imprimen en una tabla formateada y pueden exportarse a un archivo.
- * @param os Flujo de salida (ej. cout o un ofstream).
- * @param ipBaseStr La dirección IP base de la red (como string para mensajes de error).
- * @param cidrBase El prefijo CIDR de la red base.
- * @param requestedHostCounts Un vector de números de hosts solicitados para las nuevas subredes.
- * @param is_csv_output Verdadero si la salida debe estar en formato CSV.
+ * @brief Modo '--dimensionar': calcula la red base más pequeña en la que caben las subredes pedidas.
+ * Con una IP, además calcula y muestra el plan sobre esa red.
+ * @param argc Cantidad de argumentos de main().
+ * @param argv Argumentos de main(); argv[1] es "--dimensionar".
+ * @return Código de salida del programa.
  */
-void calcularSubredes(ostream& os, string ipBaseStr, int cidrBase, vector<int> requestedHostCounts, bool is_csv_output) {
-    uint32_t ipNumericaBase = ipToInt(ipBaseStr);
-    uint32_t mascaraBaseNumerica = (~static_cast<uint32_t>(0) << (32 - cidrBase));
-    
-    uint32_t originalNetworkAddress = ipNumericaBase & mascaraBaseNumerica;
-    uint32_t originalBroadcastAddress = originalNetworkAddress | (~mascaraBaseNumerica);
-    uint32_t totalOriginalIps = originalBroadcastAddress - originalNetworkAddress + 1;
-
-    if (originalNetworkAddress != ipNumericaBase) {
-        os << "Error: La dirección IP de entrada '" << ipBaseStr << "' no es una dirección de red válida para la máscara /" << cidrBase << ".\n";
-        os << "La dirección de red correcta para esta IP y máscara sería: " << intToIp(originalNetworkAddress) << endl;
-        return;
-    }
-    
-    if (!is_csv_output) { // Solo imprime esta información en consola, no en CSV
-        os << "\n--- Resultados de Subneteo ---\n";
-        os << "Red Original: " << intToIp(originalNetworkAddress) << "/" << cidrBase 
-           << " (Broadcast: " << intToIp(originalBroadcastAddress) << ", IPs Totales: " 
-           << totalOriginalIps << ")\n\n";
-    }
-
-    vector<pair<int, int>> subnetsToAllocateInfo; // par<CIDR, hosts_solicitados_originales>
-    uint32_t totalRequestedIpSpace = 0; // Para la validación previa de capacidad
-
-    for (int hosts : requestedHostCounts) {
-        int cidr = hostsToCidr(hosts);
-        if (cidr != -1) { // -1 indica un número de hosts inválido
-            uint32_t subnetSize = static_cast<uint32_t>(pow(2, 32 - cidr));
-            totalRequestedIpSpace += subnetSize;
-            subnetsToAllocateInfo.push_back({cidr, hosts});
+int ejecutarModoDimensionado(int argc, char* argv[]) {
+    bool is_csv = false;
+    string ipBaseStr;
+    vector<int> hosts;
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        uint32_t ip;
+        if (arg == "--csv") {
+            is_csv = true;
+        } else if (ipBaseStr.empty() && hosts.empty() && parseIPv4(arg, ip) == ErrorIPv4::Ninguno) {
+            ipBaseStr = arg;
         } else {
-            os << "Advertencia: El número de hosts solicitado (" << hosts << ") es inválido o demasiado grande. Ignorando.\n";
-        }
-    }
-
-    // Validación previa: Comprobar si el total de IPs solicitadas excede la capacidad de la red original
-    if (totalRequestedIpSpace > totalOriginalIps) {
-        os << "\nError: La suma de IPs requeridas por las subredes solicitadas (" << totalRequestedIpSpace 
-           << ") excede la capacidad total de la red original (" << totalOriginalIps << ").\n";
-        os << "No se pueden asignar estas subredes. Por favor, revise sus solicitudes de hosts o use una red base más grande.\n";
-        return;
-    }
-
-    // Ordena las subredes a asignar. Queremos asignar las subredes más grandes primero.
-    // Un CIDR más pequeño significa una subred más grande.
-    // Por lo tanto, ordenamos por CIDR en orden ascendente.
-    sort(subnetsToAllocateInfo.begin(), subnetsToAllocateInfo.end(), 
-         [](const pair<int, int>& a, const pair<int, int>& b) {
-             return a.first < b.first; // Ordena por CIDR de menor a mayor
-         });
-
-    uint32_t currentAllocationIp = originalNetworkAddress;
-    int subnetCounter = 0;
-    
-    printSubnetHeader(os, is_csv_output); // Imprime el encabezado de la tabla/CSV
-
-    for (const auto& subnetInfo : subnetsToAllocateInfo) {
-        int requestedCidr = subnetInfo.first;
-        int originalHostsRequested = subnetInfo.second;
-
-        // Si el CIDR solicitado es mayor que 32 o menor que 0 (casos inválidos)
-        if (requestedCidr > 32 || requestedCidr < 0) { 
-             Subred currentSubnet; // Crea una subred ficticia para imprimir la advertencia
-             currentSubnet.direccionRed = "INVALIDO";
-             currentSubnet.cidr = requestedCidr;
-             currentSubnet.mascaraDecimal = "INVALIDO";
-             currentSubnet.mascaraBinaria = "INVALIDO";
-             currentSubnet.hostRangeStart = "N/A";
-             currentSubnet.hostRangeEnd = "N/A";
-             currentSubnet.broadcast = "N/A";
-             currentSubnet.hostsUtilizables = 0;
-             currentSubnet.requestedHosts = originalHostsRequested;
-             
-             subnetCounter++;
-             if (!is_csv_output) os << "Advertencia: "; // Prefijo de advertencia solo en consola
-             printSubnetRow(os, currentSubnet, is_csv_output, subnetCounter);
-             if (!is_csv_output) os << "  (Subred solicitada para " << originalHostsRequested << " hosts (/" << requestedCidr << ") es inviable o inválida. Saltando.)\n";
-             continue;
-        }
-
-        uint32_t requestedSubnetSize = static_cast<uint32_t>(pow(2, 32 - requestedCidr));
-        uint32_t potentialSubnetBroadcast = currentAllocationIp + requestedSubnetSize - 1;
-        
-        // Verifica si la subred solicitada puede ser asignada en el espacio actual
-        // y si su dirección de broadcast no excede la de la red original.
-        if (potentialSubnetBroadcast > originalBroadcastAddress || currentAllocationIp > originalBroadcastAddress) {
-            Subred currentSubnet; // Crea una subred ficticia para imprimir la advertencia
-            currentSubnet.direccionRed = "SIN ESPACIO";
-            currentSubnet.cidr = requestedCidr;
-            currentSubnet.mascaraDecimal = "N/A";
-            currentSubnet.mascaraBinaria = "N/A";
-            currentSubnet.hostRangeStart = "N/A";
-            currentSubnet.hostRangeEnd = "N/A";
-            currentSubnet.broadcast = "N/A";
-            currentSubnet.hostsUtilizables = 0;
-            currentSubnet.requestedHosts = originalHostsRequested;
-            
-            subnetCounter++;
-            if (!is_csv_output) os << "Advertencia: "; // Prefijo de advertencia solo en consola
-            printSubnetRow(os, currentSubnet, is_csv_output, subnetCounter);
-            if (!is_csv_output) os << "  (Subred para " << originalHostsRequested << " hosts (/" << requestedCidr 
-                 << ") NO CABE. IPs restantes: " << (originalBroadcastAddress - currentAllocationIp + 1) << ".)\n";
-            continue; 
-        }
-
-        subnetCounter++;
-        int hostsPorSubredCalculado = (requestedSubnetSize > 2) ? (requestedSubnetSize - 2) : 0;
-
-        Subred currentSubnet;
-        currentSubnet.direccionRed = intToIp(currentAllocationIp);
-        currentSubnet.cidr = requestedCidr;
-        currentSubnet.mascaraDecimal = cidrToMask(requestedCidr);
-        currentSubnet.mascaraBinaria = uint32_tToBinaryString(ipToInt(currentSubnet.mascaraDecimal));
-        currentSubnet.hostsUtilizables = hostsPorSubredCalculado;
-        currentSubnet.requestedHosts = originalHostsRequested;
-
-        if (hostsPorSubredCalculado > 0) {
-            currentSubnet.hostRangeStart = intToIp(currentAllocationIp + 1);
-            currentSubnet.hostRangeEnd = intToIp(potentialSubnetBroadcast - 1);
-            currentSubnet.broadcast = intToIp(potentialSubnetBroadcast);
+            try {
+                size_t leidos = 0;
+                int h = stoi(arg, &leidos);
+                if (leidos != arg.size() || h < 0) {
+                    throw invalid_argument(arg);
+                }
+                hosts.push_back(h);
+            } catch (const exception&) {
+                cerr << "Error: Número de hosts inválido ('" << arg << "').\n";
+                return 1;
+            }
+        }
+    }
+    if (hosts.empty()) {
+        mostrarAyuda(cerr);
+        return 1;
+    }
+
+    uint64_t direccionesNecesarias;
+    const int prefijo = prefijoBaseMinimo(hosts, direccionesNecesarias);
+    if (prefijo < 0) {
+        cerr << "Error: Las subredes solicitadas necesitan más de 2^32 direcciones; no caben ni en un /0.\n";
+        return 1;
+    }
+    if (ipBaseStr.empty() || !is_csv) {
+        cout << "Red base mínima: /" << prefijo << " (" << tamanoBloque(PrefijoIPv4(prefijo))
+             << " direcciones; las subredes ocupan " << direccionesNecesarias << ")\n";
+    }
+    if (ipBaseStr.empty()) {
+        cout.flush();
+        return 0;
+    }
+
+    // Los problemas del plan (una IP que no es la red de ese prefijo) van a cerr, no entre la tabla o el CSV
+    PlanSubredes plan;
+    planificarSubredes(plan, ipBaseStr, prefijo, hosts);
+    if (plan.resultado == ResultadoPlan::Correcto) {
+        imprimirPlan(cout, plan, is_csv);
+    }
+    cout.flush();
+    if (planConProblemas(plan)) {
+        informarProblemasPlan(cerr, plan, ipBaseStr + "/" + to_string(prefijo));
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Modo '--replanificar': aplica ediciones a un plan existente sin recalcularlo y muestra los cambios.
+ * @param argc Cantidad de argumentos de main().
+ * @param argv Argumentos de main(); argv[1] es "--replanificar".
+ * @return Código de salida del programa.
+ */
+int ejecutarModoReplanificacion(int argc, char* argv[]) {
+    string origen;
+    string rutaBinaria;
+    bool is_csv = false;
+    bool mostrarPlan = false;
+    size_t numeroTrabajo = 0; // 0 = no se indicó '--trabajo'
+    vector<EdicionPlan> ediciones;
+    string error;
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--csv") {
+            is_csv = true;
+        } else if (arg == "--plan") {
+            mostrarPlan = true;
+        } else if (arg == "--bin" && i + 1 < argc) {
+            rutaBinaria = argv[++i];
+        } else if (arg == "--trabajo" && i + 1 < argc) {
+            if (!analizarNumeroOpcion(arg, argv[++i], numeroTrabajo, error)) {
+                cerr << error << "\n";
+                return 1;
+            }
+        } else if (origen.empty()) {
+            origen = arg;
         } else {
-            currentSubnet.hostRangeStart = "N/A";
-            currentSubnet.hostRangeEnd = "N/A";
-            currentSubnet.broadcast = intToIp(potentialSubnetBroadcast);
-        }
-        
-        printSubnetRow(os, currentSubnet, is_csv_output, subnetCounter);
-        
-        currentAllocationIp += requestedSubnetSize; // Avanza al siguiente bloque disponible
-    }
-    
-    if (!is_csv_output) { // Solo imprime esta información en consola, no en CSV
-        os << endl;
-        if (currentAllocationIp <= originalBroadcastAddress) {
-            os << "Espacio remanente sin utilizar: " << intToIp(currentAllocationIp) << " - " << intToIp(originalBroadcastAddress) << endl;
-            os << "Total de IPs remanentes: " << (originalBroadcastAddress - currentAllocationIp + 1) << endl;
+            EdicionPlan edicion;
+            if (!analizarEdicion(arg, edicion, error)) {
+                cerr << error << "\n";
+                return 1;
+            }
+            ediciones.push_back(edicion);
+        }
+    }
+    if (origen.empty() || ediciones.empty()) {
+        mostrarAyuda(cerr);
+        return 1;
+    }
+
+    PlanSubredes plan;
+    if (!cargarPlanOrigen(origen, numeroTrabajo, plan, error)) {
+        cerr << error << "\n";
+        return 1;
+    }
+    if (plan.resultado != ResultadoPlan::Correcto) {
+        imprimirPlan(cerr, plan, false);
+        return 1;
+    }
+
+    PlanificadorIncremental planificador;
+    planificador.cargar(plan);
+    vector<CambioPlan> cambios;
+    if (!planificador.aplicar(ediciones, cambios, error)) {
+        cerr << error << "\n";
+        return 1;
+    }
+    size_t sinCambios = plan.subredes.size();
+    for (const CambioPlan& c : cambios) {
+        if (c.cidrAnterior >= 0) {
+            --sinCambios; // Las agregadas no estaban en el plan de partida
+        }
+    }
+    imprimirCambios(cout, cambios, sinCambios, is_csv);
+
+    if (mostrarPlan || !rutaBinaria.empty()) {
+        planificador.obtenerPlan(plan);
+    }
+    if (mostrarPlan) {
+        imprimirPlan(cout, plan, is_csv);
+    }
+    cout.flush();
+    if (!rutaBinaria.empty()) {
+        EscritorPlanBinario escritor;
+        if (!escritor.abrir(rutaBinaria, false, error)) {
+            cerr << error << "\n";
+            return 1;
+        }
+        escritor.agregar(plan);
+        if (!escritor.cerrar(error)) {
+            cerr << error << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Modo '--resumir': agrega una lista de prefijos en el conjunto mínimo de prefijos que la cubre.
+ * Lee la entrada por bloques y analiza cada bloque en paralelo; después ordena en paralelo, fusiona
+ * en una pasada y escribe el resultado.
+ * @param argc Cantidad de argumentos de main().
+ * @param argv Argumentos de main(); argv[1] es "--resumir".
+ * @return Código de salida del programa.
+ */
+int ejecutarModoResumen(int argc, char* argv[]) {
+    string rutaEntrada = "-";
+    unsigned hilos = 0;
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--hilos" && i + 1 < argc) {
+            string error;
+            if (!analizarHilos(argv[++i], hilos, error)) {
+                cerr << error << "\n";
+                return 1;
+            }
+        } else if (rutaEntrada == "-") {
+            rutaEntrada = arg;
         } else {
-            os << "Toda la red ha sido utilizada o las solicitudes excedieron su capacidad.\n";
+            mostrarAyuda(cerr);
+            return 1;
+        }
+    }
+
+    FILE* entrada = stdin;
+    if (rutaEntrada != "-") {
+        entrada = fopen(rutaEntrada.c_str(), "rb");
+        if (!entrada) {
+            cerr << "Error: No se pudo abrir el archivo de prefijos '" << rutaEntrada << "'.\n";
+            return 1;
         }
-        os << "-------------------------------------------\n";
     }
+
+    PoolTrabajo pool(hilos);
+    vector<RangoIPv4> rangos;
+    auto inicio = chrono::steady_clock::now();
+    const ResultadoLotePrefijos total = leerPrefijos(entrada, pool, rangos);
+    if (entrada != stdin) {
+        fclose(entrada);
+    }
+    auto finLectura = chrono::steady_clock::now();
+
+    ordenarRangosParalelo(rangos, pool);
+    auto finOrden = chrono::steady_clock::now();
+    fusionarRangos(rangos);
+    const size_t escritos = escribirResumen(cout, rangos);
+    cout.flush();
+    auto fin = chrono::steady_clock::now();
+
+    auto ms = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double, milli>(b - a).count();
+    };
+    cerr << "Resumen: " << total.validos << " prefijos -> " << escritos << " prefijos en " << ms(inicio, fin)
+         << " ms (lectura " << ms(inicio, finLectura) << " ms, orden " << ms(finLectura, finOrden)
+         << " ms, fusión y escritura " << ms(finOrden, fin) << " ms, " << pool.cantidadHilos() << " hilos)\n";
+    if (total.conBitsDeHost > 0) {
+        cerr << "Advertencia: " << total.conBitsDeHost << " prefijos tenían bits de host; se usó la red que los contiene.\n";
+    }
+    if (total.invalidos > 0) {
+        cerr << "Advertencia: " << total.invalidos << " líneas no eran prefijos IPv4 válidos y se omitieron.\n";
+    }
+    return 0;
 }
 
-int main() {
-    cout << "Bienvenido a la Calculadora de Subredes!\n\n";
+/**
+ * @brief Escribe en CSV los conflictos de una subred con el inventario.
+ * @param bufer Destino.
+ * @param indice Índice del inventario.
+ * @param numeroTrabajo Número de trabajo del plan.
+ * @param subred La subred.
+ * @return Cantidad de conflictos.
+ */
+static size_t escribirConflictos(BuferSalida& bufer, const IndiceInventario& indice, long long numeroTrabajo, const Subred& subred) {
+    return indice.buscar(subred.red, subred.cidr, [&](uint32_t red, int cidr, RelacionConflicto relacion) {
+        bufer.enteroConSigno(numeroTrabajo);
+        bufer.caracter(',');
+        bufer.ipv4(subred.red);
+        bufer.caracter('/');
+        bufer.entero(subred.cidr);
+        bufer.caracter(',');
+        bufer.ipv4(red);
+        bufer.caracter('/');
+        bufer.entero(static_cast<uint64_t>(cidr));
+        bufer.caracter(',');
+        bufer.texto(nombreRelacion(relacion));
+        bufer.caracter('\n');
+    });
+}
 
-    string entradaRed;
-    cout << "Ingrese la dirección IP de la RED y la máscara (ej. 192.168.0.0/24 O 192.168.0.0 - 255.255.255.0): ";
-    getline(cin, entradaRed);
+/**
+ * @brief Modo '--conflictos': comprueba las subredes de uno o varios planes contra un inventario de prefijos.
+ * El inventario (un prefijo por línea, con el formato de '--resumir') se carga en un índice ordenado;
+ * los planes se leen de un archivo .sbp o se calculan a partir de trabajos por línea (como en el modo
+ * por lotes, desde un archivo o la entrada estándar). Cada solapamiento se escribe en cuanto se
+ * encuentra como "Trabajo,Subred,Inventario,Relacion"; las estadísticas van a la salida de error.
+ * @param argc Cantidad de argumentos de main().
+ * @param argv Argumentos de main(); argv[1] es "--conflictos".
+ * @return 0 si no hay conflictos, 1 si los hay o si hubo algún error.
+ */
+int ejecutarModoConflictos(int argc, char* argv[]) {
+    string rutaInventario;
+    string rutaPlanes = "-";
+    unsigned hilos = 0;
+    int posicionales = 0;
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--hilos" && i + 1 < argc) {
+            string error;
+            if (!analizarHilos(argv[++i], hilos, error)) {
+                cerr << error << "\n";
+                return 1;
+            }
+        } else if (posicionales == 0) {
+            rutaInventario = arg;
+            ++posicionales;
+        } else if (posicionales == 1) {
+            rutaPlanes = arg;
+            ++posicionales;
+        } else {
+            mostrarAyuda(cerr);
+            return 1;
+        }
+    }
+    if (rutaInventario.empty() || (rutaInventario == "-" && rutaPlanes == "-")) {
+        mostrarAyuda(cerr);
+        return 1;
+    }
 
-    // Eliminar espacios al inicio/final de la cadena de entrada
-    entradaRed.erase(0, entradaRed.find_first_not_of(" \t\n\r\f\v"));
-    entradaRed.erase(entradaRed.find_last_not_of(" \t\n\r\f\v") + 1);
+    FILE* entrada = stdin;
+    if (rutaInventario != "-") {
+        entrada = fopen(rutaInventario.c_str(), "rb");
+        if (!entrada) {
+            cerr << "Error: No se pudo abrir el archivo de inventario '" << rutaInventario << "'.\n";
+            return 1;
+        }
+    }
+    auto inicio = chrono::steady_clock::now();
+    IndiceInventario indice;
+    ResultadoLotePrefijos inventario;
+    {
+        PoolTrabajo pool(hilos);
+        vector<RangoIPv4> rangos;
+        inventario = leerPrefijos(entrada, pool, rangos);
+        indice.construir(rangos, pool);
+    }
+    if (entrada != stdin) {
+        fclose(entrada);
+    }
+    auto finIndice = chrono::steady_clock::now();
+    if (inventario.invalidos > 0) {
+        cerr << "Advertencia: " << inventario.invalidos << " líneas del inventario no eran prefijos IPv4 válidos y se omitieron.\n";
+    }
+
+    size_t planes = 0;
+    size_t subredes = 0;
+    size_t conflictos = 0;
+    int codigo = 0;
+    {
+        BuferSalida bufer(cout);
+        bufer.texto("Trabajo,Subred,Inventario,Relacion\n");
+        if (esRutaPlanBinario(rutaPlanes)) {
+            LectorPlanBinario lector;
+            string error;
+            if (!lector.abrir(rutaPlanes, error)) {
+                cerr << error << "\n";
+                return 1;
+            }
+            for (size_t i = 0; i < lector.cantidadPlanes(); ++i) {
+                const long long numeroTrabajo = lector.esLote() ? lector.entrada(i).numeroTrabajo : static_cast<long long>(i + 1);
+                for (const Subred& subred : lector.subredesDe(i)) {
+                    conflictos += escribirConflictos(bufer, indice, numeroTrabajo, subred);
+                }
+            }
+            planes = lector.cantidadPlanes();
+            subredes = lector.cantidadRegistros();
+        } else {
+            ifstream archivo;
+            if (rutaPlanes != "-") {
+                archivo.open(rutaPlanes);
+                if (!archivo.is_open()) {
+                    cerr << "Error: No se pudo abrir el archivo de trabajos '" << rutaPlanes << "'.\n";
+                    return 1;
+                }
+            }
+            istream& in = rutaPlanes != "-" ? static_cast<istream&>(archivo) : cin;
+            string linea;
+            string ipBaseStr;
+            int cidrBase = -1;
+            vector<int> requestedHostCounts;
+            vector<RangoIPv4> reservados;
+            PlanSubredes plan;
+            string error;
+            long long numeroLinea = 0;
+            while (getline(in, linea)) {
+                ++numeroLinea;
+                size_t comentario = linea.find('#');
+                if (comentario != string::npos) {
+                    linea.erase(comentario);
+                }
+                if (linea.find_first_not_of(" \t\r,") == string::npos) {
+                    continue; // Línea vacía o solo comentario
+                }
+                if (!analizarTrabajo(linea, ipBaseStr, cidrBase, requestedHostCounts, reservados, error)) {
+                    cerr << "Línea " << numeroLinea << ": " << error << '\n';
+                    codigo = 1;
+                    continue;
+                }
+                ++planes;
+                planificarSubredes(plan, ipBaseStr, cidrBase, requestedHostCounts, reservados);
+                for (const Subred& subred : plan.subredes) {
+                    conflictos += escribirConflictos(bufer, indice, static_cast<long long>(planes), subred);
+                }
+                subredes += plan.subredes.size();
+            }
+        }
+    }
+    cout.flush();
+    auto fin = chrono::steady_clock::now();
+
+    auto ms = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double, milli>(b - a).count();
+    };
+    cerr << "Inventario: " << indice.cantidadPrefijos() << " prefijos distintos, índice en " << ms(inicio, finIndice) << " ms\n"
+         << "Comprobación: " << subredes << " subredes de " << planes << " planes en " << ms(finIndice, fin) << " ms, "
+         << conflictos << " conflictos\n";
+    return conflictos > 0 ? 1 : codigo;
+}
+
+/**
+ * @brief Plan cargado en el servidor con 'cargar', con su índice de búsqueda.
+ */
+struct PlanCargadoServidor {
+    TablaLPM tabla;
+    vector<string> etiquetas; // "RED/CIDR" de cada subred
+};
 
+/**
+ * @brief Memoria propia de cada hilo del servidor, reutilizada entre peticiones.
+ */
+struct EstadoHiloServidor {
     string ipBaseStr;
-    int cidrBase = -1; // Valor predeterminado para CIDR inválido
+    int cidrBase = -1;
+    vector<int> requestedHostCounts;
+    vector<RangoIPv4> reservados;
+    PlanSubredes plan;
+    string error;
+    ostringstream salida;
+    ImpresorPlan impresor;
 
-    // Intentar analizar la entrada como formato IP/CIDR primero
-    size_t slash_pos = entradaRed.find('/');
-    if (slash_pos != string::npos) {
-        ipBaseStr = entradaRed.substr(0, slash_pos);
-        string cidrStr = entradaRed.substr(slash_pos + 1);
-        try {
-            cidrBase = stoi(cidrStr);
-            if (cidrBase < 0 || cidrBase > 32) {
-                cout << "Error: El prefijo CIDR debe estar entre 0 y 32.\n";
-                #ifdef _WIN32
-                    system("pause"); 
-                #endif
+    EstadoHiloServidor() { impresor.agregarDestino(salida, FormatoSalida::CSV); }
+};
+
+/**
+ * @brief Separa el comando de una petición del servidor de sus argumentos.
+ * @param linea La petición.
+ * @param argumentos Recibe el resto de la línea, sin los espacios iniciales.
+ * @return El comando.
+ */
+static string_view comandoServidor(string_view linea, string_view& argumentos) {
+    const size_t inicio = linea.find_first_not_of(" \t");
+    if (inicio == string_view::npos) {
+        argumentos = string_view();
+        return string_view();
+    }
+    size_t fin = linea.find_first_of(" \t", inicio);
+    if (fin == string_view::npos) {
+        fin = linea.size();
+    }
+    const size_t inicioArgumentos = min(linea.size(), linea.find_first_not_of(" \t", fin));
+    argumentos = linea.substr(inicioArgumentos);
+    return linea.substr(inicio, fin - inicio);
+}
+
+/**
+ * @brief Atiende una petición 'plan' o 'buscar' (las que no modifican el estado del servidor).
+ * @param peticion La petición; recibe su respuesta.
+ * @param estado Memoria del hilo que la atiende.
+ * @param cargado Plan cargado, o nulo si no se ha cargado ninguno.
+ */
+static void atenderPeticionServidor(PeticionServidor& peticion, EstadoHiloServidor& estado, const PlanCargadoServidor* cargado) {
+    string_view argumentos;
+    const string_view comando = comandoServidor(peticion.linea, argumentos);
+    if (comando == "plan") {
+        if (!analizarTrabajo(string(argumentos), estado.ipBaseStr, estado.cidrBase, estado.requestedHostCounts,
+                             estado.reservados, estado.error)) {
+            responderError(peticion.respuesta, estado.error);
+            return;
+        }
+        planificarSubredes(estado.plan, estado.ipBaseStr, estado.cidrBase, estado.requestedHostCounts, estado.reservados);
+        // El CSV no tiene dónde indicar un plan inválido ni las solicitudes no asignadas: la petición falla
+        if (estado.plan.resultado != ResultadoPlan::Correcto) {
+            responderError(peticion.respuesta, describirErrorPlan(estado.plan));
+            return;
+        }
+        if (!estado.plan.fallidas.empty()) {
+            responderError(peticion.respuesta, "Error: " + to_string(estado.plan.fallidas.size()) + " solicitudes no asignadas; la primera: " +
+                                                   describirFallo(estado.plan.fallidas.front(), estado.plan.cidrBase));
+            return;
+        }
+        estado.salida.str(string());
+        estado.impresor.imprimir(estado.plan);
+        responderCorrecto(peticion.respuesta, estado.salida.str());
+    } else if (comando == "buscar") {
+        if (!cargado) {
+            responderError(peticion.respuesta, "Error: No hay ningún plan cargado (use 'cargar TRABAJO').");
+            return;
+        }
+        string& datos = estado.error; // Se reutiliza como búfer de la respuesta
+        datos.clear();
+        string_view resto;
+        string_view ip = comandoServidor(argumentos, resto);
+        if (ip.empty()) {
+            responderError(peticion.respuesta, "Error: Falta la dirección a buscar.");
+            return;
+        }
+        for (; !ip.empty(); ip = comandoServidor(resto, resto)) {
+            uint32_t direccion;
+            if (parseIPv4(ip, direccion) != ErrorIPv4::Ninguno) {
+                responderError(peticion.respuesta, "Error: La dirección '" + string(ip) + "' no es válida.");
+                return;
+            }
+            const uint32_t posicion = cargado->tabla.buscar(direccion);
+            datos.append(ip.data(), ip.size());
+            datos += ',';
+            if (posicion == TablaLPM::SIN_COINCIDENCIA) {
+                datos += '-';
+            } else {
+                datos += cargado->etiquetas[posicion];
+            }
+            datos += '\n';
+        }
+        responderCorrecto(peticion.respuesta, datos);
+    } else {
+        responderError(peticion.respuesta, "Error: Petición desconocida ('" + string(comando) + "'); use plan, cargar o buscar.");
+    }
+}
+
+/**
+ * @brief Modo '--servidor': atiende peticiones de planificación y de búsqueda por un socket.
+ * Las peticiones de cada lote se reparten entre los hilos del pool; una petición 'cargar' divide
+ * el lote, para que las búsquedas anteriores usen el plan anterior y las siguientes, el nuevo.
+ * @param argc Cantidad de argumentos de main().
+ * @param argv Argumentos de main(); argv[1] es "--servidor".
+ * @return Código de salida del programa.
+ */
+int ejecutarModoServidor(int argc, char* argv[]) {
+    string direccion;
+    unsigned hilos = 0;
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--hilos" && i + 1 < argc) {
+            string error;
+            if (!analizarHilos(argv[++i], hilos, error)) {
+                cerr << error << "\n";
                 return 1;
             }
-        } catch (const invalid_argument& e) {
-            cout << "Error: El prefijo CIDR no es un número válido.\n";
-            #ifdef _WIN32
-                system("pause"); 
-            #endif
+        } else if (direccion.empty()) {
+            direccion = arg;
+        } else {
+            mostrarAyuda(cerr);
             return 1;
-        } catch (const out_of_range& e) {
-            cout << "Error: El prefijo CIDR está fuera de rango.\n";
-            #ifdef _WIN32
-                system("pause"); 
-            #endif
+        }
+    }
+    if (direccion.empty()) {
+        mostrarAyuda(cerr);
+        return 1;
+    }
+
+    ServidorLineas servidor;
+    string error;
+    if (!servidor.escuchar(direccion, error)) {
+        cerr << error << "\n";
+        return 1;
+    }
+    PoolTrabajo pool(hilos);
+    vector<unique_ptr<EstadoHiloServidor>> estados;
+    for (unsigned h = 0; h < pool.cantidadHilos(); ++h) {
+        estados.emplace_back(new EstadoHiloServidor());
+    }
+    unique_ptr<PlanCargadoServidor> cargado;
+    cerr << "Servidor escuchando en " << direccion << " (" << pool.cantidadHilos() << " hilos)\n";
+
+    auto cargar = [&](PeticionServidor& peticion, string_view argumentos) {
+        EstadoHiloServidor& estado = *estados[0];
+        if (!analizarTrabajo(string(argumentos), estado.ipBaseStr, estado.cidrBase, estado.requestedHostCounts,
+                             estado.reservados, estado.error)) {
+            responderError(peticion.respuesta, estado.error);
+            return;
+        }
+        planificarSubredes(estado.plan, estado.ipBaseStr, estado.cidrBase, estado.requestedHostCounts, estado.reservados);
+        if (estado.plan.resultado != ResultadoPlan::Correcto) {
+            responderError(peticion.respuesta, describirErrorPlan(estado.plan) + " (se conserva el plan cargado)");
+            return;
+        }
+        unique_ptr<PlanCargadoServidor> nuevo(new PlanCargadoServidor());
+        vector<BloqueIPv4> bloques;
+        for (const Subred& subnet : estado.plan.subredes) {
+            bloques.push_back({subnet.red, subnet.cidr});
+            nuevo->etiquetas.push_back(intToIp(subnet.red) + "/" + to_string(subnet.cidr));
+        }
+        nuevo->tabla.construir(bloques);
+        cargado = move(nuevo);
+        responderCorrecto(peticion.respuesta, to_string(bloques.size()) + " subredes\n");
+    };
+
+    auto atenderLote = [&](vector<PeticionServidor>& lote) {
+        size_t inicio = 0;
+        while (inicio < lote.size()) {
+            // Tramo de peticiones hasta la siguiente 'cargar' (exclusive)
+            size_t fin = inicio;
+            string_view argumentos;
+            while (fin < lote.size() && comandoServidor(lote[fin].linea, argumentos) != "cargar") {
+                ++fin;
+            }
+            const PlanCargadoServidor* actual = cargado.get();
+            if (fin - inicio == 1 || pool.cantidadHilos() == 1) {
+                // Una sola petición se atiende en este hilo: despertar al pool costaría más que ella
+                for (size_t i = inicio; i < fin; ++i) {
+                    atenderPeticionServidor(lote[i], *estados[0], actual);
+                }
+            } else if (fin > inicio) {
+                pool.paraCada(fin - inicio, [&](size_t i, unsigned hilo) {
+                    atenderPeticionServidor(lote[inicio + i], *estados[hilo], actual);
+                });
+            }
+            if (fin < lote.size()) {
+                comandoServidor(lote[fin].linea, argumentos);
+                cargar(lote[fin], argumentos);
+                ++fin;
+            }
+            inicio = fin;
+        }
+    };
+
+    const bool porSenal = servidor.ejecutar(atenderLote, error);
+    cerr << "Servidor detenido: " << servidor.peticionesAtendidas() << " peticiones en " << servidor.lotesAtendidos()
+         << " lotes, " << servidor.conexionesAceptadas() << " conexiones\n";
+    if (!porSenal) {
+        cerr << error << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Modo '--enumerar': escribe todas las direcciones de host utilizables de un plan (o de una
+ * de sus subredes), una por línea. ORIGEN es un TRABAJO o un archivo .sbp, como en '--replanificar'.
+ * Las direcciones se formatean por tramos con formatearIPv4Consecutivas() en un búfer grande que se
+ * entrega al destino con fwrite; por la salida de error se informa de la cantidad y el ritmo.
+ * @param argc Cantidad de argumentos de main().
+ * @param argv Argumentos de main(); argv[1] es "--enumerar".
+ * @return Código de salida del programa.
+ */
+int ejecutarModoEnumeracion(int argc, char* argv[]) {
+    string origen;
+    string rutaSalida;
+    size_t numeroTrabajo = 0; // 0 = no se indicó '--trabajo'
+    size_t numeroSubred = 0; // 0 = todas
+    string error;
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        if ((arg == "--trabajo" || arg == "--subred") && i + 1 < argc) {
+            if (!analizarNumeroOpcion(arg, argv[++i], arg == "--trabajo" ? numeroTrabajo : numeroSubred, error)) {
+                cerr << error << "\n";
+                return 1;
+            }
+        } else if (arg == "--salida" && i + 1 < argc) {
+            rutaSalida = argv[++i];
+        } else if (origen.empty()) {
+            origen = arg;
+        } else {
+            mostrarAyuda(cerr);
             return 1;
         }
-    } else { // Si no es IP/CIDR, intenta el formato IP - Máscara decimal
-        size_t dash_pos = entradaRed.find(" - ");
-        if (dash_pos == string::npos) {
-            cout << "Error: Formato de entrada de red inválido. Use 'IP/CIDR' o 'IP - Máscara Decimal'.\n";
-            #ifdef _WIN32
-                system("pause"); 
-            #endif
+    }
+    if (origen.empty()) {
+        mostrarAyuda(cerr);
+        return 1;
+    }
+
+    PlanSubredes plan;
+    if (!cargarPlanOrigen(origen, numeroTrabajo, plan, error)) {
+        cerr << error << "\n";
+        return 1;
+    }
+    // Un plan inválido no se enumera; uno con solicitudes no asignadas sí, pero se avisa y el código es 1
+    if (plan.resultado != ResultadoPlan::Correcto) {
+        cerr << describirErrorPlan(plan) << "\n";
+        return 1;
+    }
+    const bool conFallidas = !plan.fallidas.empty();
+    if (conFallidas) {
+        informarProblemasPlan(cerr, plan, "Aviso");
+    }
+    VistaSubredes subredes = {plan.subredes.data(), plan.subredes.data() + plan.subredes.size()};
+    if (numeroSubred > subredes.size()) {
+        cerr << "Error: El plan no tiene la subred " << numeroSubred << " (tiene " << subredes.size() << ").\n";
+        return 1;
+    }
+    if (numeroSubred > 0) {
+        subredes = {subredes.inicio + numeroSubred - 1, subredes.inicio + numeroSubred};
+    }
+
+    FILE* salida = stdout;
+    if (!rutaSalida.empty() && rutaSalida != "-") {
+        salida = fopen(rutaSalida.c_str(), "wb");
+        if (!salida) {
+            cerr << "Error: No se pudo abrir el archivo de salida '" << rutaSalida << "'.\n";
             return 1;
         }
-        ipBaseStr = entradaRed.substr(0, dash_pos);
-        string maskDecimalStr = entradaRed.substr(dash_pos + 3); // +3 para saltar " - "
-        cidrBase = maskToCidr(maskDecimalStr);
-        if (cidrBase == -1) {
-            cout << "Error: La máscara de subred ('" << maskDecimalStr << "') no es válida o no es una máscara binaria continua.\n";
-            #ifdef _WIN32
-                system("pause"); 
-            #endif
+    }
+
+    // Cada dirección ocupa como mucho 16 bytes en el búfer (15 + '\n')
+    const uint32_t DIRECCIONES_POR_TRAMO = 1 << 18;
+    vector<char> bufer(size_t(DIRECCIONES_POR_TRAMO) * 16);
+    uint64_t direcciones = 0;
+    uint64_t bytes = 0;
+    bool correcto = true;
+    auto inicio = chrono::steady_clock::now();
+    for (const Subred& subnet : subredes) {
+        uint64_t pendientes = subnet.hostsUtilizables(); // /31 y /32 no tienen hosts utilizables
+        uint32_t siguiente = subnet.primerHost();
+        while (pendientes > 0 && correcto) {
+            const uint32_t cantidad = static_cast<uint32_t>(min<uint64_t>(pendientes, DIRECCIONES_POR_TRAMO));
+            const char* fin = formatearIPv4Consecutivas(bufer.data(), siguiente, cantidad);
+            const size_t longitud = static_cast<size_t>(fin - bufer.data());
+            correcto = fwrite(bufer.data(), 1, longitud, salida) == longitud;
+            bytes += longitud;
+            direcciones += cantidad;
+            siguiente += cantidad;
+            pendientes -= cantidad;
+        }
+    }
+    correcto = fflush(salida) == 0 && correcto;
+    if (salida != stdout) {
+        correcto = fclose(salida) == 0 && correcto;
+    }
+    if (!correcto) {
+        cerr << "Error: No se pudo escribir la salida.\n";
+        return 1;
+    }
+
+    const double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    cerr << "Enumeración: " << direcciones << " direcciones de " << subredes.size() << " subredes, " << bytes
+         << " bytes en " << segundos * 1e3 << " ms";
+    if (segundos > 0) {
+        cerr << " (" << static_cast<double>(bytes) / segundos / 1e9 << " GB/s)";
+    }
+    cerr << "\n";
+    return conFallidas ? 1 : 0;
+}
+
+/**
+ * @brief Modo '--utilizacion': analiza la ocupación de la red base de un plan (subredes y reservados)
+ * con un MapaOcupacion. ORIGEN es un TRABAJO o un archivo .sbp, como en '--replanificar'; por la
+ * salida de error se informa del tiempo del análisis.
+ * @param argc Cantidad de argumentos de main().
+ * @param argv Argumentos de main(); argv[1] es "--utilizacion".
+ * @return Código de salida del programa.
+ */
+int ejecutarModoUtilizacion(int argc, char* argv[]) {
+    string origen;
+    bool is_csv = false;
+    size_t numeroTrabajo = 0; // 0 = no se indicó '--trabajo'
+    string error;
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--csv") {
+            is_csv = true;
+        } else if (arg == "--trabajo" && i + 1 < argc) {
+            if (!analizarNumeroOpcion(arg, argv[++i], numeroTrabajo, error)) {
+                cerr << error << "\n";
+                return 1;
+            }
+        } else if (origen.empty()) {
+            origen = arg;
+        } else {
+            mostrarAyuda(cerr);
             return 1;
         }
     }
+    if (origen.empty()) {
+        mostrarAyuda(cerr);
+        return 1;
+    }
 
-    // Validar el formato de la dirección IP base por sí misma, independientemente del estilo de entrada
-    uint32_t ipBaseNum = ipToInt(ipBaseStr);
-    if (ipBaseNum == 0 && ipBaseStr != "0.0.0.0") { 
-        cout << "Error: La dirección IP de base ('" << ipBaseStr << "') no es válida o está fuera de rango.\n";
+    PlanSubredes plan;
+    if (!cargarPlanOrigen(origen, numeroTrabajo, plan, error)) {
+        cerr << error << "\n";
+        return 1;
+    }
+    if (plan.resultado != ResultadoPlan::Correcto) {
+        imprimirPlan(cerr, plan, false);
+        return 1;
+    }
+
+    AnalisisUtilizacion analisis;
+    auto inicio = chrono::steady_clock::now();
+    analizarUtilizacion(plan, analisis);
+    const double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    imprimirUtilizacion(cout, analisis, is_csv);
+    cerr << "Análisis: " << plan.subredes.size() << " subredes y " << plan.reservados.size() << " rangos reservados en "
+         << segundos * 1e3 << " ms\n";
+    return 0;
+}
+
+/**
+ * @brief Modo '--ipv6': divide una red IPv6 según las solicitudes y muestra el plan.
+ * @param argc Cantidad de argumentos de main().
+ * @param argv Argumentos de main(); argv[1] es "--ipv6".
+ * @return Código de salida del programa.
+ */
+int ejecutarModoIPv6(int argc, char* argv[]) {
+    // Límite de subredes de un plan, para no agotar la memoria con un "xN" enorme
+    const uint64_t MAX_SUBREDES_IPV6 = 1u << 24;
+
+    bool is_csv = false;
+    vector<string> argumentos;
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--csv") {
+            is_csv = true;
+        } else {
+            argumentos.push_back(arg);
+        }
+    }
+    if (argumentos.size() < 2) {
+        mostrarAyuda(cerr);
+        return 1;
+    }
+
+    uint128_t redBase;
+    int cidrBase;
+    string error;
+    if (!analizarRedIPv6(argumentos[0], redBase, cidrBase, error)) {
+        cerr << error << "\n";
+        return 1;
+    }
+    vector<SolicitudIPv6> solicitudes;
+    uint64_t total = 0;
+    for (size_t i = 1; i < argumentos.size(); ++i) {
+        SolicitudIPv6 solicitud;
+        if (!analizarSolicitudIPv6(argumentos[i], solicitud, error)) {
+            cerr << error << "\n";
+            return 1;
+        }
+        total += solicitud.cantidad;
+        if (solicitud.cantidad > MAX_SUBREDES_IPV6 || total > MAX_SUBREDES_IPV6) {
+            cerr << "Error: Demasiadas subredes solicitadas (el máximo es " << MAX_SUBREDES_IPV6 << ").\n";
+            return 1;
+        }
+        solicitudes.push_back(solicitud);
+    }
+
+    PlanSubredesIPv6 plan;
+    planificarSubredesIPv6(plan, redBase, cidrBase, solicitudes);
+    imprimirPlanIPv6(cout, plan, is_csv);
+    cout.flush();
+    return 0;
+}
+
+/** @brief Formato del informe de --stats. */
+static bool estadisticasJSON = false;
+
+/** @brief Escribe el informe de --stats al terminar el programa (registrada con atexit). */
+static void escribirEstadisticasAlSalir() {
+    escribirInformeInstrumentacion(cerr, estadisticasJSON);
+}
+
+int main(int argc, char* argv[]) {
+    // --stats acompaña a cualquier modo: se quita de los argumentos y el informe se escribe al salir
+    int restantes = 1;
+    bool estadisticas = false;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--stats" || arg == "--stats=json") {
+            estadisticas = true;
+            estadisticasJSON = arg == "--stats=json";
+        } else {
+            argv[restantes++] = argv[i];
+        }
+    }
+    argc = restantes;
+    argv[argc] = nullptr;
+    if (estadisticas) {
+        activarInstrumentacion();
+        atexit(escribirEstadisticasAlSalir);
+    }
+
+    if (argc > 1) {
+        string opcion = argv[1];
+        if (opcion == "--ayuda" || opcion == "-h" || opcion == "--help") {
+            mostrarAyuda(cout);
+            return 0;
+        }
+        if (opcion == "--lote") {
+            return ejecutarLineaDeComandosLote(argc, argv);
+        }
+        if (opcion == "--ipam") {
+            return ejecutarModoIPAM(argc, argv);
+        }
+        if (opcion == "--buscar") {
+            return ejecutarModoBusqueda(argc, argv);
+        }
+        if (opcion == "--convertir") {
+            return ejecutarModoConversion(argc, argv);
+        }
+        if (opcion == "--dimensionar") {
+            return ejecutarModoDimensionado(argc, argv);
+        }
+        if (opcion == "--replanificar") {
+            return ejecutarModoReplanificacion(argc, argv);
+        }
+        if (opcion == "--resumir") {
+            return ejecutarModoResumen(argc, argv);
+        }
+        if (opcion == "--conflictos") {
+            return ejecutarModoConflictos(argc, argv);
+        }
+        if (opcion == "--servidor") {
+            return ejecutarModoServidor(argc, argv);
+        }
+        if (opcion == "--enumerar") {
+            return ejecutarModoEnumeracion(argc, argv);
+        }
+        if (opcion == "--utilizacion") {
+            return ejecutarModoUtilizacion(argc, argv);
+        }
+        if (opcion == "--ipv6") {
+            return ejecutarModoIPv6(argc, argv);
+        }
+        mostrarAyuda(cerr);
+        return 1;
+    }
+
+    cout << "Bienvenido a la Calculadora de Subredes!\n\n";
+
+    string entradaRed;
+    cout << "Ingrese la dirección IP de la RED y la máscara (ej. 192.168.0.0/24 O 192.168.0.0 - 255.255.255.0): ";
+    getline(cin, entradaRed);
+
+    // Eliminar espacios al inicio/final de la cadena de entrada
+    entradaRed.erase(0, entradaRed.find_first_not_of(" \t\n\r\f\v"));
+    entradaRed.erase(entradaRed.find_last_not_of(" \t\n\r\f\v") + 1);
+
+    string ipBaseStr;
+    int cidrBase = -1; // Valor predeterminado para CIDR inválido
+    string error;
+
+    if (!analizarRed(entradaRed, ipBaseStr, cidrBase, error)) {
+        cout << error << "\n";
         #ifdef _WIN32
             system("pause"); 
         #endif
@@ -489,8 +1978,10 @@ int main() {
         cin.ignore(numeric_limits<streamsize>::max(), '\n'); 
     }
 
-    // Calcular y mostrar en consola
-    calcularSubredes(cout, ipBaseStr, cidrBase, requestedHostCounts, false);
+    // Calcular una sola vez y mostrar en consola; la exportación reutiliza el mismo plan
+    PlanSubredes plan;
+    planificarSubredes(plan, ipBaseStr, cidrBase, requestedHostCounts);
+    imprimirPlan(cout, plan, false);
 
     string exportOption;
     cout << "\n¿Desea exportar los resultados a un archivo? (s/n): ";
@@ -500,19 +1991,34 @@ int main() {
 
     if (exportOption == "s" || exportOption == "si") {
         string filename;
-        cout << "Ingrese el nombre del archivo (ej. resultados.txt o resultados.csv): ";
+        cout << "Ingrese el nombre del archivo (ej. resultados.txt, resultados.csv o resultados.sbp): ";
         getline(cin, filename);
 
-        // Determinar si la exportación debe ser CSV
+        // Determinar si la exportación debe ser CSV o binaria
         bool is_csv = (filename.length() >= 4 && filename.substr(filename.length() - 4) == ".csv");
+        bool is_binario = esRutaPlanBinario(filename);
 
-        ofstream outFile(filename);
-        if (outFile.is_open()) {
-            calcularSubredes(outFile, ipBaseStr, cidrBase, requestedHostCounts, is_csv);
-            outFile.close();
-            cout << "Resultados exportados exitosamente a '" << filename << "'.\n";
+        if (is_binario) {
+            EscritorPlanBinario escritor;
+            bool exportado = escritor.abrir(filename, false, error);
+            if (exportado) {
+                escritor.agregar(plan);
+                exportado = escritor.cerrar(error);
+            }
+            if (exportado) {
+                cout << "Resultados exportados exitosamente a '" << filename << "'.\n";
+            } else {
+                cout << error << "\n";
+            }
         } else {
-            cout << "Error: No se pudo abrir el archivo para escribir. Verifique los permisos o la ruta.\n";
+            ofstream outFile(filename);
+            if (outFile.is_open()) {
+                imprimirPlan(outFile, plan, is_csv);
+                outFile.close();
+                cout << "Resultados exportados exitosamente a '" << filename << "'.\n";
+            } else {
+                cout << "Error: No se pudo abrir el archivo para escribir. Verifique los permisos o la ruta.\n";
+            }
         }
     }
 
@@ -0,0 +1,186 @@
+#ifndef CALCULO_SUBRED_H
+#define CALCULO_SUBRED_H
+
+#include <array>    // Para std::array
+#include <cstdint>  // Para uint32_t, uint64_t
+
+/**
+ * @file calculo_subred.h
+ * @brief Aritmética de subredes IPv4 solo con enteros, evaluable en tiempo de compilación.
+ *
+ * Biblioteca de solo cabecera: no depende del resto de la calculadora y puede incluirse desde otros
+ * programas sin enlazar nada. Todas las funciones son constexpr, de modo que un plan de direcciones
+ * fijo puede validarse con static_assert (ver los ejemplos al final del archivo).
+ */
+
+/**
+ * @brief Dirección IPv4 (tipo fuerte: no se mezcla por error con un prefijo o una cantidad).
+ */
+struct DireccionIPv4 {
+    uint32_t valor = 0;
+
+    constexpr DireccionIPv4() = default;
+    constexpr explicit DireccionIPv4(uint32_t v) : valor(v) {}
+    /** @brief Construye la dirección a.b.c.d. */
+    constexpr DireccionIPv4(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+        : valor((uint32_t(a) << 24) | (uint32_t(b) << 16) | (uint32_t(c) << 8) | uint32_t(d)) {}
+
+    constexpr bool operator==(DireccionIPv4 o) const { return valor == o.valor; }
+    constexpr bool operator!=(DireccionIPv4 o) const { return valor != o.valor; }
+    constexpr bool operator<(DireccionIPv4 o) const { return valor < o.valor; }
+    constexpr bool operator<=(DireccionIPv4 o) const { return valor <= o.valor; }
+};
+
+/**
+ * @brief Longitud de prefijo IPv4 (0-32). Los valores fuera de rango se limitan a 32.
+ */
+struct PrefijoIPv4 {
+    uint8_t bits = 32;
+
+    constexpr PrefijoIPv4() = default;
+    constexpr explicit PrefijoIPv4(int b) : bits(static_cast<uint8_t>(b < 0 ? 0 : (b > 32 ? 32 : b))) {}
+
+    constexpr bool operator==(PrefijoIPv4 o) const { return bits == o.bits; }
+    constexpr bool operator!=(PrefijoIPv4 o) const { return bits != o.bits; }
+};
+
+namespace detalle_subred {
+
+/** @brief Cuenta los ceros a la izquierda de un entero de 64 bits (64 si es 0). */
+constexpr int cerosIzquierda64(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return v == 0 ? 64 : __builtin_clzll(v);
+#else
+    int n = 0;
+    if (v == 0) return 64;
+    if ((v >> 32) == 0) { n += 32; v <<= 32; }
+    if ((v >> 48) == 0) { n += 16; v <<= 16; }
+    if ((v >> 56) == 0) { n += 8; v <<= 8; }
+    if ((v >> 60) == 0) { n += 4; v <<= 4; }
+    if ((v >> 62) == 0) { n += 2; v <<= 2; }
+    if ((v >> 63) == 0) { n += 1; }
+    return n;
+#endif
+}
+
+/** @brief Tabla de las 33 máscaras posibles, indexada por prefijo. */
+constexpr std::array<uint32_t, 33> crearTablaMascaras() {
+    std::array<uint32_t, 33> tabla{};
+    for (int cidr = 1; cidr <= 32; ++cidr) {
+        tabla[static_cast<size_t>(cidr)] = ~uint32_t(0) << (32 - cidr);
+    }
+    return tabla;
+}
+
+constexpr std::array<uint32_t, 33> TABLA_MASCARAS = crearTablaMascaras();
+
+} // namespace detalle_subred
+
+/**
+ * @brief Máscara de un prefijo (ej. /24 -> 0xFFFFFF00).
+ */
+constexpr uint32_t mascaraDePrefijo(PrefijoIPv4 prefijo) {
+    return detalle_subred::TABLA_MASCARAS[prefijo.bits];
+}
+
+/**
+ * @brief Prefijo de una máscara continua.
+ * @return El prefijo (0-32), o -1 si la máscara tiene un 1 después de un 0 (ej. 255.0.255.0).
+ */
+constexpr int prefijoDeMascara(uint32_t mascara) {
+    const uint32_t invertida = ~mascara;
+    if ((invertida & (invertida + 1)) != 0) {
+        return -1;
+    }
+    // En una máscara continua, los ceros a la izquierda del complemento son los bits del prefijo
+    return detalle_subred::cerosIzquierda64(invertida) - 32;
+}
+
+/**
+ * @brief Cantidad de direcciones de un bloque (2^(32 - prefijo); 2^32 para /0).
+ */
+constexpr uint64_t tamanoBloque(PrefijoIPv4 prefijo) {
+    return uint64_t(1) << (32 - prefijo.bits);
+}
+
+/**
+ * @brief Prefijo del bloque más pequeño que contiene un número de hosts más red y broadcast.
+ * Equivale a 32 - ceil(log2(hosts + 2)), calculado con un conteo de ceros a la izquierda.
+ * @return El prefijo (0 si ni siquiera un /0 alcanza; 32 para 0 hosts).
+ */
+constexpr PrefijoIPv4 prefijoParaHosts(uint64_t hosts) {
+    if (hosts == 0) {
+        return PrefijoIPv4(32); // /32: una dirección, sin hosts utilizables
+    }
+    if (hosts >= (uint64_t(1) << 32) - 2) {
+        return PrefijoIPv4(0); // Ni un /0 alcanza (y hosts + 2 desbordaría cerca de UINT64_MAX)
+    }
+    const uint64_t direcciones = hosts + 2;
+    const int bits = 64 - detalle_subred::cerosIzquierda64(direcciones - 1); // ceil(log2(direcciones))
+    return PrefijoIPv4(32 - bits);
+}
+
+/**
+ * @brief Dirección de red que contiene a una dirección.
+ */
+constexpr DireccionIPv4 redDe(DireccionIPv4 direccion, PrefijoIPv4 prefijo) {
+    return DireccionIPv4(direccion.valor & mascaraDePrefijo(prefijo));
+}
+
+/**
+ * @brief Dirección de broadcast (última dirección) del bloque que contiene a una dirección.
+ */
+constexpr DireccionIPv4 broadcastDe(DireccionIPv4 direccion, PrefijoIPv4 prefijo) {
+    return DireccionIPv4(direccion.valor | ~mascaraDePrefijo(prefijo));
+}
+
+/**
+ * @brief Indica si una dirección es la dirección de red de un bloque de ese prefijo.
+ */
+constexpr bool estaAlineada(DireccionIPv4 direccion, PrefijoIPv4 prefijo) {
+    return (direccion.valor & ~mascaraDePrefijo(prefijo)) == 0;
+}
+
+/**
+ * @brief Cantidad de hosts utilizables de un bloque (sin red ni broadcast; 0 para /31 y /32).
+ */
+constexpr uint64_t hostsUtilizablesDe(PrefijoIPv4 prefijo) {
+    return prefijo.bits < 31 ? tamanoBloque(prefijo) - 2 : 0;
+}
+
+/**
+ * @brief Indica si el bloque (interior, prefijoInterior) está contenido en (exterior, prefijoExterior).
+ */
+constexpr bool contieneBloque(DireccionIPv4 exterior, PrefijoIPv4 prefijoExterior,
+                              DireccionIPv4 interior, PrefijoIPv4 prefijoInterior) {
+    return prefijoInterior.bits >= prefijoExterior.bits &&
+           redDe(interior, prefijoExterior) == redDe(exterior, prefijoExterior);
+}
+
+/**
+ * @brief Indica si dos bloques se superponen (en bloques alineados, uno contiene al otro).
+ */
+constexpr bool seSuperponen(DireccionIPv4 a, PrefijoIPv4 prefijoA, DireccionIPv4 b, PrefijoIPv4 prefijoB) {
+    return contieneBloque(a, prefijoA, b, prefijoB) || contieneBloque(b, prefijoB, a, prefijoA);
+}
+
+// Comprobaciones en tiempo de compilación (también sirven de ejemplo de uso)
+static_assert(mascaraDePrefijo(PrefijoIPv4(0)) == 0, "/0");
+static_assert(mascaraDePrefijo(PrefijoIPv4(24)) == 0xFFFFFF00u, "/24");
+static_assert(mascaraDePrefijo(PrefijoIPv4(32)) == 0xFFFFFFFFu, "/32");
+static_assert(prefijoDeMascara(0xFFFFFF00u) == 24 && prefijoDeMascara(0) == 0 && prefijoDeMascara(0xFF00FF00u) == -1,
+              "prefijoDeMascara");
+static_assert(prefijoParaHosts(0).bits == 32 && prefijoParaHosts(1).bits == 30 && prefijoParaHosts(2).bits == 30 &&
+              prefijoParaHosts(3).bits == 29 && prefijoParaHosts(254).bits == 24 && prefijoParaHosts(255).bits == 23,
+              "prefijoParaHosts");
+static_assert(prefijoParaHosts(0xFFFFFFFEull).bits == 0 && prefijoParaHosts(0xFFFFFFFFull).bits == 0 &&
+              prefijoParaHosts(UINT64_MAX).bits == 0 && prefijoParaHosts(UINT64_MAX - 1).bits == 0,
+              "prefijoParaHosts /0");
+static_assert(tamanoBloque(PrefijoIPv4(0)) == 0x100000000ull, "tamanoBloque /0");
+static_assert(estaAlineada(DireccionIPv4(192, 168, 1, 0), PrefijoIPv4(24)) &&
+              !estaAlineada(DireccionIPv4(192, 168, 1, 64), PrefijoIPv4(25)), "estaAlineada");
+static_assert(!seSuperponen(DireccionIPv4(10, 0, 0, 0), PrefijoIPv4(25), DireccionIPv4(10, 0, 0, 128), PrefijoIPv4(25)) &&
+              seSuperponen(DireccionIPv4(10, 0, 0, 0), PrefijoIPv4(16), DireccionIPv4(10, 0, 3, 0), PrefijoIPv4(24)),
+              "seSuperponen");
+
+#endif // CALCULO_SUBRED_H
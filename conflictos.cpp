@@ -0,0 +1,40 @@
+#include "conflictos.h"
+
+#include "resumen.h" // ordenarRangosParalelo
+
+using namespace std;
+
+void IndiceInventario::construir(vector<RangoIPv4>& rangos, PoolTrabajo& pool) {
+    for (vector<uint32_t>& redes : porLongitud) {
+        redes.clear();
+    }
+    longitudesPresentes = 0;
+    total = 0;
+
+    // Ordenados por dirección, cada vector por longitud se llena ya ordenado
+    ordenarRangosParalelo(rangos, pool);
+    for (const RangoIPv4& r : rangos) {
+        const uint64_t tamano = uint64_t(r.fin) - r.inicio + 1; // Potencia de dos: el bloque es CIDR
+        const int longitud = __builtin_clzll(tamano) - 31;
+        vector<uint32_t>& redes = porLongitud[static_cast<size_t>(longitud)];
+        if (redes.empty() || redes.back() != r.inicio) {
+            redes.push_back(r.inicio);
+            ++total;
+        }
+        longitudesPresentes |= uint64_t(1) << longitud;
+    }
+    rangos.clear();
+    rangos.shrink_to_fit();
+}
+
+const char* nombreRelacion(RelacionConflicto relacion) {
+    switch (relacion) {
+        case RelacionConflicto::Igual:
+            return "igual";
+        case RelacionConflicto::Contenida:
+            return "contenida";
+        case RelacionConflicto::Contiene:
+            return "contiene";
+    }
+    return "";
+}
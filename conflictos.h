@@ -0,0 +1,90 @@
+#ifndef CONFLICTOS_H
+#define CONFLICTOS_H
+
+#include <algorithm> // Para std::binary_search, std::lower_bound
+#include <array>     // Para std::array
+#include <cstddef>   // Para size_t
+#include <cstdint>   // Para uint32_t y otros tipos enteros de ancho fijo
+#include <vector>    // Para std::vector
+
+#include "asignador.h"      // RangoIPv4
+#include "calculo_subred.h" // Aritmética de subredes con enteros
+#include "pool_trabajo.h"   // Pool de hilos con robo de trabajo
+
+/**
+ * @brief Relación entre una subred de un plan y un prefijo del inventario que se solapa con ella.
+ * Dos prefijos CIDR solo pueden solaparse si son iguales o si uno contiene al otro.
+ */
+enum class RelacionConflicto : uint8_t {
+    Igual,     // El prefijo del inventario es la misma subred
+    Contenida, // La subred está dentro del prefijo del inventario
+    Contiene   // La subred contiene al prefijo del inventario
+};
+
+/**
+ * @brief Índice ordenado de un inventario de prefijos IPv4, para detectar solapamientos.
+ *
+ * Los prefijos se guardan por longitud: 33 vectores ordenados de direcciones de red, sin
+ * duplicados. Comprobar una subred /C cuesta una búsqueda binaria por cada longitud presente
+ * (O(log n) cada una, como mucho 33): en las longitudes L <= C basta buscar la red de la subred
+ * truncada a /L, y en las L > C los prefijos contenidos forman un tramo contiguo a partir de la
+ * red de la subred. Así, m subredes se comprueban en O(m log n) más el número de conflictos,
+ * tras construir el índice en O(n log n).
+ */
+class IndiceInventario {
+public:
+    /**
+     * @brief Construye el índice (sustituye el contenido anterior).
+     * @param rangos Prefijos del inventario (cada rango, un bloque CIDR alineado, como los que produce
+     * parsePrefijosLote); se ordenan y se vacían.
+     * @param pool Pool de hilos para ordenar.
+     */
+    void construir(std::vector<RangoIPv4>& rangos, PoolTrabajo& pool);
+
+    /** @brief Cantidad de prefijos distintos del índice. */
+    size_t cantidadPrefijos() const { return total; }
+
+    /**
+     * @brief Busca los prefijos del inventario que se solapan con una subred.
+     * Los conflictos se entregan según se encuentran: primero los prefijos que contienen a la subred
+     * (del más corto al más largo) y después los contenidos en ella, por longitud y dirección.
+     * @param red Dirección de red de la subred (alineada a su prefijo).
+     * @param cidr Prefijo de la subred (0-32).
+     * @param alConflicto Se llama como alConflicto(redInventario, cidrInventario, RelacionConflicto).
+     * @return Cantidad de conflictos encontrados.
+     */
+    template <typename FuncionConflicto>
+    size_t buscar(uint32_t red, int cidr, FuncionConflicto&& alConflicto) const {
+        size_t conflictos = 0;
+        const uint32_t ultima = red | ~mascaraDePrefijo(PrefijoIPv4(cidr));
+        for (uint64_t presentes = longitudesPresentes; presentes != 0; presentes &= presentes - 1) {
+            const int longitud = __builtin_ctzll(presentes);
+            const std::vector<uint32_t>& redes = porLongitud[static_cast<size_t>(longitud)];
+            if (longitud <= cidr) {
+                const uint32_t contenedora = red & mascaraDePrefijo(PrefijoIPv4(longitud));
+                if (std::binary_search(redes.begin(), redes.end(), contenedora)) {
+                    alConflicto(contenedora, longitud, longitud == cidr ? RelacionConflicto::Igual : RelacionConflicto::Contenida);
+                    ++conflictos;
+                }
+            } else {
+                for (auto it = std::lower_bound(redes.begin(), redes.end(), red); it != redes.end() && *it <= ultima; ++it) {
+                    alConflicto(*it, longitud, RelacionConflicto::Contiene);
+                    ++conflictos;
+                }
+            }
+        }
+        return conflictos;
+    }
+
+private:
+    std::array<std::vector<uint32_t>, 33> porLongitud; // Redes de cada longitud de prefijo, ordenadas
+    uint64_t longitudesPresentes = 0;                   // Bit L activo si hay algún prefijo /L
+    size_t total = 0;
+};
+
+/**
+ * @brief Nombre de una relación para la salida ("igual", "contenida" o "contiene").
+ */
+const char* nombreRelacion(RelacionConflicto relacion);
+
+#endif // CONFLICTOS_H
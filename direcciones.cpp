@@ -0,0 +1,314 @@
+#include "direcciones.h"
+
+#include <algorithm> // Para std::min
+#include <cstring>   // Para memchr, memcpy
+
+#include "calculo_subred.h" // Aritmética de subredes con enteros
+
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+#include <emmintrin.h> // Intrínsecos SSE2 (presentes en todo procesador x86-64)
+#define DIRECCIONES_USAR_SSE2 1
+#endif
+
+using namespace std;
+
+const char* describirErrorIPv4(ErrorIPv4 error) {
+    switch (error) {
+        case ErrorIPv4::Ninguno:            return "dirección válida";
+        case ErrorIPv4::Vacia:              return "la dirección está vacía";
+        case ErrorIPv4::CaracterInvalido:   return "contiene caracteres que no son dígitos ni puntos";
+        case ErrorIPv4::OctetoVacio:        return "tiene un octeto vacío";
+        case ErrorIPv4::OctetoFueraDeRango: return "tiene un octeto fuera del rango 0-255";
+        case ErrorIPv4::NumeroDeOctetos:    return "no tiene exactamente 4 octetos";
+    }
+    return "error desconocido";
+}
+
+ErrorIPv4 parseIPv4(string_view texto, uint32_t& ip) noexcept {
+    if (texto.empty()) {
+        return ErrorIPv4::Vacia;
+    }
+    uint32_t result = 0;
+    uint32_t octeto = 0;
+    int digitos = 0;
+    int puntos = 0;
+    for (char c : texto) {
+        uint32_t d = static_cast<uint32_t>(static_cast<unsigned char>(c)) - '0';
+        if (d < 10) {
+            octeto = octeto * 10 + d;
+            if (++digitos > 3) {
+                return ErrorIPv4::OctetoFueraDeRango;
+            }
+        } else if (c == '.') {
+            if (digitos == 0) {
+                return ErrorIPv4::OctetoVacio;
+            }
+            if (octeto > 255) {
+                return ErrorIPv4::OctetoFueraDeRango;
+            }
+            if (++puntos > 3) {
+                return ErrorIPv4::NumeroDeOctetos;
+            }
+            result = (result << 8) | octeto;
+            octeto = 0;
+            digitos = 0;
+        } else {
+            return ErrorIPv4::CaracterInvalido;
+        }
+    }
+    if (digitos == 0) {
+        return ErrorIPv4::OctetoVacio; // Punto final, ej. "10.0.0."
+    }
+    if (octeto > 255) {
+        return ErrorIPv4::OctetoFueraDeRango;
+    }
+    if (puntos != 3) {
+        return ErrorIPv4::NumeroDeOctetos;
+    }
+    ip = (result << 8) | octeto;
+    return ErrorIPv4::Ninguno;
+}
+
+#ifdef DIRECCIONES_USAR_SSE2
+/**
+ * @brief Intenta analizar la línea que empieza en 'p' con SSE2. Requiere al menos 16 bytes legibles desde 'p'.
+ * Solo resuelve el caso común (dirección válida terminada en '\n' o "\r\n"); ante cualquier otra cosa
+ * devuelve falso y el llamador recurre a la ruta escalar, que determina el error exacto.
+ * @param p Inicio de la línea.
+ * @param ip Recibe la dirección analizada.
+ * @param longitudLinea Recibe la cantidad de bytes consumidos, incluido el salto de línea.
+ * @return Verdadero si la línea se analizó por completo.
+ */
+static inline bool parseLineaSSE2(const char* p, uint32_t& ip, size_t& longitudLinea) {
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i valores = _mm_sub_epi8(bytes, _mm_set1_epi8('0'));
+    // Un byte es dígito si (byte - '0') <= 9 como entero sin signo
+    const __m128i esDigito = _mm_cmpeq_epi8(_mm_min_epu8(valores, _mm_set1_epi8(9)), valores);
+    const __m128i esPunto = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('.'));
+
+    const unsigned mascaraDigitos = static_cast<unsigned>(_mm_movemask_epi8(esDigito));
+    const unsigned mascaraPuntos = static_cast<unsigned>(_mm_movemask_epi8(esPunto));
+    const unsigned mascaraOtros = ~(mascaraDigitos | mascaraPuntos) & 0xFFFFu;
+    if (mascaraOtros == 0) {
+        return false; // Línea de 16 bytes o más: no puede ser una IPv4 válida
+    }
+
+    const unsigned longitud = static_cast<unsigned>(__builtin_ctz(mascaraOtros));
+    size_t salto;
+    if (p[longitud] == '\n') {
+        salto = 1;
+    } else if (p[longitud] == '\r' && longitud + 1 < 16 && p[longitud + 1] == '\n') {
+        salto = 2;
+    } else {
+        return false;
+    }
+
+    const unsigned puntos = mascaraPuntos & ((1u << longitud) - 1);
+    if (__builtin_popcount(puntos) != 3) {
+        return false;
+    }
+    const unsigned punto1 = static_cast<unsigned>(__builtin_ctz(puntos));
+    const unsigned punto2 = static_cast<unsigned>(__builtin_ctz(puntos & (puntos - 1)));
+    const unsigned punto3 = 31u - static_cast<unsigned>(__builtin_clz(puntos));
+
+    // Posición final (exclusiva) y longitud de cada octeto; las longitudes deben estar entre 1 y 3
+    const unsigned final[4] = {punto1, punto2, punto3, longitud};
+    const unsigned largo[4] = {punto1, punto2 - punto1 - 1, punto3 - punto2 - 1, longitud - punto3 - 1};
+    if (largo[0] - 1 > 2 || largo[1] - 1 > 2 || largo[2] - 1 > 2 || largo[3] - 1 > 2) {
+        return false;
+    }
+
+    // Cada octeto se evalúa sin ramas leyendo siempre los 3 bytes que terminan en su final;
+    // los multiplicadores anulan los que no pertenecen al octeto. Los 2 bytes de relleno
+    // iniciales permiten leer "antes" del primer octeto.
+    static const uint32_t multiplicadorCentenas[4] = {0, 0, 0, 100};
+    static const uint32_t multiplicadorDecenas[4] = {0, 0, 10, 10};
+    alignas(16) uint8_t d[32] = {};
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 2), valores);
+
+    uint32_t result = 0;
+    uint32_t fueraDeRango = 0;
+    for (int i = 0; i < 4; ++i) {
+        const uint8_t* o = d + 2 + final[i];
+        uint32_t octeto = o[-3] * multiplicadorCentenas[largo[i]] + o[-2] * multiplicadorDecenas[largo[i]] + o[-1];
+        fueraDeRango |= octeto > 255;
+        result = (result << 8) | octeto;
+    }
+    if (fueraDeRango) {
+        return false;
+    }
+    ip = result;
+    longitudLinea = longitud + salto;
+    return true;
+}
+#endif
+
+ResultadoLoteIPv4 parseIPv4Lote(string_view buffer, vector<uint32_t>& salida, vector<size_t>* lineasInvalidas) {
+    ResultadoLoteIPv4 resultado;
+    const char* p = buffer.data();
+    const char* const fin = p + buffer.size();
+    size_t numeroLinea = 0;
+
+    while (p < fin) {
+#ifdef DIRECCIONES_USAR_SSE2
+        if (fin - p >= 16) {
+            uint32_t ip;
+            size_t consumidos;
+            if (parseLineaSSE2(p, ip, consumidos)) {
+                salida.push_back(ip);
+                ++resultado.validas;
+                ++numeroLinea;
+                p += consumidos;
+                continue;
+            }
+        }
+#endif
+        // Ruta escalar: delimita la línea y la analiza con parseIPv4()
+        const char* finLinea = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(fin - p)));
+        const char* siguiente = finLinea ? finLinea + 1 : fin;
+        if (!finLinea) {
+            finLinea = fin;
+        }
+        if (finLinea > p && finLinea[-1] == '\r') {
+            --finLinea;
+        }
+        if (finLinea > p) {
+            uint32_t ip;
+            if (parseIPv4(string_view(p, static_cast<size_t>(finLinea - p)), ip) == ErrorIPv4::Ninguno) {
+                salida.push_back(ip);
+                ++resultado.validas;
+            } else {
+                ++resultado.invalidas;
+                if (lineasInvalidas) {
+                    lineasInvalidas->push_back(numeroLinea);
+                }
+            }
+        }
+        ++numeroLinea;
+        p = siguiente;
+    }
+    return resultado;
+}
+
+uint32_t ipToInt(string_view ip) {
+    uint32_t result = 0;
+    if (parseIPv4(ip, result) != ErrorIPv4::Ninguno) {
+        return 0; // Formato inválido
+    }
+    return result;
+}
+
+/**
+ * @brief Texto de cada octeto (0-255): en decimal, hasta 3 dígitos y, en el cuarto byte, la longitud;
+ * como último octeto de una línea, los dígitos seguidos de '\n' (con su longitud aparte);
+ * en binario, los 8 dígitos.
+ */
+struct TablaOctetos {
+    char texto[256][4];
+    char linea[256][4];
+    uint8_t longitudLinea[256];
+    char binario[256][8];
+    TablaOctetos() {
+        for (int i = 0; i < 256; ++i) {
+            string t = to_string(i);
+            for (size_t k = 0; k < 3; ++k) {
+                texto[i][k] = k < t.size() ? t[k] : '\0';
+            }
+            texto[i][3] = static_cast<char>(t.size());
+            string l = t + '\n';
+            for (size_t k = 0; k < 4; ++k) {
+                linea[i][k] = k < l.size() ? l[k] : '\0';
+            }
+            longitudLinea[i] = static_cast<uint8_t>(l.size());
+            for (int bit = 0; bit < 8; ++bit) {
+                binario[i][bit] = ((i >> (7 - bit)) & 1) ? '1' : '0';
+            }
+        }
+    }
+};
+
+static const TablaOctetos tablaOctetos;
+
+char* formatearIPv4(char* destino, uint32_t ip) {
+    for (int desplazamiento = 24; desplazamiento >= 0; desplazamiento -= 8) {
+        const char* octeto = tablaOctetos.texto[(ip >> desplazamiento) & 0xFF];
+        // Se copian siempre 3 bytes; solo se avanza la longitud real del octeto
+        destino[0] = octeto[0];
+        destino[1] = octeto[1];
+        destino[2] = octeto[2];
+        destino += octeto[3];
+        *destino++ = '.';
+    }
+    return destino - 1; // Sin el punto final
+}
+
+char* formatearIPv4Consecutivas(char* destino, uint32_t primera, uint32_t cantidad) {
+    uint64_t ip = primera;
+    const uint64_t fin = ip + cantidad;
+    while (ip < fin) {
+        // "a.b.c." se formatea una vez por cada /24; se rellena a 16 bytes para copiarlo con ancho fijo
+        char prefijo[16] = {};
+        char* p = prefijo;
+        for (int desplazamiento = 24; desplazamiento >= 8; desplazamiento -= 8) {
+            const char* octeto = tablaOctetos.texto[(ip >> desplazamiento) & 0xFF];
+            p[0] = octeto[0];
+            p[1] = octeto[1];
+            p[2] = octeto[2];
+            p += octeto[3];
+            *p++ = '.';
+        }
+        const size_t longitudPrefijo = static_cast<size_t>(p - prefijo);
+        const uint64_t finBloque = min(fin, (ip | 0xFF) + 1);
+#ifdef DIRECCIONES_USAR_SSE2
+        const __m128i prefijoVector = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prefijo));
+#endif
+        // Cada línea son dos copias de ancho fijo, el prefijo (16 bytes, una sola escritura SSE2) y el
+        // último octeto con su salto de línea (4 bytes): solo se avanza la longitud real
+        for (; ip < finBloque; ++ip) {
+#ifdef DIRECCIONES_USAR_SSE2
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destino), prefijoVector);
+#else
+            memcpy(destino, prefijo, 16);
+#endif
+            memcpy(destino + longitudPrefijo, tablaOctetos.linea[ip & 0xFF], 4);
+            destino += longitudPrefijo + tablaOctetos.longitudLinea[ip & 0xFF];
+        }
+    }
+    return destino;
+}
+
+string intToIp(uint32_t ip) {
+    char buffer[16];
+    return string(buffer, formatearIPv4(buffer, ip));
+}
+
+char* formatearBinario(char* destino, uint32_t n) {
+    for (int desplazamiento = 24; desplazamiento >= 0; desplazamiento -= 8) {
+        memcpy(destino, tablaOctetos.binario[(n >> desplazamiento) & 0xFF], 8);
+        destino[8] = '.';
+        destino += 9;
+    }
+    return destino - 1; // Sin el punto final
+}
+
+string uint32_tToBinaryString(uint32_t n) {
+    char buffer[36];
+    return string(buffer, formatearBinario(buffer, n));
+}
+
+int maskIntToCidr(uint32_t maskInt) {
+    return prefijoDeMascara(maskInt); // -1 si tiene un 1 después de un 0 (ej. 255.0.255.0)
+}
+
+int maskToCidr(string_view maskDecimal) {
+    uint32_t maskInt;
+    if (parseIPv4(maskDecimal, maskInt) != ErrorIPv4::Ninguno) {
+        return -1; // Error en la conversión IP a Int para la máscara
+    }
+    return maskIntToCidr(maskInt);
+}
+
+string cidrToMask(int cidr) {
+    uint32_t mask = mascaraDePrefijo(PrefijoIPv4(cidr));
+    return intToIp(mask);
+}
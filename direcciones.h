@@ -0,0 +1,129 @@
+#ifndef DIRECCIONES_H
+#define DIRECCIONES_H
+
+#include <cstddef>     // Para size_t
+#include <cstdint>     // Para uint32_t y otros tipos enteros de ancho fijo
+#include <string>      // Para std::string
+#include <string_view> // Para std::string_view (análisis sin copias)
+#include <vector>      // Para std::vector
+
+/**
+ * @brief Motivo por el que una cadena no es una dirección IPv4 válida.
+ */
+enum class ErrorIPv4 : uint8_t {
+    Ninguno = 0,        // La dirección es válida
+    Vacia,              // La cadena está vacía
+    CaracterInvalido,   // Contiene algo distinto de dígitos y puntos
+    OctetoVacio,        // Dos puntos seguidos, o punto al inicio/final
+    OctetoFueraDeRango, // Un octeto supera 255 (o tiene más de 3 dígitos)
+    NumeroDeOctetos     // No tiene exactamente 4 octetos
+};
+
+/**
+ * @brief Devuelve una descripción legible del error de análisis.
+ * @param error El código de error.
+ * @return Cadena estática con la descripción.
+ */
+const char* describirErrorIPv4(ErrorIPv4 error);
+
+/**
+ * @brief Analiza una dirección IPv4 en formato dotted decimal sin reservar memoria ni lanzar excepciones.
+ * Solo se aceptan dígitos y puntos: exactamente 4 octetos de 1 a 3 dígitos con valor 0-255.
+ * @param texto La dirección (sin espacios al inicio/final).
+ * @param ip Recibe la dirección como entero de 32 bits; solo se modifica si es válida.
+ * @return ErrorIPv4::Ninguno si la dirección es válida, o el motivo del error.
+ */
+ErrorIPv4 parseIPv4(std::string_view texto, uint32_t& ip) noexcept;
+
+/**
+ * @brief Resultado del análisis masivo de direcciones.
+ */
+struct ResultadoLoteIPv4 {
+    size_t validas = 0;   // Direcciones añadidas al vector de salida
+    size_t invalidas = 0; // Líneas no vacías que no eran una dirección válida
+};
+
+/**
+ * @brief Analiza un buffer con una dirección IPv4 por línea ('\n' o "\r\n") y añade las válidas a 'salida'.
+ * Las líneas vacías se ignoran; la última línea puede no terminar en salto de línea.
+ * En x86-64 la delimitación y validación de cada línea se hace con SSE2 (16 bytes por instrucción);
+ * en otras arquitecturas, o cerca del final del buffer, se usa parseIPv4().
+ * @param buffer El texto a analizar.
+ * @param salida Vector al que se añaden las direcciones (no se vacía).
+ * @param lineasInvalidas Opcional: recibe el índice (desde 0) de cada línea inválida.
+ * @return Cantidad de direcciones válidas e inválidas encontradas.
+ */
+ResultadoLoteIPv4 parseIPv4Lote(std::string_view buffer, std::vector<uint32_t>& salida,
+                                std::vector<size_t>* lineasInvalidas = nullptr);
+
+/**
+ * @brief Convierte una dirección IP en formato dotted decimal (ej. "192.168.1.1") a un entero sin signo de 32 bits.
+ * Envoltorio de compatibilidad sobre parseIPv4(); úsese solo con entradas ya validadas.
+ * @param ip La dirección IP en formato de cadena.
+ * @return La dirección IP como un entero de 32 bits. Retorna 0 si hay un error de formato (excepto para "0.0.0.0").
+ */
+uint32_t ipToInt(std::string_view ip);
+
+/**
+ * @brief Convierte un entero sin signo de 32 bits a una dirección IP en formato dotted decimal.
+ * @param ip La dirección IP como un entero de 32 bits.
+ * @return La dirección IP en formato de cadena.
+ */
+std::string intToIp(uint32_t ip);
+
+/**
+ * @brief Escribe una dirección IP en formato dotted decimal en un buffer, sin reservar memoria.
+ * @param destino Buffer con espacio para al menos 16 bytes (se escriben como mucho 15 caracteres útiles, sin '\0').
+ * @param ip La dirección IP como un entero de 32 bits.
+ * @return Puntero al carácter siguiente al último escrito.
+ */
+char* formatearIPv4(char* destino, uint32_t ip);
+
+/**
+ * @brief Escribe direcciones consecutivas en formato dotted decimal, una por línea ('\n'), en un buffer.
+ * La parte común de cada /24 se formatea una sola vez; por eso es mucho más rápido que llamar a
+ * formatearIPv4() por cada dirección.
+ * @param destino Buffer con espacio para al menos 16 bytes por dirección.
+ * @param primera La primera dirección.
+ * @param cantidad Cantidad de direcciones (sin pasar de 255.255.255.255).
+ * @return Puntero al carácter siguiente al último escrito.
+ */
+char* formatearIPv4Consecutivas(char* destino, uint32_t primera, uint32_t cantidad);
+
+/**
+ * @brief Escribe un entero de 32 bits en binario con puntos cada 8 bits en un buffer, sin reservar memoria.
+ * @param destino Buffer con espacio para al menos 36 bytes (se escriben 35 caracteres, sin '\0').
+ * @param n El entero de 32 bits.
+ * @return Puntero al carácter siguiente al último escrito.
+ */
+char* formatearBinario(char* destino, uint32_t n);
+
+/**
+ * @brief Convierte un entero sin signo de 32 bits a una cadena binaria con puntos cada 8 bits.
+ * @param n El entero de 32 bits.
+ * @return La cadena binaria formateada.
+ */
+std::string uint32_tToBinaryString(uint32_t n);
+
+/**
+ * @brief Convierte una máscara decimal (ej. "255.255.255.0") a un prefijo CIDR (ej. 24).
+ * @param maskDecimal La máscara en formato de cadena dotted decimal.
+ * @return El prefijo CIDR. Retorna -1 si la máscara no es válida.
+ */
+int maskToCidr(std::string_view maskDecimal);
+
+/**
+ * @brief Convierte una máscara numérica a un prefijo CIDR.
+ * @param maskInt La máscara como entero de 32 bits.
+ * @return El prefijo CIDR. Retorna -1 si la máscara no es una máscara binaria continua.
+ */
+int maskIntToCidr(uint32_t maskInt);
+
+/**
+ * @brief Convierte un prefijo CIDR (ej. 24) a una máscara de subred en formato dotted decimal (ej. "255.255.255.0").
+ * @param cidr El prefijo CIDR.
+ * @return La máscara de subred en formato de cadena.
+ */
+std::string cidrToMask(int cidr);
+
+#endif // DIRECCIONES_H
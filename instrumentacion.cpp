@@ -0,0 +1,165 @@
+#include "instrumentacion.h"
+
+#include <algorithm> // Para std::min, std::max
+#include <memory>    // Para std::unique_ptr
+#include <mutex>     // Para std::mutex
+#include <vector>    // Para std::vector
+
+using namespace std;
+
+static const char* const NOMBRES_FASE[] = {"", "analisis", "prefijos", "ordenacion", "asignacion", "formato", "escritura"};
+static const char* const NOMBRES_CONTADOR[] = {"planes", "subredes", "fallidas", "asignaciones", "bytes_escritos"};
+
+#ifdef CALCULADORA_INSTRUMENTACION
+
+bool instrumentacionActiva = false;
+
+// Medidas de todos los hilos que han medido algo; se liberan al terminar el programa
+static mutex mutexRegistro;
+static vector<unique_ptr<MedidasHilo>> registro;
+
+MedidasHilo* registrarMedidasHilo() {
+    lock_guard<mutex> bloqueo(mutexRegistro);
+    registro.emplace_back(new MedidasHilo());
+    registro.back()->inicioFase = chrono::steady_clock::now();
+    return registro.back().get();
+}
+
+MedicionTrabajo::~MedicionTrabajo() {
+    if (!activa) {
+        return;
+    }
+    const uint64_t ns = static_cast<uint64_t>(
+        chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - inicio).count());
+    MedidasHilo& medidas = medidasHilo();
+    ++medidas.latencias[ns == 0 ? 0 : 63 - __builtin_clzll(ns)];
+    if (ns > medidas.latenciaMaxima) {
+        medidas.latenciaMaxima = ns;
+    }
+}
+
+bool activarInstrumentacion() {
+    instrumentacionActiva = true;
+    return true;
+}
+
+/**
+ * @brief Percentil aproximado a partir del histograma: el límite superior de la cubeta que lo contiene.
+ */
+static uint64_t percentilLatencia(const uint64_t* cubetas, uint64_t total, double p, uint64_t maxima) {
+    const uint64_t objetivo = static_cast<uint64_t>(p * static_cast<double>(total - 1)) + 1;
+    uint64_t acumulado = 0;
+    for (size_t k = 0; k < MedidasHilo::CUBETAS_LATENCIA; ++k) {
+        acumulado += cubetas[k];
+        if (acumulado >= objetivo) {
+            return k + 1 < 64 ? min(maxima, (uint64_t(1) << (k + 1)) - 1) : maxima;
+        }
+    }
+    return maxima;
+}
+
+void escribirInformeInstrumentacion(ostream& os, bool json) {
+    const size_t FASES = static_cast<size_t>(FaseInstrumentacion::Cantidad);
+    const size_t CONTADORES = static_cast<size_t>(ContadorInstrumentacion::Cantidad);
+    uint64_t nsFase[FASES] = {};
+    uint64_t contadores[CONTADORES] = {};
+    uint64_t latencias[MedidasHilo::CUBETAS_LATENCIA] = {};
+    uint64_t latenciaMaxima = 0;
+    size_t hilos;
+    {
+        lock_guard<mutex> bloqueo(mutexRegistro);
+        hilos = registro.size();
+        for (const unique_ptr<MedidasHilo>& medidas : registro) {
+            for (size_t f = 0; f < FASES; ++f) {
+                nsFase[f] += medidas->nsFase[f];
+            }
+            for (size_t c = 0; c < CONTADORES; ++c) {
+                contadores[c] += medidas->contadores[c];
+            }
+            for (size_t k = 0; k < MedidasHilo::CUBETAS_LATENCIA; ++k) {
+                latencias[k] += medidas->latencias[k];
+            }
+            latenciaMaxima = max(latenciaMaxima, medidas->latenciaMaxima);
+        }
+    }
+    uint64_t nsTotal = 0;
+    for (size_t f = 1; f < FASES; ++f) {
+        nsTotal += nsFase[f];
+    }
+    uint64_t trabajos = 0;
+    for (uint64_t c : latencias) {
+        trabajos += c;
+    }
+    const double percentiles[] = {0.5, 0.9, 0.99};
+    const char* const nombresPercentil[] = {"p50", "p90", "p99"};
+
+    if (json) {
+        os << "{\n  \"hilos\": " << hilos << ",\n  \"fases_ns\": {";
+        for (size_t f = 1; f < FASES; ++f) {
+            os << (f > 1 ? ", " : "") << '"' << NOMBRES_FASE[f] << "\": " << nsFase[f];
+        }
+        os << "},\n  \"contadores\": {";
+        for (size_t c = 0; c < CONTADORES; ++c) {
+            os << (c > 0 ? ", " : "") << '"' << NOMBRES_CONTADOR[c] << "\": " << contadores[c];
+        }
+        os << "},\n  \"latencia_trabajo_ns\": {\"trabajos\": " << trabajos;
+        if (trabajos > 0) {
+            for (size_t p = 0; p < 3; ++p) {
+                os << ", \"" << nombresPercentil[p] << "\": " << percentilLatencia(latencias, trabajos, percentiles[p], latenciaMaxima);
+            }
+            os << ", \"max\": " << latenciaMaxima;
+        }
+        // Histograma como pares [límite inferior en ns, cantidad], solo cubetas no vacías
+        os << ", \"histograma\": [";
+        bool primera = true;
+        for (size_t k = 0; k < MedidasHilo::CUBETAS_LATENCIA; ++k) {
+            if (latencias[k] > 0) {
+                os << (primera ? "" : ", ") << '[' << (uint64_t(1) << k) << ", " << latencias[k] << ']';
+                primera = false;
+            }
+        }
+        os << "]}\n}\n";
+        return;
+    }
+
+    os << "\n--- Estadísticas (" << hilos << " hilos; tiempos sumados entre hilos) ---\n";
+    for (size_t f = 1; f < FASES; ++f) {
+        const double ms = static_cast<double>(nsFase[f]) / 1e6;
+        const double porcentaje = nsTotal > 0 ? 100.0 * static_cast<double>(nsFase[f]) / static_cast<double>(nsTotal) : 0;
+        os << "  " << NOMBRES_FASE[f] << ": " << ms << " ms (" << porcentaje << " %)\n";
+    }
+    for (size_t c = 0; c < CONTADORES; ++c) {
+        os << "  " << NOMBRES_CONTADOR[c] << ": " << contadores[c] << '\n';
+    }
+    if (trabajos > 0) {
+        os << "  Latencia por trabajo (" << trabajos << " trabajos):";
+        for (size_t p = 0; p < 3; ++p) {
+            os << ' ' << nombresPercentil[p] << " <= " << static_cast<double>(percentilLatencia(latencias, trabajos, percentiles[p], latenciaMaxima)) / 1e3 << " us,";
+        }
+        os << " max " << static_cast<double>(latenciaMaxima) / 1e3 << " us\n";
+        for (size_t k = 0; k < MedidasHilo::CUBETAS_LATENCIA; ++k) {
+            if (latencias[k] > 0) {
+                os << "    [" << static_cast<double>(uint64_t(1) << k) / 1e3 << ", " << static_cast<double>(uint64_t(1) << k) * 2 / 1e3
+                   << ") us: " << latencias[k] << '\n';
+            }
+        }
+    }
+}
+
+#else
+
+bool activarInstrumentacion() {
+    return false;
+}
+
+void escribirInformeInstrumentacion(ostream& os, bool json) {
+    (void)NOMBRES_FASE;
+    (void)NOMBRES_CONTADOR;
+    if (json) {
+        os << "{}\n";
+    } else {
+        os << "Instrumentación no disponible: compilada con CALCULADORA_INSTRUMENTACION desactivado.\n";
+    }
+}
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef INSTRUMENTACION_H
+#define INSTRUMENTACION_H
+
+#include <chrono>  // Para std::chrono::steady_clock
+#include <cstddef> // Para size_t
+#include <cstdint> // Para uint64_t
+#include <ostream> // Para std::ostream
+
+/**
+ * @brief Fases medidas. Los tiempos son exclusivos: mientras una fase está activa dentro de otra
+ * (ej. la escritura que provoca un búfer lleno durante el formato), el tiempo cuenta solo para la interior.
+ */
+enum class FaseInstrumentacion : uint8_t {
+    Ninguna,    // Fuera de las fases medidas (no se informa)
+    Analisis,   // Análisis de registros de trabajo y de direcciones (analizarTrabajo, ipToInt)
+    Prefijos,   // Prefijo de cada solicitud (hostsToCidr)
+    Ordenacion, // Agrupación de las solicitudes por prefijo
+    Asignacion, // Asignador de bloques: inicialización, asignación y espacio libre
+    Formato,    // Formato de las filas (direcciones, máscaras y binario) en el búfer
+    Escritura,  // Entrega del búfer al flujo de salida
+    Cantidad
+};
+
+/**
+ * @brief Contadores de eventos.
+ */
+enum class ContadorInstrumentacion : uint8_t {
+    Planes,        // Planes calculados
+    Subredes,      // Subredes asignadas
+    Fallidas,      // Solicitudes no asignadas
+    Asignaciones,  // Operaciones del asignador (cada una asigna uno o más bloques consecutivos)
+    BytesEscritos, // Bytes entregados por los búferes de salida
+    Cantidad
+};
+
+#ifdef CALCULADORA_INSTRUMENTACION
+
+/**
+ * @brief Medidas de un hilo. Cada hilo escribe solo en las suyas, sin atómicos ni bloqueos;
+ * el informe suma las de todos.
+ */
+struct MedidasHilo {
+    static const size_t CUBETAS_LATENCIA = 64; // Cubeta k: latencias en [2^k, 2^(k+1)) ns
+
+    uint64_t nsFase[static_cast<size_t>(FaseInstrumentacion::Cantidad)] = {};
+    uint64_t contadores[static_cast<size_t>(ContadorInstrumentacion::Cantidad)] = {};
+    uint64_t latencias[CUBETAS_LATENCIA] = {};
+    uint64_t latenciaMaxima = 0;
+    FaseInstrumentacion faseActual = FaseInstrumentacion::Ninguna;
+    std::chrono::steady_clock::time_point inicioFase;
+};
+
+/** @brief Verdadero si se pidió el informe (--stats): sin él, las mediciones no hacen nada. */
+extern bool instrumentacionActiva;
+
+/** @brief Registra las medidas de un hilo nuevo (se conservan hasta el final del programa). */
+MedidasHilo* registrarMedidasHilo();
+
+/** @brief Medidas del hilo actual. */
+inline MedidasHilo& medidasHilo() {
+    thread_local MedidasHilo* medidas = registrarMedidasHilo();
+    return *medidas;
+}
+
+/**
+ * @brief Cambia la fase activa del hilo y acumula el tiempo transcurrido en la anterior.
+ * @return La fase anterior.
+ */
+inline FaseInstrumentacion cambiarFase(FaseInstrumentacion fase) {
+    MedidasHilo& medidas = medidasHilo();
+    const auto ahora = std::chrono::steady_clock::now();
+    medidas.nsFase[static_cast<size_t>(medidas.faseActual)] += static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(ahora - medidas.inicioFase).count());
+    const FaseInstrumentacion anterior = medidas.faseActual;
+    medidas.faseActual = fase;
+    medidas.inicioFase = ahora;
+    return anterior;
+}
+
+/**
+ * @brief Activa una fase durante su ámbito y restaura la anterior al salir.
+ */
+class MedicionFase {
+public:
+    explicit MedicionFase(FaseInstrumentacion fase) : activa(instrumentacionActiva) {
+        if (activa) {
+            anterior = cambiarFase(fase);
+        }
+    }
+    ~MedicionFase() {
+        if (activa) {
+            cambiarFase(anterior);
+        }
+    }
+    MedicionFase(const MedicionFase&) = delete;
+    MedicionFase& operator=(const MedicionFase&) = delete;
+
+private:
+    bool activa;
+    FaseInstrumentacion anterior = FaseInstrumentacion::Ninguna;
+};
+
+/**
+ * @brief Mide la latencia de un trabajo durante su ámbito y la añade al histograma.
+ */
+class MedicionTrabajo {
+public:
+    MedicionTrabajo() : activa(instrumentacionActiva) {
+        if (activa) {
+            inicio = std::chrono::steady_clock::now();
+        }
+    }
+    ~MedicionTrabajo();
+    MedicionTrabajo(const MedicionTrabajo&) = delete;
+    MedicionTrabajo& operator=(const MedicionTrabajo&) = delete;
+
+private:
+    bool activa;
+    std::chrono::steady_clock::time_point inicio;
+};
+
+inline void contarInstrumentacion(ContadorInstrumentacion contador, uint64_t cantidad) {
+    if (instrumentacionActiva) {
+        medidasHilo().contadores[static_cast<size_t>(contador)] += cantidad;
+    }
+}
+
+#define INSTRUMENTACION_CONCATENAR_(a, b) a##b
+#define INSTRUMENTACION_CONCATENAR(a, b) INSTRUMENTACION_CONCATENAR_(a, b)
+/** @brief Mide como 'fase' el resto del ámbito actual. */
+#define MEDIR_FASE(fase) MedicionFase INSTRUMENTACION_CONCATENAR(medicionFase_, __LINE__)(FaseInstrumentacion::fase)
+/** @brief Añade el resto del ámbito actual al histograma de latencia por trabajo. */
+#define MEDIR_TRABAJO() MedicionTrabajo INSTRUMENTACION_CONCATENAR(medicionTrabajo_, __LINE__)
+/** @brief Suma 'cantidad' a un contador. */
+#define CONTAR(contador, cantidad) contarInstrumentacion(ContadorInstrumentacion::contador, (cantidad))
+
+#else
+
+// Sin CALCULADORA_INSTRUMENTACION las mediciones desaparecen al compilar
+#define MEDIR_FASE(fase) ((void)0)
+#define MEDIR_TRABAJO() ((void)0)
+#define CONTAR(contador, cantidad) ((void)0)
+
+#endif
+
+/**
+ * @brief Activa las mediciones (desde ese momento).
+ * @return Falso si el programa se compiló sin instrumentación.
+ */
+bool activarInstrumentacion();
+
+/**
+ * @brief Escribe el informe de todas las medidas: tiempo por fase, contadores e histograma de latencia.
+ * @param os Flujo de salida.
+ * @param json Verdadero para JSON; falso para texto.
+ */
+void escribirInformeInstrumentacion(std::ostream& os, bool json);
+
+#endif // INSTRUMENTACION_H
@@ -0,0 +1,443 @@
+#include "ipam.h"
+
+#include <algorithm> // Para std::sort
+#include <atomic>    // Para std::atomic_thread_fence
+#include <cstring>   // Para memcpy, memcmp
+
+#ifndef _WIN32
+#include <fcntl.h>    // Para open
+#include <sys/mman.h> // Para mmap, munmap, msync
+#include <sys/stat.h> // Para fstat
+#include <unistd.h>   // Para close, ftruncate
+#endif
+
+#include "calculo_subred.h" // Aritmética de subredes con enteros
+#include "direcciones.h" // Para intToIp
+#include "subredes.h" // Para hostsToCidr
+
+using namespace std;
+
+static const char MAGIA_IPAM[8] = {'S', 'U', 'B', 'I', 'P', 'A', 'M', '1'};
+static const uint32_t VERSION_IPAM = 1;
+static const uint32_t CAPACIDAD_REDES = 256;
+static const uint32_t CAPACIDAD_BLOQUES_INICIAL = 4096;
+
+/**
+ * @brief Suma de verificación FNV-1a de 32 bits.
+ */
+static uint32_t sumaVerificacion(const void* datos, size_t longitud) {
+    const unsigned char* p = static_cast<const unsigned char*>(datos);
+    uint32_t suma = 2166136261u;
+    for (size_t i = 0; i < longitud; ++i) {
+        suma = (suma ^ p[i]) * 16777619u;
+    }
+    return suma;
+}
+
+/**
+ * @brief Tamaño del archivo necesario para las capacidades dadas.
+ */
+static size_t tamanoArchivo(uint32_t capacidadRedes, uint32_t capacidadBloques) {
+    return sizeof(CabeceraIPAM) + size_t(capacidadRedes) * sizeof(RegistroRedIPAM) +
+           size_t(capacidadBloques) * sizeof(RegistroBloqueIPAM);
+}
+
+static uint32_t sumaRed(uint32_t red, uint8_t cidr) {
+    unsigned char datos[5];
+    memcpy(datos, &red, 4);
+    datos[4] = cidr;
+    return sumaVerificacion(datos, sizeof(datos));
+}
+
+static uint64_t tamanoBloque(int cidr) {
+    return tamanoBloque(PrefijoIPv4(cidr));
+}
+
+/**
+ * @brief Comprueba que 'red' sea la dirección de red de un bloque con ese prefijo.
+ * @param error Recibe el mensaje de error, con la dirección de red correcta.
+ */
+static bool redAlineada(uint32_t red, int cidr, string& error) {
+    if (estaAlineada(DireccionIPv4(red), PrefijoIPv4(cidr))) {
+        return true;
+    }
+    error = "Error: La dirección IP '" + intToIp(red) + "' no es una dirección de red válida para la máscara /" +
+            to_string(cidr) + ".\nLa dirección de red correcta para esta IP y máscara sería: " +
+            intToIp(redDe(DireccionIPv4(red), PrefijoIPv4(cidr)).valor) + "/" + to_string(cidr);
+    return false;
+}
+
+AlmacenIPAM::~AlmacenIPAM() {
+    cerrar();
+}
+
+RegistroRedIPAM* AlmacenIPAM::redes() const {
+    return reinterpret_cast<RegistroRedIPAM*>(mapa + sizeof(CabeceraIPAM));
+}
+
+RegistroBloqueIPAM* AlmacenIPAM::bloques() const {
+    return reinterpret_cast<RegistroBloqueIPAM*>(mapa + sizeof(CabeceraIPAM) +
+                                                 size_t(cabecera()->capacidadRedes) * sizeof(RegistroRedIPAM));
+}
+
+bool AlmacenIPAM::redValida(const RegistroRedIPAM& registro) {
+    return registro.estado == 1 && registro.suma == sumaRed(registro.red, registro.cidr);
+}
+
+bool AlmacenIPAM::bloqueValido(const RegistroBloqueIPAM& registro) {
+    return registro.estado == 1 && registro.suma == sumaVerificacion(&registro, 12);
+}
+
+void AlmacenIPAM::cerrar() {
+#ifndef _WIN32
+    if (mapa) {
+        munmap(mapa, tamanoMapa);
+    }
+    if (descriptor >= 0) {
+        close(descriptor);
+    }
+#endif
+    mapa = nullptr;
+    tamanoMapa = 0;
+    descriptor = -1;
+    redIndexada.clear();
+    ranurasListas = false;
+    ranuraPorDireccion.clear();
+    ranurasLibres.clear();
+    asignadores.clear();
+}
+
+bool AlmacenIPAM::mapear(size_t tamano, string& error) {
+#ifndef _WIN32
+    // El mapa anterior se conserva hasta que el nuevo existe: si falla, el almacén sigue utilizable
+    void* p = mmap(nullptr, tamano, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    if (p == MAP_FAILED) {
+        error = "Error: No se pudo mapear el archivo IPAM en memoria.";
+        return false;
+    }
+    if (mapa) {
+        munmap(mapa, tamanoMapa);
+    }
+    mapa = static_cast<unsigned char*>(p);
+    tamanoMapa = tamano;
+    return true;
+#else
+    (void)tamano;
+    error = "Error: El almacén IPAM no está disponible en Windows.";
+    return false;
+#endif
+}
+
+bool AlmacenIPAM::crear(const string& ruta, string& error) {
+    cerrar();
+#ifndef _WIN32
+    descriptor = open(ruta.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (descriptor < 0) {
+        error = "Error: No se pudo crear el archivo IPAM '" + ruta + "' (¿ya existe?).";
+        return false;
+    }
+    const size_t tamano = tamanoArchivo(CAPACIDAD_REDES, CAPACIDAD_BLOQUES_INICIAL);
+    if (ftruncate(descriptor, static_cast<off_t>(tamano)) != 0 || !mapear(tamano, error)) {
+        if (error.empty()) error = "Error: No se pudo dimensionar el archivo IPAM '" + ruta + "'.";
+        cerrar();
+        return false;
+    }
+    // El archivo recién extendido está a cero; la magia se escribe al final para confirmar la cabecera
+    CabeceraIPAM* c = cabecera();
+    c->version = VERSION_IPAM;
+    c->capacidadRedes = CAPACIDAD_REDES;
+    c->capacidadBloques = CAPACIDAD_BLOQUES_INICIAL;
+    atomic_thread_fence(memory_order_release);
+    memcpy(c->magia, MAGIA_IPAM, sizeof(MAGIA_IPAM));
+    return true;
+#else
+    (void)ruta;
+    error = "Error: El almacén IPAM no está disponible en Windows.";
+    return false;
+#endif
+}
+
+bool AlmacenIPAM::abrir(const string& ruta, string& error) {
+    cerrar();
+#ifndef _WIN32
+    descriptor = open(ruta.c_str(), O_RDWR);
+    if (descriptor < 0) {
+        error = "Error: No se pudo abrir el archivo IPAM '" + ruta + "'.";
+        return false;
+    }
+    struct stat info;
+    if (fstat(descriptor, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(CabeceraIPAM) ||
+        !mapear(static_cast<size_t>(info.st_size), error)) {
+        if (error.empty()) error = "Error: El archivo '" + ruta + "' no es un archivo IPAM válido.";
+        cerrar();
+        return false;
+    }
+    const CabeceraIPAM* c = cabecera();
+    if (memcmp(c->magia, MAGIA_IPAM, sizeof(MAGIA_IPAM)) != 0 || c->version != VERSION_IPAM ||
+        tamanoArchivo(c->capacidadRedes, c->capacidadBloques) > tamanoMapa ||
+        c->numRedes > c->capacidadRedes || c->numBloques > c->capacidadBloques) {
+        error = "Error: El archivo '" + ruta + "' no es un archivo IPAM válido o está dañado.";
+        cerrar();
+        return false;
+    }
+    return true;
+#else
+    (void)ruta;
+    error = "Error: El almacén IPAM no está disponible en Windows.";
+    return false;
+#endif
+}
+
+bool AlmacenIPAM::crecer(string& error) {
+#ifndef _WIN32
+    // Primero se agranda el archivo y después se publica la nueva capacidad en la cabecera
+    const uint32_t nuevaCapacidad = cabecera()->capacidadBloques * 2;
+    const size_t tamano = tamanoArchivo(cabecera()->capacidadRedes, nuevaCapacidad);
+    if (ftruncate(descriptor, static_cast<off_t>(tamano)) != 0 || !mapear(tamano, error)) {
+        if (error.empty()) error = "Error: No se pudo agrandar el archivo IPAM.";
+        return false;
+    }
+    atomic_thread_fence(memory_order_release);
+    cabecera()->capacidadBloques = nuevaCapacidad;
+    return true;
+#else
+    error = "Error: El almacén IPAM no está disponible en Windows.";
+    return false;
+#endif
+}
+
+size_t AlmacenIPAM::cantidadRedes() const {
+    return mapa ? cabecera()->numRedes : 0;
+}
+
+const RegistroRedIPAM& AlmacenIPAM::red(size_t indice) const {
+    return redes()[indice];
+}
+
+int AlmacenIPAM::buscarRed(uint32_t redBuscada, int cidr) const {
+    for (uint32_t i = 0; i < cabecera()->numRedes; ++i) {
+        const RegistroRedIPAM& r = redes()[i];
+        if (r.red == redBuscada && r.cidr == cidr && redValida(r)) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+int AlmacenIPAM::redQueContiene(uint32_t ip) const {
+    for (uint32_t i = 0; i < cabecera()->numRedes; ++i) {
+        const RegistroRedIPAM& r = redes()[i];
+        if (r.cidr <= 32 && redDe(DireccionIPv4(ip), PrefijoIPv4(r.cidr)).valor == r.red && redValida(r)) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void AlmacenIPAM::indexarRedes(int indice, bool conRanurasLibres) {
+    const CabeceraIPAM* c = cabecera();
+    if (redIndexada.size() < c->numRedes) {
+        redIndexada.resize(c->numRedes, 0);
+        asignadores.resize(c->numRedes);
+    }
+    vector<uint8_t> pendiente(c->numRedes, 0);
+    bool hayPendientes = false;
+    for (uint32_t r = 0; r < c->numRedes; ++r) {
+        pendiente[r] = !redIndexada[r] && (indice < 0 || r == static_cast<uint32_t>(indice)) && redValida(redes()[r]);
+        hayPendientes = hayPendientes || pendiente[r];
+    }
+    conRanurasLibres = conRanurasLibres && !ranurasListas;
+    if (!hayPendientes && !conRanurasLibres) {
+        return;
+    }
+
+    // Una sola pasada por los registros; los de otras redes se descartan sin calcular su suma de verificación
+    vector<vector<RangoIPv4>> ocupados(c->numRedes);
+    for (uint32_t i = 0; i < c->numBloques; ++i) {
+        const RegistroBloqueIPAM& b = bloques()[i];
+        const bool interesa = b.indiceRed < c->numRedes && pendiente[b.indiceRed];
+        if (!interesa && !conRanurasLibres) {
+            continue;
+        }
+        if (!bloqueValido(b) || b.indiceRed >= c->numRedes) {
+            if (conRanurasLibres) {
+                ranurasLibres.push_back(i);
+            }
+            continue;
+        }
+        if (interesa) {
+            ranuraPorDireccion[b.red] = i;
+            ocupados[b.indiceRed].push_back({b.red, static_cast<uint32_t>(b.red + tamanoBloque(b.cidr) - 1)});
+        }
+    }
+    for (uint32_t r = 0; r < c->numRedes; ++r) {
+        if (pendiente[r]) {
+            asignadores[r].inicializar(redes()[r].red, redes()[r].cidr, ocupados[r]);
+            redIndexada[r] = 1;
+        }
+    }
+    ranurasListas = ranurasListas || conRanurasLibres;
+}
+
+bool AlmacenIPAM::agregarRed(uint32_t redNueva, int cidr, string& error) {
+    if (!redAlineada(redNueva, cidr, error)) {
+        return false;
+    }
+    CabeceraIPAM* c = cabecera();
+    const uint64_t fin = redNueva + tamanoBloque(cidr) - 1;
+    for (uint32_t i = 0; i < c->numRedes; ++i) {
+        const RegistroRedIPAM& r = redes()[i];
+        if (!redValida(r)) {
+            continue;
+        }
+        const uint64_t finExistente = r.red + tamanoBloque(r.cidr) - 1;
+        if (redNueva <= finExistente && r.red <= fin) {
+            error = "Error: La red se solapa con una red base ya almacenada.";
+            return false;
+        }
+    }
+    if (c->numRedes >= c->capacidadRedes) {
+        error = "Error: Se alcanzó el máximo de redes base del archivo IPAM.";
+        return false;
+    }
+
+    // Se escribe el registro completo y solo después se confirma incrementando el contador
+    RegistroRedIPAM& r = redes()[c->numRedes];
+    r.red = redNueva;
+    r.cidr = static_cast<uint8_t>(cidr);
+    r.suma = sumaRed(redNueva, r.cidr);
+    r.estado = 1;
+    atomic_thread_fence(memory_order_release);
+    c->numRedes += 1;
+
+    // La red nueva no tiene bloques: su índice está completo sin recorrer los registros
+    redIndexada.resize(c->numRedes, 0);
+    asignadores.resize(c->numRedes);
+    asignadores.back().inicializar(redNueva, cidr, {});
+    redIndexada.back() = 1;
+    return true;
+}
+
+bool AlmacenIPAM::asignar(uint32_t redBase, int cidrBase, int hosts, BloqueIPv4& bloque, string& error) {
+    const int indice = buscarRed(redBase, cidrBase);
+    if (indice < 0) {
+        error = "Error: La red base no existe en el archivo IPAM.";
+        return false;
+    }
+    const int cidr = hostsToCidr(hosts);
+    if (cidr < 0) {
+        error = "Error: El número de hosts es inválido.";
+        return false;
+    }
+    if (cidr < cidrBase) {
+        error = "Error: El bloque necesario (/" + to_string(cidr) + ") es más grande que la red base.";
+        return false;
+    }
+    indexarRedes(indice, true);
+    AsignadorBloques& asignador = asignadores[static_cast<size_t>(indice)];
+    uint32_t redAsignada;
+    if (!asignador.asignar(cidr, redAsignada)) {
+        error = (asignador.direccionesLibres() < tamanoBloque(cidr))
+                    ? "Error: Sin espacio suficiente en la red base (IPs libres: " + to_string(asignador.direccionesLibres()) + ")."
+                    : "Error: El espacio libre está fragmentado (mayor bloque libre: /" + to_string(asignador.mayorBloqueLibre()) + ").";
+        return false;
+    }
+
+    // Ranura: se reutiliza una libre o se añade una al final
+    CabeceraIPAM* c = cabecera();
+    bool nueva = ranurasLibres.empty();
+    if (nueva && c->numBloques == c->capacidadBloques && !crecer(error)) {
+        asignador.liberar(redAsignada, cidr);
+        return false;
+    }
+    c = cabecera(); // El mapa puede haber cambiado de dirección al crecer
+    const uint32_t ranura = nueva ? c->numBloques : ranurasLibres.back();
+    if (!nueva) {
+        ranurasLibres.pop_back();
+    }
+
+    RegistroBloqueIPAM& b = bloques()[ranura];
+    b.estado = 0;
+    atomic_thread_fence(memory_order_release);
+    b.red = redAsignada;
+    b.hostsSolicitados = static_cast<uint32_t>(hosts);
+    b.indiceRed = static_cast<uint16_t>(indice);
+    b.cidr = static_cast<uint8_t>(cidr);
+    RegistroBloqueIPAM copia = b;
+    copia.estado = 1;
+    b.suma = sumaVerificacion(&copia, 12);
+    atomic_thread_fence(memory_order_release);
+    b.estado = 1;
+    if (nueva) {
+        atomic_thread_fence(memory_order_release);
+        c->numBloques += 1;
+    }
+
+    ranuraPorDireccion[redAsignada] = ranura;
+    bloque = {redAsignada, cidr};
+    return true;
+}
+
+bool AlmacenIPAM::liberar(uint32_t redBloque, int cidr, string& error) {
+    if (!redAlineada(redBloque, cidr, error)) {
+        return false;
+    }
+    const int indice = redQueContiene(redBloque);
+    if (indice >= 0) {
+        indexarRedes(indice, false);
+    }
+    auto it = indice >= 0 ? ranuraPorDireccion.find(redBloque) : ranuraPorDireccion.end();
+    if (it == ranuraPorDireccion.end() || bloques()[it->second].cidr != cidr) {
+        error = "Error: El bloque no está asignado en el archivo IPAM.";
+        return false;
+    }
+    RegistroBloqueIPAM& b = bloques()[it->second];
+    b.estado = 0; // Un único byte: la liberación es atómica frente a interrupciones
+    asignadores[b.indiceRed].liberar(redBloque, cidr);
+    if (ranurasListas) { // Si no, la ranura aparecerá como libre cuando se recorran los registros
+        ranurasLibres.push_back(it->second);
+    }
+    ranuraPorDireccion.erase(it);
+    return true;
+}
+
+bool AlmacenIPAM::consultar(uint32_t ip, RegistroBloqueIPAM& registro) {
+    const int indice = redQueContiene(ip);
+    if (indice < 0) {
+        return false;
+    }
+    indexarRedes(indice, false);
+    auto it = ranuraPorDireccion.upper_bound(ip);
+    if (it == ranuraPorDireccion.begin()) {
+        return false;
+    }
+    --it;
+    const RegistroBloqueIPAM& b = bloques()[it->second];
+    if (ip > b.red + tamanoBloque(b.cidr) - 1) {
+        return false;
+    }
+    registro = b;
+    return true;
+}
+
+void AlmacenIPAM::contenidoRed(size_t indice, vector<RegistroBloqueIPAM>& resultado, vector<RangoIPv4>& libres) {
+    // Quien lista una red suele listarlas todas: se indexan todas en la misma pasada
+    indexarRedes(-1, false);
+    resultado.clear();
+    const RegistroRedIPAM& r = redes()[indice];
+    const uint64_t fin = r.red + tamanoBloque(r.cidr) - 1;
+    for (auto it = ranuraPorDireccion.lower_bound(r.red); it != ranuraPorDireccion.end() && it->first <= fin; ++it) {
+        resultado.push_back(bloques()[it->second]);
+    }
+    asignadores[indice].rangosLibres(libres);
+}
+
+bool AlmacenIPAM::sincronizar(string& error) {
+#ifndef _WIN32
+    if (mapa && msync(mapa, tamanoMapa, MS_SYNC) != 0) {
+        error = "Error: No se pudo escribir el archivo IPAM en el disco.";
+        return false;
+    }
+#endif
+    return true;
+}
@@ -0,0 +1,193 @@
+#ifndef IPAM_H
+#define IPAM_H
+
+#include <cstddef> // Para size_t
+#include <cstdint> // Para uint32_t y otros tipos enteros de ancho fijo
+#include <map>     // Para std::map (índice de bloques por dirección)
+#include <string>  // Para std::string
+#include <vector>  // Para std::vector
+
+#include "asignador.h" // Asignador de bloques con rangos reservados
+
+/**
+ * @brief Cabecera del archivo IPAM (64 bytes, orden de bytes nativo).
+ * Tras ella van 'capacidadRedes' registros de red y 'capacidadBloques' registros de bloque.
+ */
+struct CabeceraIPAM {
+    char magia[8];             // "SUBIPAM1"
+    uint32_t version;
+    uint32_t capacidadRedes;
+    uint32_t capacidadBloques;
+    uint32_t numRedes;         // Registros de red confirmados
+    uint32_t numBloques;       // Registros de bloque usados (libres o asignados)
+    uint32_t reservado[9];
+};
+
+/**
+ * @brief Red base almacenada (16 bytes).
+ */
+struct RegistroRedIPAM {
+    uint32_t red;
+    uint8_t cidr;
+    uint8_t estado;   // 1 = válida
+    uint16_t relleno;
+    uint32_t suma;    // Suma de verificación de red y cidr
+    uint32_t relleno2;
+};
+
+/**
+ * @brief Bloque asignado dentro de una red base (16 bytes).
+ */
+struct RegistroBloqueIPAM {
+    uint32_t red;
+    uint32_t hostsSolicitados;
+    uint16_t indiceRed;
+    uint8_t cidr;
+    uint8_t estado;   // 0 = ranura libre, 1 = asignado
+    uint32_t suma;    // Suma de verificación de los 12 bytes anteriores (con estado = 1)
+};
+
+static_assert(sizeof(CabeceraIPAM) == 64, "CabeceraIPAM debe ocupar 64 bytes");
+static_assert(sizeof(RegistroRedIPAM) == 16, "RegistroRedIPAM debe ocupar 16 bytes");
+static_assert(sizeof(RegistroBloqueIPAM) == 16, "RegistroBloqueIPAM debe ocupar 16 bytes");
+
+/**
+ * @brief Almacén IPAM persistente sobre un archivo binario mapeado en memoria.
+ *
+ * Abrir el archivo solo valida la cabecera (O(1)); el índice en memoria (bloques por dirección y
+ * asignador de cada red, ranuras libres) se construye bajo demanda y solo para las redes base que toca
+ * cada operación: asignar, liberar o consultar en una red no construye los asignadores de las demás.
+ * El archivo no guarda qué registros son de cada red, así que la primera operación sobre una red
+ * recorre todos los registros de bloque: cuesta O(B) en total (B = bloques del archivo), más
+ * O(b log b) para los b bloques de esa red. Las siguientes operaciones del mismo proceso sobre esa red
+ * no vuelven a recorrerlos; como la línea de comandos hace una operación por proceso, allí cada
+ * comando paga el recorrido. Cada modificación escribe únicamente los registros afectados.
+ *
+ * Resistencia a fallos: un registro se escribe completo antes de marcarlo como asignado
+ * (estado = 1, un único byte) y los registros nuevos solo se confirman al incrementar el contador
+ * de la cabecera. Un registro a medio escribir se ve como libre, y uno con la suma de verificación
+ * incorrecta se ignora. Así, si el proceso se interrumpe a mitad de una escritura, el archivo
+ * conserva el estado anterior o el nuevo. Para protegerse también de un corte de energía hay que
+ * llamar a sincronizar() antes de dar la operación por terminada (la línea de comandos lo hace tras
+ * cada comando que modifica el archivo).
+ */
+class AlmacenIPAM {
+public:
+    AlmacenIPAM() = default;
+    ~AlmacenIPAM();
+    AlmacenIPAM(const AlmacenIPAM&) = delete;
+    AlmacenIPAM& operator=(const AlmacenIPAM&) = delete;
+
+    /**
+     * @brief Crea un archivo IPAM vacío (falla si ya existe).
+     * @param ruta Ruta del archivo.
+     * @param error Recibe el mensaje de error.
+     * @return Verdadero si se creó y quedó abierto.
+     */
+    bool crear(const std::string& ruta, std::string& error);
+
+    /**
+     * @brief Abre un archivo IPAM existente.
+     * @param ruta Ruta del archivo.
+     * @param error Recibe el mensaje de error.
+     * @return Verdadero si el archivo es válido y quedó abierto.
+     */
+    bool abrir(const std::string& ruta, std::string& error);
+
+    /**
+     * @brief Añade una red base. No puede solaparse con otra red ya almacenada.
+     * @param red Dirección de red (alineada a su prefijo).
+     * @param cidr Prefijo CIDR.
+     * @param error Recibe el mensaje de error.
+     * @return Verdadero si se añadió.
+     */
+    bool agregarRed(uint32_t red, int cidr, std::string& error);
+
+    /**
+     * @brief Asigna un bloque para 'hosts' hosts dentro de la red base indicada.
+     * @param redBase Dirección de la red base.
+     * @param cidrBase Prefijo de la red base.
+     * @param hosts Número de hosts solicitado.
+     * @param bloque Recibe el bloque asignado.
+     * @param error Recibe el mensaje de error (red inexistente, sin espacio, ...).
+     * @return Verdadero si se asignó.
+     */
+    bool asignar(uint32_t redBase, int cidrBase, int hosts, BloqueIPv4& bloque, std::string& error);
+
+    /**
+     * @brief Libera un bloque asignado.
+     * @param red Dirección de red del bloque.
+     * @param cidr Prefijo del bloque.
+     * @param error Recibe el mensaje de error si el bloque no está asignado.
+     * @return Verdadero si se liberó.
+     */
+    bool liberar(uint32_t red, int cidr, std::string& error);
+
+    /**
+     * @brief Busca el bloque asignado que contiene una dirección.
+     * @param ip La dirección a buscar.
+     * @param registro Recibe el registro del bloque.
+     * @return Verdadero si la dirección pertenece a un bloque asignado.
+     */
+    bool consultar(uint32_t ip, RegistroBloqueIPAM& registro);
+
+    /** @brief Cantidad de redes base almacenadas. */
+    size_t cantidadRedes() const;
+
+    /**
+     * @brief Devuelve una red base almacenada.
+     * @param indice Índice de la red (menor que cantidadRedes()).
+     */
+    const RegistroRedIPAM& red(size_t indice) const;
+
+    /**
+     * @brief Indica si un registro de red está confirmado y su suma de verificación es correcta.
+     * Los registros que no lo están se ignoran (sus bloques incluidos).
+     */
+    static bool redValida(const RegistroRedIPAM& registro);
+
+    /**
+     * @brief Obtiene los bloques asignados de una red base, ordenados por dirección, y su espacio libre.
+     * @param indice Índice de una red válida (ver redValida()).
+     * @param bloques Recibe los bloques asignados (se vacía antes de llenarse).
+     * @param libres Recibe el espacio libre en rangos contiguos.
+     */
+    void contenidoRed(size_t indice, std::vector<RegistroBloqueIPAM>& bloques, std::vector<RangoIPv4>& libres);
+
+    /**
+     * @brief Fuerza la escritura del archivo al disco (msync síncrono; solo se escriben las páginas modificadas).
+     * @param error Recibe el mensaje de error.
+     * @return Verdadero si el archivo quedó en el disco.
+     */
+    bool sincronizar(std::string& error);
+
+private:
+    CabeceraIPAM* cabecera() const { return reinterpret_cast<CabeceraIPAM*>(mapa); }
+    RegistroRedIPAM* redes() const;
+    RegistroBloqueIPAM* bloques() const;
+
+    bool mapear(size_t tamano, std::string& error);
+    bool crecer(std::string& error);
+    void cerrar();
+    /**
+     * @brief Completa el índice de una red base (o de todas, con indice < 0) en una sola pasada por los
+     * registros de bloque, O(B); con conRanurasLibres, recoge además las ranuras reutilizables.
+     */
+    void indexarRedes(int indice, bool conRanurasLibres);
+    int buscarRed(uint32_t red, int cidr) const;
+    int redQueContiene(uint32_t ip) const;
+    static bool bloqueValido(const RegistroBloqueIPAM& registro);
+
+    int descriptor = -1;
+    unsigned char* mapa = nullptr;
+    size_t tamanoMapa = 0;
+
+    // Índice en memoria, construido bajo demanda por red base
+    std::vector<uint8_t> redIndexada;                // 1 si la red ya tiene su asignador y sus bloques en el mapa
+    bool ranurasListas = false;                      // Verdadero si ranurasLibres ya recoge todas las libres
+    std::map<uint32_t, uint32_t> ranuraPorDireccion; // Dirección de red del bloque -> ranura (redes indexadas)
+    std::vector<uint32_t> ranurasLibres;
+    std::vector<AsignadorBloques> asignadores;       // Uno por red base (válido si está indexada)
+};
+
+#endif // IPAM_H
@@ -0,0 +1,441 @@
+#include "ipv6.h"
+
+#include <cstring> // Para memcpy
+
+#include "bufer_salida.h" // Escritura de la salida por bloques
+#include "direcciones.h"  // Para parseIPv4 (IPv4 incrustada al final de una dirección IPv6)
+
+using namespace std;
+
+static const char DIGITOS_HEX[] = "0123456789abcdef";
+
+/**
+ * @brief Máscara de los bits de host de un prefijo IPv6.
+ */
+static inline uint128_t bitsHostIPv6(int prefijo) {
+    return prefijo >= 128 ? uint128_t(0) : ~uint128_t(0) >> prefijo;
+}
+
+/**
+ * @brief Convierte hasta 4 dígitos hexadecimales en un grupo de 16 bits.
+ */
+static bool parseGrupoHex(string_view grupo, uint16_t& valor) noexcept {
+    if (grupo.empty() || grupo.size() > 4) {
+        return false;
+    }
+    unsigned v = 0;
+    for (char c : grupo) {
+        unsigned digito;
+        if (c >= '0' && c <= '9') {
+            digito = static_cast<unsigned>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            digito = static_cast<unsigned>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            digito = static_cast<unsigned>(c - 'A' + 10);
+        } else {
+            return false;
+        }
+        v = v * 16 + digito;
+    }
+    valor = static_cast<uint16_t>(v);
+    return true;
+}
+
+bool parseIPv6(string_view texto, uint128_t& ip) noexcept {
+    if (texto.size() < 2 || texto.size() > 45) {
+        return false;
+    }
+    uint16_t grupos[8];
+    int n = 0;
+    int posicionDobles = -1; // Cantidad de grupos antes de "::"
+    size_t i = 0;
+    if (texto[0] == ':') {
+        if (texto[1] != ':') {
+            return false;
+        }
+        posicionDobles = 0;
+        i = 2;
+    }
+    while (i < texto.size()) {
+        size_t finGrupo = texto.find(':', i);
+        if (finGrupo == string_view::npos) {
+            finGrupo = texto.size();
+        }
+        const string_view grupo = texto.substr(i, finGrupo - i);
+        if (grupo.find('.') != string_view::npos) {
+            // IPv4 incrustada: solo como últimos 32 bits
+            uint32_t ipv4;
+            if (finGrupo != texto.size() || n > 6 || parseIPv4(grupo, ipv4) != ErrorIPv4::Ninguno) {
+                return false;
+            }
+            grupos[n++] = static_cast<uint16_t>(ipv4 >> 16);
+            grupos[n++] = static_cast<uint16_t>(ipv4);
+            break;
+        }
+        if (n == 8 || !parseGrupoHex(grupo, grupos[n])) {
+            return false;
+        }
+        ++n;
+        if (finGrupo == texto.size()) {
+            break;
+        }
+        if (finGrupo + 1 < texto.size() && texto[finGrupo + 1] == ':') {
+            if (posicionDobles >= 0) {
+                return false; // Solo puede haber un "::"
+            }
+            posicionDobles = n;
+            i = finGrupo + 2;
+        } else {
+            i = finGrupo + 1;
+            if (i == texto.size()) {
+                return false; // ':' final suelto
+            }
+        }
+    }
+    if (posicionDobles < 0 ? n != 8 : n > 7) {
+        return false;
+    }
+
+    // Los grupos tras "::" van al final; los que faltan son ceros
+    const int ceros = 8 - n;
+    uint128_t valor = 0;
+    for (int g = 0, leidos = 0; g < 8; ++g) {
+        uint16_t grupo = 0;
+        if (posicionDobles < 0 || g < posicionDobles || g >= posicionDobles + ceros) {
+            grupo = grupos[leidos++];
+        }
+        valor = (valor << 16) | grupo;
+    }
+    ip = valor;
+    return true;
+}
+
+char* formatearIPv6(char* destino, uint128_t ip) {
+    uint16_t grupos[8];
+    for (int g = 7; g >= 0; --g) {
+        grupos[g] = static_cast<uint16_t>(ip);
+        ip >>= 16;
+    }
+    // La secuencia de ceros más larga (de al menos dos grupos) se reemplaza por "::"
+    int mejorInicio = -1;
+    int mejorLongitud = 1;
+    for (int g = 0; g < 8;) {
+        if (grupos[g] != 0) {
+            ++g;
+            continue;
+        }
+        int fin = g;
+        while (fin < 8 && grupos[fin] == 0) {
+            ++fin;
+        }
+        if (fin - g > mejorLongitud) {
+            mejorInicio = g;
+            mejorLongitud = fin - g;
+        }
+        g = fin;
+    }
+
+    char* p = destino;
+    for (int g = 0; g < 8; ++g) {
+        if (g == mejorInicio) {
+            *p++ = ':';
+            *p++ = ':';
+            g += mejorLongitud - 1;
+            continue;
+        }
+        if (g > 0 && g != mejorInicio + mejorLongitud) {
+            *p++ = ':';
+        }
+        const unsigned v = grupos[g];
+        bool escribir = false;
+        for (int desplazamiento = 12; desplazamiento >= 0; desplazamiento -= 4) {
+            const unsigned digito = (v >> desplazamiento) & 0xF;
+            escribir = escribir || digito != 0 || desplazamiento == 0;
+            if (escribir) {
+                *p++ = DIGITOS_HEX[digito];
+            }
+        }
+    }
+    return p;
+}
+
+string ipv6AString(uint128_t ip) {
+    char buffer[40];
+    return string(buffer, formatearIPv6(buffer, ip));
+}
+
+char* formatearEntero128(char* destino, uint128_t valor) {
+    if (valor <= UINT64_MAX) {
+        return BuferSalida::formatearEntero(destino, static_cast<uint64_t>(valor));
+    }
+    char temporal[40];
+    char* p = temporal + sizeof(temporal);
+    while (valor > 0) {
+        *--p = static_cast<char>('0' + static_cast<int>(valor % 10));
+        valor /= 10;
+    }
+    const size_t longitud = static_cast<size_t>(temporal + sizeof(temporal) - p);
+    memcpy(destino, p, longitud);
+    return destino + longitud;
+}
+
+/**
+ * @brief Convierte una cadena de dígitos decimales en un entero de 64 bits, sin desbordar.
+ */
+static bool parseDecimal(string_view texto, uint64_t& valor) {
+    if (texto.empty() || texto.size() > 19) {
+        return false;
+    }
+    uint64_t v = 0;
+    for (char c : texto) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        v = v * 10 + static_cast<uint64_t>(c - '0');
+    }
+    valor = v;
+    return true;
+}
+
+bool analizarRedIPv6(string_view texto, uint128_t& red, int& prefijo, string& error) {
+    const size_t barra = texto.find('/');
+    uint64_t valorPrefijo = 0;
+    if (barra == string_view::npos || !parseIPv6(texto.substr(0, barra), red) ||
+        !parseDecimal(texto.substr(barra + 1), valorPrefijo) || valorPrefijo > 128) {
+        error = "Error: Red IPv6 inválida '" + string(texto) + "'. Use 'IP/PREFIJO' con un prefijo entre 0 y 128 (ej. 2001:db8::/32).";
+        return false;
+    }
+    prefijo = static_cast<int>(valorPrefijo);
+    if ((red & bitsHostIPv6(prefijo)) != 0) {
+        error = "Error: La dirección IPv6 '" + string(texto.substr(0, barra)) + "' no es una dirección de red válida para el prefijo /" +
+                to_string(prefijo) + ". La dirección de red correcta sería: " + ipv6AString(red & ~bitsHostIPv6(prefijo)) + "/" +
+                to_string(prefijo) + ".";
+        return false;
+    }
+    return true;
+}
+
+bool analizarSolicitudIPv6(string_view texto, SolicitudIPv6& solicitud, string& error) {
+    solicitud.cantidad = 1;
+    const size_t x = texto.find_first_of("xX");
+    if (x != string_view::npos) {
+        if (!parseDecimal(texto.substr(x + 1), solicitud.cantidad) || solicitud.cantidad == 0) {
+            error = "Error: Cantidad de bloques inválida en la solicitud '" + string(texto) + "'.";
+            return false;
+        }
+        texto = texto.substr(0, x);
+    }
+    uint64_t valor = 0;
+    if (!texto.empty() && texto[0] == '/') {
+        if (!parseDecimal(texto.substr(1), valor) || valor > 128) {
+            error = "Error: Prefijo inválido en la solicitud '" + string(texto) + "' (debe estar entre /0 y /128).";
+            return false;
+        }
+        solicitud.cidr = static_cast<int>(valor);
+        solicitud.redes64 = 0;
+        return true;
+    }
+    if (!parseDecimal(texto, valor) || valor == 0) {
+        error = "Error: Solicitud IPv6 inválida '" + string(texto) + "'. Use /PREFIJO o un número de redes /64, con 'xN' opcional.";
+        return false;
+    }
+    // Bloque más pequeño con al menos 'valor' redes /64: /64 - ceil(log2(valor))
+    const int bits = valor == 1 ? 0 : 64 - __builtin_clzll(valor - 1);
+    solicitud.cidr = 64 - bits;
+    solicitud.redes64 = valor;
+    return true;
+}
+
+void planificarSubredesIPv6(PlanSubredesIPv6& plan, uint128_t redBase, int cidrBase, const vector<SolicitudIPv6>& solicitudes) {
+    plan.redBase = redBase;
+    plan.cidrBase = cidrBase;
+    plan.subredes.clear();
+    plan.fallidas.clear();
+    plan.espacioLibre.clear();
+
+    size_t total = 0;
+    for (const SolicitudIPv6& s : solicitudes) {
+        total += s.cantidad;
+    }
+    plan.subredes.reserve(total);
+    for (const SolicitudIPv6& s : solicitudes) {
+        plan.subredes.insert(plan.subredes.end(), s.cantidad, SubredIPv6{0, s.redes64, s.cidr});
+    }
+
+    AsignadorBloquesIPv6 asignador;
+    asignador.inicializar(redBase, cidrBase, {});
+    asignarSolicitudes(asignador, cidrBase, plan.subredes, [&](const SubredIPv6& subnet, MotivoFallo motivo) {
+        // Las solicitudes iguales llegan seguidas (ordenadas por prefijo): se agrupan en una sola línea
+        if (!plan.fallidas.empty()) {
+            SolicitudFallidaIPv6& ultima = plan.fallidas.back();
+            if (ultima.cidr == subnet.cidr && ultima.redes64 == subnet.redes64 && ultima.motivo == motivo) {
+                ++ultima.cantidad;
+                return;
+            }
+        }
+        plan.fallidas.push_back({subnet.redes64, subnet.cidr, motivo, 1, asignador.mayorBloqueLibre(),
+                                 asignador.direccionesLibres()});
+    });
+
+    asignador.rangosLibres(plan.espacioLibre);
+    plan.direccionesLibres = asignador.direccionesLibres();
+}
+
+// Ancho de cada columna de la tabla IPv6, en bytes
+static const int ANCHO_NUMERO_V6 = 9;
+static const int ANCHO_RED_V6 = 44;
+static const int ANCHO_DIRECCION_V6 = 41;
+
+/**
+ * @brief Escribe un entero de 128 bits en el búfer.
+ */
+static void escribirEntero128(BuferSalida& bufer, uint128_t valor) {
+    bufer.avanzar(formatearEntero128(bufer.reservar(40), valor));
+}
+
+/**
+ * @brief Escribe una cantidad de direcciones; con 'espacioEntero', el 0 representa 2^128 (todo ::/0).
+ */
+static void escribirDirecciones(BuferSalida& bufer, uint128_t cantidad, bool espacioEntero) {
+    if (cantidad == 0 && espacioEntero) {
+        bufer.texto("340282366920938463463374607431768211456");
+        return;
+    }
+    escribirEntero128(bufer, cantidad);
+}
+
+/**
+ * @brief Escribe una dirección IPv6 en el búfer, opcionalmente alineada en una columna.
+ */
+static void escribirIPv6(BuferSalida& bufer, uint128_t ip, int ancho = 0) {
+    char* inicio = bufer.reservar(static_cast<size_t>(ancho) + 40);
+    char* fin = formatearIPv6(inicio, ip);
+    while (fin < inicio + ancho) {
+        *fin++ = ' ';
+    }
+    bufer.avanzar(fin);
+}
+
+void imprimirPlanIPv6(ostream& os, const PlanSubredesIPv6& plan, bool is_csv_output) {
+    BuferSalida bufer(os);
+
+    if (is_csv_output) {
+        bufer.texto("Numero,Red,Prefijo,PrimeraDireccion,UltimaDireccion,Redes64Solicitadas\n");
+    } else {
+        bufer.texto("\n--- Resultados de Subneteo IPv6 ---\nRed Original: ");
+        escribirIPv6(bufer, plan.redBase);
+        bufer.caracter('/');
+        bufer.entero(static_cast<uint64_t>(plan.cidrBase));
+        bufer.texto(" (Direcciones: ");
+        escribirDirecciones(bufer, bitsHostIPv6(plan.cidrBase) + 1, true);
+        bufer.texto(")\n\n");
+        bufer.columna("#", ANCHO_NUMERO_V6);
+        bufer.columna("Red", ANCHO_RED_V6);
+        bufer.columna("Primera dirección", ANCHO_DIRECCION_V6 + 1); // La "ó" ocupa dos bytes
+        bufer.columna("Última dirección", ANCHO_DIRECCION_V6 + 1);  // La "Ú" ocupa dos bytes
+        bufer.texto("Solicitado\n");
+        bufer.texto(string(ANCHO_NUMERO_V6 + ANCHO_RED_V6 + 2 * ANCHO_DIRECCION_V6 + 20, '-'));
+        bufer.caracter('\n');
+    }
+
+    uint64_t numero = 0;
+    for (const SubredIPv6& subnet : plan.subredes) {
+        ++numero;
+        const uint128_t ultima = subnet.red | bitsHostIPv6(subnet.cidr);
+        if (is_csv_output) {
+            bufer.entero(numero);
+            bufer.caracter(',');
+            escribirIPv6(bufer, subnet.red);
+            bufer.texto(",/");
+            bufer.entero(static_cast<uint64_t>(subnet.cidr));
+            bufer.caracter(',');
+            escribirIPv6(bufer, subnet.red);
+            bufer.caracter(',');
+            escribirIPv6(bufer, ultima);
+            bufer.caracter(',');
+            bufer.entero(subnet.redes64);
+            bufer.caracter('\n');
+            continue;
+        }
+        char* inicio = bufer.reservar(ANCHO_NUMERO_V6 + ANCHO_RED_V6 + 20);
+        char* p = BuferSalida::formatearEntero(inicio, numero);
+        while (p < inicio + ANCHO_NUMERO_V6) *p++ = ' ';
+        char* inicioRed = p;
+        p = formatearIPv6(p, subnet.red);
+        *p++ = '/';
+        p = BuferSalida::formatearEntero(p, static_cast<uint64_t>(subnet.cidr));
+        while (p < inicioRed + ANCHO_RED_V6) *p++ = ' ';
+        bufer.avanzar(p);
+        escribirIPv6(bufer, subnet.red, ANCHO_DIRECCION_V6);
+        escribirIPv6(bufer, ultima, ANCHO_DIRECCION_V6);
+        if (subnet.redes64 > 0) {
+            bufer.entero(subnet.redes64);
+            bufer.texto(" redes /64\n");
+        } else {
+            bufer.caracter('/');
+            bufer.entero(static_cast<uint64_t>(subnet.cidr));
+            bufer.caracter('\n');
+        }
+    }
+    if (is_csv_output) {
+        return;
+    }
+
+    if (!plan.fallidas.empty()) {
+        bufer.texto("\nSolicitudes no asignadas:\n");
+        for (const SolicitudFallidaIPv6& f : plan.fallidas) {
+            bufer.texto("  - ");
+            if (f.cantidad > 1) {
+                bufer.entero(f.cantidad);
+                bufer.texto(" x ");
+            }
+            bufer.texto("Bloque /");
+            bufer.entero(static_cast<uint64_t>(f.cidr));
+            if (f.redes64 > 0) {
+                bufer.texto(" (");
+                bufer.entero(f.redes64);
+                bufer.texto(" redes /64)");
+            }
+            bufer.texto(": ");
+            switch (f.motivo) {
+                case MotivoFallo::HostsInvalidos:
+                    bufer.texto("la solicitud es inválida.");
+                    break;
+                case MotivoFallo::MayorQueRedBase:
+                    bufer.texto("es más grande que la red base (/");
+                    bufer.entero(static_cast<uint64_t>(plan.cidrBase));
+                    bufer.texto(").");
+                    break;
+                case MotivoFallo::SinEspacio:
+                    bufer.texto("sin espacio suficiente (direcciones libres: ");
+                    escribirEntero128(bufer, f.direccionesLibres);
+                    bufer.texto(").");
+                    break;
+                case MotivoFallo::Fragmentacion:
+                    bufer.texto("el espacio libre está fragmentado (direcciones libres: ");
+                    escribirEntero128(bufer, f.direccionesLibres);
+                    bufer.texto(", mayor bloque libre: /");
+                    bufer.entero(static_cast<uint64_t>(f.mayorBloqueLibre));
+                    bufer.texto(").");
+                    break;
+            }
+            bufer.caracter('\n');
+        }
+    }
+    bufer.caracter('\n');
+    if (!plan.espacioLibre.empty()) {
+        for (const RangoIPv6& libre : plan.espacioLibre) {
+            bufer.texto("Espacio remanente sin utilizar: ");
+            escribirIPv6(bufer, libre.inicio);
+            bufer.texto(" - ");
+            escribirIPv6(bufer, libre.fin);
+            bufer.caracter('\n');
+        }
+        bufer.texto("Total de direcciones remanentes: ");
+        escribirDirecciones(bufer, plan.direccionesLibres, true); // Hay espacio libre: 0 solo puede ser 2^128
+        bufer.caracter('\n');
+    } else {
+        bufer.texto("Toda la red ha sido utilizada o las solicitudes excedieron su capacidad.\n");
+    }
+    bufer.texto("-------------------------------------------\n");
+}
@@ -0,0 +1,125 @@
+#ifndef IPV6_H
+#define IPV6_H
+
+#include <cstdint>     // Para uint64_t
+#include <ostream>     // Para std::ostream
+#include <string>      // Para std::string
+#include <string_view> // Para std::string_view
+#include <vector>      // Para std::vector
+
+#include "asignador.h" // uint128_t, RangoIPv6 y el asignador genérico
+#include "subredes.h"  // MotivoFallo y el núcleo de planificación común
+
+/**
+ * @brief Convierte una dirección IPv6 en texto (RFC 4291: grupos hexadecimales, "::" y IPv4 final) a 128 bits.
+ * No reserva memoria.
+ * @param texto La dirección (ej. "2001:db8::1" o "::ffff:192.0.2.1").
+ * @param ip Recibe la dirección si es válida.
+ * @return Verdadero si la dirección es válida.
+ */
+bool parseIPv6(std::string_view texto, uint128_t& ip) noexcept;
+
+/**
+ * @brief Escribe una dirección IPv6 en su forma canónica comprimida (RFC 5952) en un buffer, sin reservar memoria.
+ * Hexadecimal en minúsculas, sin ceros a la izquierda, y "::" en lugar de la secuencia más larga
+ * (la primera si hay empate) de dos o más grupos a cero.
+ * @param destino Buffer con espacio para al menos 40 bytes (se escriben como mucho 39 caracteres, sin '\0').
+ * @param ip La dirección.
+ * @return Puntero al carácter siguiente al último escrito.
+ */
+char* formatearIPv6(char* destino, uint128_t ip);
+
+/**
+ * @brief Convierte una dirección IPv6 a texto (forma comprimida de RFC 5952).
+ */
+std::string ipv6AString(uint128_t ip);
+
+/**
+ * @brief Escribe un entero de 128 bits en decimal en un buffer.
+ * @param destino Buffer con espacio para al menos 40 bytes.
+ * @return Puntero al carácter siguiente al último escrito.
+ */
+char* formatearEntero128(char* destino, uint128_t valor);
+
+/**
+ * @brief Analiza una red IPv6 en formato "IP/PREFIJO" (ej. "2001:db8::/32").
+ * @param texto La red.
+ * @param red Recibe la dirección de red.
+ * @param prefijo Recibe el prefijo (0-128).
+ * @param error Recibe el mensaje de error si la red es inválida o no está alineada a su prefijo.
+ * @return Verdadero si la red es válida.
+ */
+bool analizarRedIPv6(std::string_view texto, uint128_t& red, int& prefijo, std::string& error);
+
+/**
+ * @brief Una solicitud de subredes IPv6: 'cantidad' bloques del prefijo indicado.
+ */
+struct SolicitudIPv6 {
+    int cidr;
+    uint64_t redes64;  // Redes /64 pedidas (0 si la solicitud se hizo por prefijo)
+    uint64_t cantidad; // Número de bloques iguales
+};
+
+/**
+ * @brief Analiza una solicitud IPv6: "/P" (un bloque /P) o "N" (el bloque más pequeño que contiene
+ * N redes /64, la unidad habitual de una red IPv6), con un sufijo opcional "xM" para M bloques iguales
+ * (ej. "/64x1000000" o "300x4", cuatro bloques /55).
+ * @param texto La solicitud.
+ * @param solicitud Recibe la solicitud.
+ * @param error Recibe el mensaje de error.
+ * @return Verdadero si la solicitud es válida.
+ */
+bool analizarSolicitudIPv6(std::string_view texto, SolicitudIPv6& solicitud, std::string& error);
+
+/**
+ * @brief Una subred IPv6 asignada.
+ */
+struct SubredIPv6 {
+    uint128_t red;
+    uint64_t redes64; // Redes /64 pedidas (0 si se pidió por prefijo)
+    int cidr;
+};
+
+/**
+ * @brief Solicitudes IPv6 iguales y consecutivas que no pudieron asignarse por el mismo motivo.
+ */
+struct SolicitudFallidaIPv6 {
+    uint64_t redes64;
+    int cidr;
+    MotivoFallo motivo;
+    uint64_t cantidad;           // Cuántas solicitudes iguales fallaron seguidas
+    int mayorBloqueLibre;        // Prefijo del mayor bloque libre en el primer fallo (-1 si no había)
+    uint128_t direccionesLibres; // Direcciones libres en el primer fallo
+};
+
+/**
+ * @brief Plan de subneteo de una red base IPv6.
+ */
+struct PlanSubredesIPv6 {
+    uint128_t redBase = 0;
+    int cidrBase = 0;
+    std::vector<SubredIPv6> subredes;           // Subredes en orden de asignación (de mayor a menor)
+    std::vector<SolicitudFallidaIPv6> fallidas;
+    std::vector<RangoIPv6> espacioLibre;        // Espacio libre tras el plan, en rangos contiguos
+    uint128_t direccionesLibres = 0;            // En ::/0, 0 también es el espacio entero si 'espacioLibre' no está vacío
+};
+
+/**
+ * @brief Calcula el plan de subredes de una red base IPv6 con el mismo núcleo que IPv4 (asignador "buddy").
+ * @param plan Recibe el plan (se reutiliza su memoria).
+ * @param redBase Dirección de red base (alineada a su prefijo).
+ * @param cidrBase Prefijo de la red base (0-128).
+ * @param solicitudes Solicitudes, cada una con su cantidad de bloques.
+ */
+void planificarSubredesIPv6(PlanSubredesIPv6& plan, uint128_t redBase, int cidrBase,
+                            const std::vector<SolicitudIPv6>& solicitudes);
+
+/**
+ * @brief Imprime un plan IPv6: resumen, tabla (o CSV) de subredes, solicitudes fallidas y espacio libre.
+ * @param os Flujo de salida.
+ * @param plan El plan.
+ * @param is_csv_output Verdadero para CSV (solo las subredes).
+ */
+void imprimirPlanIPv6(std::ostream& os, const PlanSubredesIPv6& plan, bool is_csv_output);
+
+#endif // IPV6_H
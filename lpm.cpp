@@ -0,0 +1,100 @@
+#include "lpm.h"
+
+#include <algorithm> // Para std::sort, std::fill
+#include <cstdlib>   // Para calloc, free
+#include <new>       // Para std::bad_alloc
+
+using namespace std;
+
+// Entradas de la tabla directa por página de 4 KiB (para estimar la memoria física usada)
+static const size_t ENTRADAS_POR_PAGINA = 4096 / sizeof(uint32_t);
+
+TablaLPM::TablaLPM()
+    : directa(static_cast<uint32_t*>(calloc(ENTRADAS_DIRECTA, sizeof(uint32_t)))),
+      paginasTocadas(ENTRADAS_DIRECTA / ENTRADAS_POR_PAGINA, false) {
+    if (!directa) {
+        throw bad_alloc();
+    }
+}
+
+TablaLPM::~TablaLPM() {
+    free(directa);
+}
+
+void TablaLPM::construir(const vector<BloqueIPv4>& bloques) {
+    // Se parte de una tabla vacía: solo se limpian las páginas usadas anteriormente
+    for (size_t pagina = 0; pagina < paginasTocadas.size(); ++pagina) {
+        if (paginasTocadas[pagina]) {
+            fill(directa + pagina * ENTRADAS_POR_PAGINA, directa + (pagina + 1) * ENTRADAS_POR_PAGINA, 0u);
+            paginasTocadas[pagina] = false;
+        }
+    }
+    grupos.clear();
+
+    // Insertar de menos a más específico hace que los prefijos largos sobrescriban a los cortos
+    vector<uint32_t> orden(bloques.size());
+    for (uint32_t i = 0; i < orden.size(); ++i) {
+        orden[i] = i;
+    }
+    stable_sort(orden.begin(), orden.end(), [&](uint32_t a, uint32_t b) { return bloques[a].cidr < bloques[b].cidr; });
+
+    for (uint32_t i : orden) {
+        const BloqueIPv4& b = bloques[i];
+        const uint32_t valor = i + 1;
+        if (b.cidr <= 24) {
+            const size_t inicio = b.red >> 8;
+            const size_t cantidad = size_t(1) << (24 - b.cidr);
+            for (size_t pagina = inicio / ENTRADAS_POR_PAGINA; pagina <= (inicio + cantidad - 1) / ENTRADAS_POR_PAGINA; ++pagina) {
+                paginasTocadas[pagina] = true;
+            }
+            for (size_t k = inicio; k < inicio + cantidad; ++k) {
+                // Un grupo existente solo puede venir de un prefijo más largo que ya cubre parte del /24;
+                // como se inserta en orden creciente de prefijo, aquí no los hay y se puede sobrescribir
+                directa[k] = valor;
+            }
+        } else {
+            uint32_t& entrada = directa[b.red >> 8];
+            paginasTocadas[(b.red >> 8) / ENTRADAS_POR_PAGINA] = true;
+            if (!(entrada & BIT_GRUPO)) {
+                // Nuevo grupo, heredando la coincidencia menos específica que ya tenía el /24
+                const uint32_t grupo = static_cast<uint32_t>(grupos.size() / 256);
+                grupos.resize(grupos.size() + 256, entrada);
+                entrada = BIT_GRUPO | grupo;
+            }
+            const size_t base = (size_t(entrada & ~BIT_GRUPO) << 8) | (b.red & 0xFF);
+            fill(grupos.begin() + static_cast<ptrdiff_t>(base),
+                 grupos.begin() + static_cast<ptrdiff_t>(base + (size_t(1) << (32 - b.cidr))), valor);
+        }
+    }
+}
+
+void TablaLPM::buscarLote(const uint32_t* ips, size_t n, uint32_t* resultados) const {
+    // Primero se leen las entradas directas de 8 direcciones (accesos independientes que la CPU
+    // puede solapar) y después se resuelven los grupos secundarios
+    const size_t BLOQUE = 8;
+    size_t i = 0;
+    for (; i + BLOQUE <= n; i += BLOQUE) {
+        uint32_t entradas[BLOQUE];
+        for (size_t k = 0; k < BLOQUE; ++k) {
+            entradas[k] = directa[ips[i + k] >> 8];
+        }
+        for (size_t k = 0; k < BLOQUE; ++k) {
+            uint32_t e = entradas[k];
+            if (e & BIT_GRUPO) {
+                e = grupos[((e & ~BIT_GRUPO) << 8) | (ips[i + k] & 0xFF)];
+            }
+            resultados[i + k] = e - 1;
+        }
+    }
+    for (; i < n; ++i) {
+        resultados[i] = buscar(ips[i]);
+    }
+}
+
+size_t TablaLPM::memoriaUsada() const {
+    size_t paginas = 0;
+    for (bool tocada : paginasTocadas) {
+        paginas += tocada;
+    }
+    return paginas * 4096 + grupos.size() * sizeof(uint32_t);
+}
@@ -0,0 +1,74 @@
+#ifndef LPM_H
+#define LPM_H
+
+#include <cstddef> // Para size_t
+#include <cstdint> // Para uint32_t y otros tipos enteros de ancho fijo
+#include <vector>  // Para std::vector
+
+#include "asignador.h" // Para BloqueIPv4
+
+/**
+ * @brief Tabla de búsqueda por prefijo más largo (longest-prefix match) con el esquema DIR-24-8.
+ *
+ * Una tabla directa de 2^24 entradas indexada por los 24 bits altos de la dirección resuelve en un
+ * solo acceso los prefijos de hasta /24; los prefijos más largos usan grupos secundarios de 256
+ * entradas (uno por cada /24 que los contiene), con lo que ninguna búsqueda hace más de dos accesos.
+ * Cada entrada guarda el índice del bloque + 1 (0 = sin coincidencia); si el bit alto está activo,
+ * los bits restantes son el número de grupo secundario.
+ *
+ * La tabla directa ocupa 64 MiB de memoria virtual, reservada a cero bajo demanda: solo consumen
+ * memoria física las páginas que cubren los bloques insertados.
+ */
+class TablaLPM {
+public:
+    static const uint32_t SIN_COINCIDENCIA = 0xFFFFFFFFu;
+
+    TablaLPM();
+    ~TablaLPM();
+    TablaLPM(const TablaLPM&) = delete;
+    TablaLPM& operator=(const TablaLPM&) = delete;
+
+    /**
+     * @brief Construye la tabla a partir de una lista de bloques (pueden anidarse).
+     * El valor asociado a cada bloque es su posición en 'bloques'.
+     * @param bloques Los bloques a insertar (como máximo 2^31 - 1).
+     */
+    void construir(const std::vector<BloqueIPv4>& bloques);
+
+    /**
+     * @brief Busca una dirección.
+     * @param ip La dirección.
+     * @return La posición del bloque más específico que la contiene, o SIN_COINCIDENCIA.
+     */
+    uint32_t buscar(uint32_t ip) const {
+        uint32_t entrada = directa[ip >> 8];
+        if (entrada & BIT_GRUPO) {
+            entrada = grupos[((entrada & ~BIT_GRUPO) << 8) | (ip & 0xFF)];
+        }
+        return entrada - 1; // 0 - 1 = SIN_COINCIDENCIA
+    }
+
+    /**
+     * @brief Busca un lote de direcciones, solapando los accesos a memoria de búsquedas consecutivas.
+     * @param ips Las direcciones.
+     * @param n Cantidad de direcciones.
+     * @param resultados Recibe, para cada dirección, lo mismo que devolvería buscar().
+     */
+    void buscarLote(const uint32_t* ips, size_t n, uint32_t* resultados) const;
+
+    /** @brief Memoria física aproximada en bytes (páginas tocadas de la tabla directa + grupos). */
+    size_t memoriaUsada() const;
+
+    /** @brief Cantidad de grupos secundarios de 256 entradas. */
+    size_t cantidadGrupos() const { return grupos.size() / 256; }
+
+private:
+    static const uint32_t BIT_GRUPO = 0x80000000u;
+    static const size_t ENTRADAS_DIRECTA = size_t(1) << 24;
+
+    uint32_t* directa;              // 2^24 entradas, reservadas con calloc (páginas a cero bajo demanda)
+    std::vector<uint32_t> grupos;   // Grupos secundarios de 256 entradas, consecutivos
+    std::vector<bool> paginasTocadas;
+};
+
+#endif // LPM_H
@@ -0,0 +1,309 @@
+#include "plan_binario.h"
+
+#include <cstdio>  // Para tmpfile, fwrite, fread
+#include <cstring> // Para memcpy, memcmp
+
+#ifndef _WIN32
+#include <fcntl.h>    // Para open
+#include <sys/mman.h> // Para mmap, munmap
+#include <sys/stat.h> // Para fstat
+#include <unistd.h>   // Para close
+#endif
+
+using namespace std;
+
+static const char MAGIA_PLAN[8] = {'S', 'U', 'B', 'P', 'L', 'A', 'N', '1'};
+static const uint16_t VERSION_PLAN = 1;
+static const uint32_t MARCA_ORDEN = 0x01020304u;
+
+/**
+ * @brief Redondea hacia arriba a múltiplo de 8 (los datos adicionales quedan alineados).
+ */
+static inline uint64_t alinear8(uint64_t n) {
+    return (n + 7) & ~uint64_t(7);
+}
+
+/**
+ * @brief Copia el contenido de un archivo temporal (desde el principio) al final de 'destino'.
+ * @return Falso si la lectura falló.
+ */
+static bool copiarTemporal(FILE* temporal, ofstream& destino) {
+    char bufer[1 << 16];
+    rewind(temporal);
+    size_t leidos;
+    while ((leidos = fread(bufer, 1, sizeof(bufer), temporal)) > 0) {
+        destino.write(bufer, static_cast<streamsize>(leidos));
+    }
+    return !ferror(temporal);
+}
+
+EscritorPlanBinario::~EscritorPlanBinario() {
+    cerrarTemporales();
+}
+
+void EscritorPlanBinario::cerrarTemporales() {
+    if (indice) {
+        fclose(indice);
+        indice = nullptr;
+    }
+    if (datos) {
+        fclose(datos);
+        datos = nullptr;
+    }
+}
+
+bool EscritorPlanBinario::abrir(const string& rutaArchivo, bool lote, string& error) {
+    ruta = rutaArchivo;
+    esLote = lote;
+    cantidadRegistros = 0;
+    cantidadPlanes = 0;
+    tamanoDatos = 0;
+    falloTemporal = false;
+    cerrarTemporales();
+    // tmpfile() borra los temporales al cerrarlos o al terminar el programa
+    indice = tmpfile();
+    datos = tmpfile();
+    if (!indice || !datos) {
+        cerrarTemporales();
+        error = "Error: No se pudieron crear los archivos temporales para '" + ruta + "'.";
+        return false;
+    }
+    archivo.open(ruta, ios::binary | ios::trunc);
+    if (!archivo.is_open()) {
+        cerrarTemporales();
+        error = "Error: No se pudo crear el archivo binario '" + ruta + "'.";
+        return false;
+    }
+    // Cabecera provisional (sin magia): se reescribe al cerrar
+    CabeceraPlanBinario vacia{};
+    archivo.write(reinterpret_cast<const char*>(&vacia), sizeof(vacia));
+    return true;
+}
+
+void EscritorPlanBinario::agregar(const PlanSubredes& plan, long long numeroTrabajo, long long numeroLinea) {
+    // Escribe en el temporal de datos y lleva la cuenta de su tamaño
+    auto anexar = [&](const void* origen, size_t cantidad) {
+        falloTemporal = falloTemporal || fwrite(origen, 1, cantidad, datos) != cantidad;
+        tamanoDatos += cantidad;
+    };
+
+    EntradaIndicePlan e{};
+    e.primerRegistro = cantidadRegistros;
+    e.desplazamientoDatos = tamanoDatos;
+    e.direccionesLibres = plan.direccionesLibres;
+    e.numeroTrabajo = numeroTrabajo;
+    e.numeroLinea = numeroLinea;
+    e.cantidadSubredes = static_cast<uint32_t>(plan.subredes.size());
+    e.redBase = plan.redBase;
+    e.cantidadReservados = static_cast<uint32_t>(plan.reservados.size());
+    e.cantidadFallidas = static_cast<uint32_t>(plan.fallidas.size());
+    e.cantidadLibres = static_cast<uint32_t>(plan.espacioLibre.size());
+    e.longitudIpBase = static_cast<uint16_t>(min<size_t>(plan.ipBaseStr.size(), 0xFFFF));
+    e.cidrBase = static_cast<uint8_t>(plan.cidrBase);
+    e.resultado = static_cast<uint8_t>(plan.resultado);
+    falloTemporal = falloTemporal || fwrite(&e, sizeof(e), 1, indice) != 1;
+    ++cantidadPlanes;
+
+    static const char ceros[8] = {};
+    anexar(plan.ipBaseStr.data(), e.longitudIpBase);
+    anexar(ceros, static_cast<size_t>(alinear8(tamanoDatos) - tamanoDatos));
+    anexar(plan.reservados.data(), plan.reservados.size() * sizeof(RangoIPv4));
+    for (const SolicitudFallida& f : plan.fallidas) {
+        FallidaBinaria b{};
+        b.hostsSolicitados = f.hostsSolicitados;
+        b.cidr = static_cast<int8_t>(f.cidr);
+        b.motivo = static_cast<uint8_t>(f.motivo);
+        b.mayorBloqueLibre = static_cast<int8_t>(f.mayorBloqueLibre);
+        b.direccionesLibres = f.direccionesLibres;
+        anexar(&b, sizeof(b));
+    }
+    anexar(plan.espacioLibre.data(), plan.espacioLibre.size() * sizeof(RangoIPv4));
+
+    archivo.write(reinterpret_cast<const char*>(plan.subredes.data()),
+                  static_cast<streamsize>(plan.subredes.size() * sizeof(Subred)));
+    cantidadRegistros += plan.subredes.size();
+}
+
+bool EscritorPlanBinario::cerrar(string& error) {
+    CabeceraPlanBinario c{};
+    c.version = VERSION_PLAN;
+    c.tamanoRegistro = sizeof(Subred);
+    c.tamanoEntradaIndice = sizeof(EntradaIndicePlan);
+    c.esLote = esLote ? 1 : 0;
+    c.cantidadPlanes = cantidadPlanes;
+    c.cantidadRegistros = cantidadRegistros;
+    c.desplazamientoRegistros = sizeof(CabeceraPlanBinario);
+    c.marcaOrden = MARCA_ORDEN;
+
+    // Relleno para que el índice quede alineado a 8 bytes
+    uint64_t posicion = c.desplazamientoRegistros + cantidadRegistros * sizeof(Subred);
+    static const char ceros[8] = {};
+    archivo.write(ceros, static_cast<streamsize>(alinear8(posicion) - posicion));
+    c.desplazamientoIndice = alinear8(posicion);
+    c.desplazamientoDatos = c.desplazamientoIndice + cantidadPlanes * sizeof(EntradaIndicePlan);
+    bool correcto = !falloTemporal && fflush(indice) == 0 && fflush(datos) == 0;
+    correcto = correcto && copiarTemporal(indice, archivo) && copiarTemporal(datos, archivo);
+    cerrarTemporales();
+
+    // La magia se escribe al final: un archivo interrumpido no se confunde con uno completo
+    if (correcto) {
+        memcpy(c.magia, MAGIA_PLAN, sizeof(MAGIA_PLAN));
+        archivo.seekp(0);
+        archivo.write(reinterpret_cast<const char*>(&c), sizeof(c));
+    }
+    archivo.close();
+    if (!correcto || archivo.fail()) {
+        error = "Error: No se pudo escribir el archivo binario '" + ruta + "'.";
+        return false;
+    }
+    return true;
+}
+
+LectorPlanBinario::~LectorPlanBinario() {
+    cerrar();
+}
+
+void LectorPlanBinario::cerrar() {
+#ifndef _WIN32
+    if (mapa) {
+        munmap(const_cast<unsigned char*>(mapa), tamanoMapa);
+    }
+    if (descriptor >= 0) {
+        close(descriptor);
+    }
+#endif
+    mapa = nullptr;
+    tamanoMapa = 0;
+    descriptor = -1;
+}
+
+bool LectorPlanBinario::abrir(const string& ruta, string& error) {
+    cerrar();
+#ifndef _WIN32
+    descriptor = open(ruta.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        error = "Error: No se pudo abrir el archivo binario '" + ruta + "'.";
+        return false;
+    }
+    struct stat info;
+    if (fstat(descriptor, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(CabeceraPlanBinario)) {
+        error = "Error: El archivo '" + ruta + "' no es un archivo de planes válido.";
+        cerrar();
+        return false;
+    }
+    tamanoMapa = static_cast<size_t>(info.st_size);
+    void* p = mmap(nullptr, tamanoMapa, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (p == MAP_FAILED) {
+        tamanoMapa = 0;
+        error = "Error: No se pudo mapear el archivo binario '" + ruta + "'.";
+        cerrar();
+        return false;
+    }
+    mapa = static_cast<const unsigned char*>(p);
+
+    // Validación de la cabecera y de que cada sección y cada entrada del índice están dentro del archivo
+    const CabeceraPlanBinario* c = cabecera();
+    const uint64_t tamano = tamanoMapa;
+    bool valido = memcmp(c->magia, MAGIA_PLAN, sizeof(MAGIA_PLAN)) == 0 && c->version == VERSION_PLAN &&
+                  c->tamanoRegistro == sizeof(Subred) && c->tamanoEntradaIndice == sizeof(EntradaIndicePlan) &&
+                  c->marcaOrden == MARCA_ORDEN && c->desplazamientoRegistros == sizeof(CabeceraPlanBinario) &&
+                  c->cantidadRegistros <= (tamano - c->desplazamientoRegistros) / sizeof(Subred) &&
+                  c->desplazamientoIndice >= c->desplazamientoRegistros + c->cantidadRegistros * sizeof(Subred) &&
+                  c->desplazamientoIndice <= tamano && c->desplazamientoIndice % 8 == 0 &&
+                  c->cantidadPlanes <= (tamano - c->desplazamientoIndice) / sizeof(EntradaIndicePlan) &&
+                  c->desplazamientoDatos == c->desplazamientoIndice + c->cantidadPlanes * sizeof(EntradaIndicePlan);
+    const uint64_t tamanoDatos = valido ? tamano - c->desplazamientoDatos : 0;
+    for (size_t i = 0; valido && i < cantidadPlanes(); ++i) {
+        const EntradaIndicePlan& e = entrada(i);
+        const uint64_t bytesDatos = alinear8(e.longitudIpBase) +
+                                    (uint64_t(e.cantidadReservados) + e.cantidadLibres) * sizeof(RangoIPv4) +
+                                    uint64_t(e.cantidadFallidas) * sizeof(FallidaBinaria);
+        valido = e.primerRegistro <= c->cantidadRegistros &&
+                 e.cantidadSubredes <= c->cantidadRegistros - e.primerRegistro &&
+                 e.desplazamientoDatos % 8 == 0 && e.desplazamientoDatos <= tamanoDatos &&
+                 bytesDatos <= tamanoDatos - e.desplazamientoDatos && e.cidrBase <= 32 &&
+                 e.resultado <= static_cast<uint8_t>(ResultadoPlan::RedInvalida);
+        // Los motivos de las solicitudes fallidas también son enumerados: un valor desconocido es un archivo dañado
+        const unsigned char* fallidas = mapa + c->desplazamientoDatos + e.desplazamientoDatos + alinear8(e.longitudIpBase) +
+                                        uint64_t(e.cantidadReservados) * sizeof(RangoIPv4);
+        for (uint32_t f = 0; valido && f < e.cantidadFallidas; ++f) {
+            FallidaBinaria b;
+            memcpy(&b, fallidas + f * sizeof(FallidaBinaria), sizeof(b));
+            valido = b.motivo <= static_cast<uint8_t>(MotivoFallo::Fragmentacion);
+        }
+    }
+    if (!valido) {
+        error = "Error: El archivo '" + ruta + "' no es un archivo de planes válido o está dañado.";
+        cerrar();
+        return false;
+    }
+    return true;
+#else
+    (void)ruta;
+    error = "Error: La lectura de planes binarios no está disponible en Windows.";
+    return false;
+#endif
+}
+
+VistaSubredes LectorPlanBinario::registros() const {
+    const Subred* inicio = reinterpret_cast<const Subred*>(mapa + cabecera()->desplazamientoRegistros);
+    return {inicio, inicio + cantidadRegistros()};
+}
+
+const EntradaIndicePlan& LectorPlanBinario::entrada(size_t indice) const {
+    return reinterpret_cast<const EntradaIndicePlan*>(mapa + cabecera()->desplazamientoIndice)[indice];
+}
+
+VistaSubredes LectorPlanBinario::subredesDe(size_t indice) const {
+    const EntradaIndicePlan& e = entrada(indice);
+    const Subred* inicio = registros().inicio + e.primerRegistro;
+    return {inicio, inicio + e.cantidadSubredes};
+}
+
+void LectorPlanBinario::reconstruirPlan(size_t indice, PlanSubredes& plan) const {
+    const EntradaIndicePlan& e = entrada(indice);
+    const unsigned char* p = mapa + cabecera()->desplazamientoDatos + e.desplazamientoDatos;
+
+    plan.ipBaseStr.assign(reinterpret_cast<const char*>(p), e.longitudIpBase);
+    p += alinear8(e.longitudIpBase);
+    plan.cidrBase = e.cidrBase;
+    plan.redBase = e.redBase;
+    plan.broadcastBase = broadcastDe(DireccionIPv4(e.redBase), PrefijoIPv4(e.cidrBase)).valor;
+    plan.resultado = static_cast<ResultadoPlan>(e.resultado);
+    plan.direccionesLibres = e.direccionesLibres;
+
+    plan.reservados.resize(e.cantidadReservados);
+    memcpy(plan.reservados.data(), p, e.cantidadReservados * sizeof(RangoIPv4));
+    p += e.cantidadReservados * sizeof(RangoIPv4);
+
+    plan.fallidas.clear();
+    for (uint32_t i = 0; i < e.cantidadFallidas; ++i, p += sizeof(FallidaBinaria)) {
+        FallidaBinaria b;
+        memcpy(&b, p, sizeof(b));
+        plan.fallidas.push_back({b.hostsSolicitados, b.cidr, static_cast<MotivoFallo>(b.motivo),
+                                 b.mayorBloqueLibre, b.direccionesLibres});
+    }
+
+    plan.espacioLibre.resize(e.cantidadLibres);
+    memcpy(plan.espacioLibre.data(), p, e.cantidadLibres * sizeof(RangoIPv4));
+
+    const VistaSubredes subredes = subredesDe(indice);
+    plan.subredes.assign(subredes.begin(), subredes.end());
+}
+
+void convertirPlanBinario(const LectorPlanBinario& lector, ostream& os, FormatoSalida formato) {
+    ImpresorPlan impresor;
+    impresor.agregarDestino(os, formato);
+    PlanSubredes plan; // Se reutiliza entre planes
+    for (size_t i = 0; i < lector.cantidadPlanes(); ++i) {
+        lector.reconstruirPlan(i, plan);
+        const EntradaIndicePlan& e = lector.entrada(i);
+        if (lector.esLote()) {
+            const string titulo = "Trabajo " + to_string(e.numeroTrabajo) + " (línea " + to_string(e.numeroLinea) +
+                                  "): " + plan.ipBaseStr + "/" + to_string(plan.cidrBase);
+            impresor.imprimirTrabajo(plan, e.numeroTrabajo, titulo);
+        } else {
+            impresor.imprimir(plan);
+        }
+    }
+}
@@ -0,0 +1,206 @@
+#ifndef PLAN_BINARIO_H
+#define PLAN_BINARIO_H
+
+#include <cstddef> // Para size_t
+#include <cstdint> // Para uint32_t y otros tipos enteros de ancho fijo
+#include <cstdio>  // Para std::FILE (archivos temporales del escritor)
+#include <fstream> // Para std::ofstream
+#include <string>  // Para std::string
+#include <vector>  // Para std::vector
+
+#include "subredes.h" // Subred y PlanSubredes
+
+/**
+ * @brief Cabecera de un archivo de planes binario (.sbp, 64 bytes, orden de bytes nativo).
+ *
+ * Disposición del archivo:
+ *   cabecera | registros (Subred, 12 bytes cada uno, de todos los planes seguidos)
+ *            | índice (una EntradaIndicePlan por plan) | datos adicionales de cada plan
+ * Los registros de un plan son contiguos: el índice indica el primero y la cantidad.
+ */
+struct CabeceraPlanBinario {
+    char magia[8];                   // "SUBPLAN1"
+    uint16_t version;
+    uint16_t tamanoRegistro;         // sizeof(Subred)
+    uint16_t tamanoEntradaIndice;    // sizeof(EntradaIndicePlan)
+    uint8_t esLote;                  // 1 si los planes son trabajos de un lote (con número de trabajo y línea)
+    uint8_t relleno;
+    uint64_t cantidadPlanes;
+    uint64_t cantidadRegistros;
+    uint64_t desplazamientoRegistros;
+    uint64_t desplazamientoIndice;
+    uint64_t desplazamientoDatos;    // Inicio de los datos adicionales
+    uint32_t marcaOrden;             // 0x01020304 escrito en el orden de bytes del equipo que generó el archivo
+    uint32_t reservado;
+};
+
+/**
+ * @brief Entrada del índice: ubicación de los registros de un plan y su resumen (64 bytes).
+ *
+ * Los datos adicionales de cada plan, a partir de desplazamientoDatos (relativo a la sección de
+ * datos), son: la IP base tal como se recibió (longitudIpBase bytes, rellenada hasta múltiplo de 8),
+ * los rangos reservados (RangoIPv4), las solicitudes fallidas (FallidaBinaria) y el espacio libre
+ * (RangoIPv4).
+ */
+struct EntradaIndicePlan {
+    uint64_t primerRegistro;
+    uint64_t desplazamientoDatos;
+    uint64_t direccionesLibres;
+    int64_t numeroTrabajo;     // 0 si el plan no pertenece a un lote
+    int64_t numeroLinea;
+    uint32_t cantidadSubredes;
+    uint32_t redBase;
+    uint32_t cantidadReservados;
+    uint32_t cantidadFallidas;
+    uint32_t cantidadLibres;
+    uint16_t longitudIpBase;
+    uint8_t cidrBase;
+    uint8_t resultado;         // ResultadoPlan
+};
+
+/**
+ * @brief Solicitud fallida en el archivo binario (16 bytes).
+ */
+struct FallidaBinaria {
+    int32_t hostsSolicitados;
+    int8_t cidr;
+    uint8_t motivo;            // MotivoFallo
+    int8_t mayorBloqueLibre;
+    uint8_t relleno;
+    uint64_t direccionesLibres;
+};
+
+static_assert(sizeof(CabeceraPlanBinario) == 64, "CabeceraPlanBinario debe ocupar 64 bytes");
+static_assert(sizeof(EntradaIndicePlan) == 64, "EntradaIndicePlan debe ocupar 64 bytes");
+static_assert(sizeof(FallidaBinaria) == 16, "FallidaBinaria debe ocupar 16 bytes");
+
+/**
+ * @brief Escribe planes en un archivo binario.
+ * Los registros de subred se escriben a medida que llegan los planes; el índice y los datos
+ * adicionales van a dos archivos temporales y se copian, junto con la cabecera definitiva, al
+ * cerrar. La memoria usada no depende de la cantidad de planes.
+ */
+class EscritorPlanBinario {
+public:
+    EscritorPlanBinario() = default;
+    ~EscritorPlanBinario();
+    EscritorPlanBinario(const EscritorPlanBinario&) = delete;
+    EscritorPlanBinario& operator=(const EscritorPlanBinario&) = delete;
+
+    /**
+     * @brief Crea (o reemplaza) el archivo.
+     * @param ruta Ruta del archivo.
+     * @param esLote Verdadero si se van a escribir trabajos de un lote.
+     * @param error Recibe el mensaje de error.
+     * @return Verdadero si el archivo quedó abierto.
+     */
+    bool abrir(const std::string& ruta, bool esLote, std::string& error);
+
+    /**
+     * @brief Añade un plan.
+     * @param plan El plan.
+     * @param numeroTrabajo Número de trabajo en el lote (0 si no es un lote).
+     * @param numeroLinea Línea de la entrada de la que procede el trabajo (0 si no es un lote).
+     */
+    void agregar(const PlanSubredes& plan, long long numeroTrabajo = 0, long long numeroLinea = 0);
+
+    /**
+     * @brief Escribe el índice, los datos adicionales y la cabecera, y cierra el archivo.
+     * @param error Recibe el mensaje de error.
+     * @return Verdadero si todo se escribió correctamente.
+     */
+    bool cerrar(std::string& error);
+
+private:
+    void cerrarTemporales();
+
+    std::ofstream archivo;
+    std::string ruta;
+    bool esLote = false;
+    uint64_t cantidadRegistros = 0;
+    uint64_t cantidadPlanes = 0;
+    uint64_t tamanoDatos = 0;           // Bytes escritos en 'datos'
+    std::FILE* indice = nullptr;        // Temporal: una EntradaIndicePlan por plan
+    std::FILE* datos = nullptr;         // Temporal: datos adicionales de cada plan
+    bool falloTemporal = false;         // Alguna escritura en los temporales falló
+};
+
+/**
+ * @brief Vista de los registros de un plan dentro del archivo mapeado (no copia nada).
+ */
+struct VistaSubredes {
+    const Subred* inicio = nullptr;
+    const Subred* fin = nullptr;
+
+    const Subred* begin() const { return inicio; }
+    const Subred* end() const { return fin; }
+    size_t size() const { return static_cast<size_t>(fin - inicio); }
+};
+
+/**
+ * @brief Lector de archivos de planes binarios mapeados en memoria (solo lectura).
+ * Abrir el archivo valida la cabecera y el índice; los registros se recorren directamente
+ * sobre el mapa, sin analizar ni copiar.
+ */
+class LectorPlanBinario {
+public:
+    LectorPlanBinario() = default;
+    ~LectorPlanBinario();
+    LectorPlanBinario(const LectorPlanBinario&) = delete;
+    LectorPlanBinario& operator=(const LectorPlanBinario&) = delete;
+
+    /**
+     * @brief Abre y mapea un archivo de planes.
+     * @param ruta Ruta del archivo.
+     * @param error Recibe el mensaje de error.
+     * @return Verdadero si el archivo es válido y quedó abierto.
+     */
+    bool abrir(const std::string& ruta, std::string& error);
+
+    /** @brief Verdadero si los planes son trabajos de un lote. */
+    bool esLote() const { return cabecera()->esLote != 0; }
+    /** @brief Cantidad de planes del archivo. */
+    size_t cantidadPlanes() const { return static_cast<size_t>(cabecera()->cantidadPlanes); }
+    /** @brief Cantidad total de subredes de todos los planes. */
+    size_t cantidadRegistros() const { return static_cast<size_t>(cabecera()->cantidadRegistros); }
+    /** @brief Todos los registros de subred, de todos los planes seguidos. */
+    VistaSubredes registros() const;
+
+    /**
+     * @brief Entrada del índice de un plan.
+     * @param indice Índice del plan (menor que cantidadPlanes()).
+     */
+    const EntradaIndicePlan& entrada(size_t indice) const;
+
+    /**
+     * @brief Registros de subred de un plan.
+     * @param indice Índice del plan (menor que cantidadPlanes()).
+     */
+    VistaSubredes subredesDe(size_t indice) const;
+
+    /**
+     * @brief Reconstruye un plan completo (copiando sus registros), para imprimirlo.
+     * @param indice Índice del plan (menor que cantidadPlanes()).
+     * @param plan Recibe el plan (se reutiliza su memoria).
+     */
+    void reconstruirPlan(size_t indice, PlanSubredes& plan) const;
+
+private:
+    const CabeceraPlanBinario* cabecera() const { return reinterpret_cast<const CabeceraPlanBinario*>(mapa); }
+    void cerrar();
+
+    int descriptor = -1;
+    const unsigned char* mapa = nullptr;
+    size_t tamanoMapa = 0;
+};
+
+/**
+ * @brief Convierte un archivo binario de planes al formato de tabla o CSV.
+ * La salida es la misma que produjo la ejecución original (el modo por lotes o imprimirPlan).
+ * @param lector Archivo abierto.
+ * @param os Flujo de salida.
+ * @param formato Formato de salida.
+ */
+void convertirPlanBinario(const LectorPlanBinario& lector, std::ostream& os, FormatoSalida formato);
+
+#endif // PLAN_BINARIO_H
@@ -0,0 +1,141 @@
+#include "pool_trabajo.h"
+
+#include <algorithm> // Para std::max, std::min
+
+using namespace std;
+
+PoolTrabajo::PoolTrabajo(unsigned cantidad) {
+    if (cantidad == 0) {
+        cantidad = max(1u, thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < cantidad; ++i) {
+        colas.push_back(unique_ptr<Cola>(new Cola()));
+    }
+    for (unsigned i = 1; i < cantidad; ++i) {
+        hilos.emplace_back(&PoolTrabajo::bucleHilo, this, i);
+    }
+}
+
+PoolTrabajo::~PoolTrabajo() {
+    {
+        lock_guard<mutex> bloqueo(mutexEstado);
+        detener = true;
+    }
+    hayTrabajo.notify_all();
+    for (thread& h : hilos) {
+        h.join();
+    }
+}
+
+void PoolTrabajo::paraCada(size_t n, const function<void(size_t, unsigned)>& tarea) {
+    if (n == 0) {
+        return;
+    }
+    const size_t cantidad = colas.size();
+    // Rangos de unos pocos índices: suficiente para repartir sin multiplicar los robos
+    grano = max<size_t>(1, n / (cantidad * 16));
+    for (size_t i = 0; i < cantidad; ++i) {
+        const size_t inicio = n * i / cantidad;
+        const size_t fin = n * (i + 1) / cantidad;
+        if (inicio < fin) {
+            lock_guard<mutex> bloqueo(colas[i]->mutex);
+            colas[i]->rangos.push_back({inicio, fin});
+        }
+    }
+    pendientes.store(n);
+    {
+        lock_guard<mutex> bloqueo(mutexEstado);
+        tareaActual = &tarea;
+        ++generacion;
+    }
+    hayTrabajo.notify_all();
+
+    trabajar(0, tarea);
+
+    // Se espera también a que los hilos auxiliares salgan de trabajar(): después de volver,
+    // ninguno puede seguir usando 'tarea'
+    unique_lock<mutex> bloqueo(mutexEstado);
+    terminado.wait(bloqueo, [this] { return pendientes.load() == 0 && hilosActivos == 0; });
+    tareaActual = nullptr;
+}
+
+void PoolTrabajo::bucleHilo(unsigned hilo) {
+    unsigned long long vista = 0;
+    while (true) {
+        const function<void(size_t, unsigned)>* tarea;
+        {
+            unique_lock<mutex> bloqueo(mutexEstado);
+            hayTrabajo.wait(bloqueo, [&] { return detener || generacion != vista; });
+            if (detener) {
+                return;
+            }
+            vista = generacion;
+            tarea = tareaActual;
+            if (!tarea) {
+                continue; // La generación ya terminó antes de que este hilo despertara
+            }
+            ++hilosActivos;
+        }
+        trabajar(hilo, *tarea);
+        {
+            lock_guard<mutex> bloqueo(mutexEstado);
+            --hilosActivos;
+        }
+        terminado.notify_all();
+    }
+}
+
+bool PoolTrabajo::tomarPropio(unsigned hilo, pair<size_t, size_t>& rango) {
+    Cola& cola = *colas[hilo];
+    lock_guard<mutex> bloqueo(cola.mutex);
+    if (cola.rangos.empty()) {
+        return false;
+    }
+    rango = cola.rangos.back();
+    cola.rangos.pop_back();
+    // Parte el rango: la mitad superior vuelve a la cola, donde otros hilos pueden robarla
+    while (rango.second - rango.first > grano) {
+        const size_t mitad = rango.first + (rango.second - rango.first) / 2;
+        cola.rangos.push_back({mitad, rango.second});
+        rango.second = mitad;
+    }
+    return true;
+}
+
+bool PoolTrabajo::robar(unsigned hilo, pair<size_t, size_t>& rango) {
+    const size_t cantidad = colas.size();
+    for (size_t k = 1; k < cantidad; ++k) {
+        Cola& victima = *colas[(hilo + k) % cantidad];
+        lock_guard<mutex> bloqueo(victima.mutex);
+        if (!victima.rangos.empty()) {
+            rango = victima.rangos.front();
+            victima.rangos.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void PoolTrabajo::trabajar(unsigned hilo, const function<void(size_t, unsigned)>& tarea) {
+    pair<size_t, size_t> rango;
+    while (pendientes.load() > 0) {
+        if (!tomarPropio(hilo, rango) && !robar(hilo, rango)) {
+            // Todo el trabajo restante está en curso en otros hilos; aún pueden aparecer rangos al partirse
+            this_thread::yield();
+            continue;
+        }
+        if (rango.second - rango.first > grano) {
+            // Rango robado: se deja en la cola propia para partirlo allí
+            lock_guard<mutex> bloqueo(colas[hilo]->mutex);
+            colas[hilo]->rangos.push_back(rango);
+            continue;
+        }
+        for (size_t i = rango.first; i < rango.second; ++i) {
+            tarea(i, hilo);
+        }
+        if (pendientes.fetch_sub(rango.second - rango.first) == rango.second - rango.first) {
+            lock_guard<mutex> bloqueo(mutexEstado);
+            terminado.notify_all();
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef POOL_TRABAJO_H
+#define POOL_TRABAJO_H
+
+#include <atomic>             // Para std::atomic
+#include <condition_variable> // Para std::condition_variable
+#include <cstddef>            // Para size_t
+#include <deque>              // Para std::deque
+#include <functional>         // Para std::function
+#include <memory>             // Para std::unique_ptr
+#include <mutex>              // Para std::mutex
+#include <thread>             // Para std::thread
+#include <utility>            // Para std::pair
+#include <vector>             // Para std::vector
+
+/**
+ * @brief Pool de hilos con robo de trabajo ("work stealing") para bucles paralelos.
+ *
+ * Cada hilo recibe al principio una porción contigua de los índices en su propia cola. Un hilo
+ * toma trabajo del final de su cola, partiendo los rangos grandes por la mitad y dejando la mitad
+ * superior en la cola; cuando su cola se vacía, roba el rango más antiguo (el más grande) del
+ * principio de la cola de otro hilo. Así los trabajos de duración desigual se reparten solos.
+ * El hilo que llama a paraCada() también trabaja (es el hilo 0).
+ */
+class PoolTrabajo {
+public:
+    /**
+     * @brief Crea el pool.
+     * @param hilos Cantidad total de hilos, incluido el que llama (0 = uno por núcleo).
+     */
+    explicit PoolTrabajo(unsigned hilos);
+    ~PoolTrabajo();
+    PoolTrabajo(const PoolTrabajo&) = delete;
+    PoolTrabajo& operator=(const PoolTrabajo&) = delete;
+
+    /** @brief Cantidad total de hilos, incluido el que llama. */
+    unsigned cantidadHilos() const { return static_cast<unsigned>(colas.size()); }
+
+    /**
+     * @brief Ejecuta tarea(i, hilo) para cada i en [0, n) y espera a que terminen todas.
+     * 'hilo' (menor que cantidadHilos()) permite a la tarea usar memoria propia de cada hilo.
+     * @param n Cantidad de índices.
+     * @param tarea La tarea; no debe lanzar excepciones.
+     */
+    void paraCada(size_t n, const std::function<void(size_t indice, unsigned hilo)>& tarea);
+
+private:
+    struct Cola {
+        std::mutex mutex;
+        std::deque<std::pair<size_t, size_t>> rangos; // Rangos [inicio, fin) pendientes
+    };
+
+    void bucleHilo(unsigned hilo);
+    void trabajar(unsigned hilo, const std::function<void(size_t, unsigned)>& tarea);
+    bool tomarPropio(unsigned hilo, std::pair<size_t, size_t>& rango);
+    bool robar(unsigned hilo, std::pair<size_t, size_t>& rango);
+
+    std::vector<std::unique_ptr<Cola>> colas;
+    std::vector<std::thread> hilos;
+    const std::function<void(size_t, unsigned)>* tareaActual = nullptr;
+    size_t grano = 1;                       // Tamaño a partir del cual un rango se parte
+    std::atomic<size_t> pendientes{0};      // Índices aún no terminados
+    unsigned hilosActivos = 0;              // Hilos auxiliares dentro de trabajar() (protegido por mutexEstado)
+    std::mutex mutexEstado;
+    std::condition_variable hayTrabajo;
+    std::condition_variable terminado;
+    unsigned long long generacion = 0;      // Se incrementa con cada paraCada()
+    bool detener = false;
+};
+
+#endif // POOL_TRABAJO_H
@@ -0,0 +1,260 @@
+// Pruebas del asignador "buddy": asignar, asignarConsecutivos, asignarEn y liberar con rangos
+// reservados, comprobados contra un modelo de un bit por dirección en miles de operaciones
+// aleatorias, y casos límite (/0 de IPv4, reservados que se salen de la red base, IPv6).
+// Termina con código 1 si falla algún caso.
+//
+// Compilación y ejecución: cmake -S . -B build && cmake --build build --target prueba_asignador && ctest --test-dir build
+
+#include <cstdint>  // Para uint32_t y otros tipos enteros de ancho fijo
+#include <iostream> // Para std::cout y std::cerr
+#include <string>   // Para std::string y std::to_string
+#include <vector>   // Para std::vector
+
+#include "asignador.h" // Asignador de bloques con rangos reservados
+
+using namespace std;
+
+static int fallos = 0;
+
+static void fallar(const string& caso, const string& detalle) {
+    ++fallos;
+    if (fallos <= 20) {
+        cerr << "FALLO " << caso << ": " << detalle << "\n";
+    }
+}
+
+/**
+ * @brief Generador determinista (splitmix64) para que los casos no cambien entre ejecuciones.
+ */
+static uint64_t siguienteAleatorio(uint64_t& estado) {
+    uint64_t z = (estado += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Modelo de referencia: un booleano por dirección de la red base (verdadero = ocupada).
+ */
+struct Modelo {
+    uint32_t red;
+    int cidr;
+    vector<bool> ocupada;
+
+    uint32_t tamano() const { return uint32_t(1) << (32 - cidr); }
+
+    bool bloqueLibre(uint32_t inicio, int prefijo) const {
+        for (uint32_t i = inicio - red; i < inicio - red + (uint32_t(1) << (32 - prefijo)); ++i) {
+            if (ocupada[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void marcar(uint32_t inicio, int prefijo, bool valor) {
+        for (uint32_t i = inicio - red; i < inicio - red + (uint32_t(1) << (32 - prefijo)); ++i) {
+            ocupada[i] = valor;
+        }
+    }
+
+    bool hayBloqueLibre(int prefijo) const {
+        for (uint32_t b = red; b - red < tamano(); b += uint32_t(1) << (32 - prefijo)) {
+            if (bloqueLibre(b, prefijo)) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+/**
+ * @brief Compara el estado del asignador (libres, rangos y mayor bloque) con el modelo.
+ */
+static void compararEstado(const string& caso, const AsignadorBloques& asignador, const Modelo& modelo) {
+    uint64_t libres = 0;
+    vector<RangoIPv4> rangos;
+    for (uint32_t i = 0; i < modelo.tamano(); ++i) {
+        if (modelo.ocupada[i]) {
+            continue;
+        }
+        ++libres;
+        if (!rangos.empty() && rangos.back().fin + 1 == modelo.red + i) {
+            rangos.back().fin = modelo.red + i;
+        } else {
+            rangos.push_back({modelo.red + i, modelo.red + i});
+        }
+    }
+    if (asignador.direccionesLibres() != libres) {
+        fallar(caso, "direcciones libres " + to_string(asignador.direccionesLibres()) + ", esperadas " + to_string(libres));
+    }
+    vector<RangoIPv4> obtenidos;
+    asignador.rangosLibres(obtenidos);
+    bool iguales = obtenidos.size() == rangos.size();
+    for (size_t i = 0; iguales && i < rangos.size(); ++i) {
+        iguales = obtenidos[i].inicio == rangos[i].inicio && obtenidos[i].fin == rangos[i].fin;
+    }
+    if (!iguales) {
+        fallar(caso, "rangos libres distintos (" + to_string(obtenidos.size()) + " frente a " + to_string(rangos.size()) + ")");
+    }
+    int mayor = -1;
+    for (int prefijo = modelo.cidr; prefijo <= 32 && mayor < 0; ++prefijo) {
+        if (modelo.hayBloqueLibre(prefijo)) {
+            mayor = prefijo;
+        }
+    }
+    if (asignador.mayorBloqueLibre() != mayor) {
+        fallar(caso, "mayor bloque libre /" + to_string(asignador.mayorBloqueLibre()) + ", esperado /" + to_string(mayor));
+    }
+}
+
+/**
+ * @brief Secuencia aleatoria de operaciones sobre una red base pequeña, comprobada tras cada una.
+ */
+static void pruebaAleatoria(uint64_t semilla) {
+    uint64_t estado = semilla;
+    Modelo modelo{0x0A000000u, 20 + static_cast<int>(siguienteAleatorio(estado) % 5), {}};
+    modelo.ocupada.assign(modelo.tamano(), false);
+
+    // Reservados al azar, que pueden solaparse entre sí y salirse de la red base
+    vector<RangoIPv4> reservados;
+    const int cantidadReservados = static_cast<int>(siguienteAleatorio(estado) % 5);
+    for (int i = 0; i < cantidadReservados; ++i) {
+        const uint32_t inicio = modelo.red - 8 + static_cast<uint32_t>(siguienteAleatorio(estado) % (modelo.tamano() + 8));
+        const uint32_t fin = inicio + static_cast<uint32_t>(siguienteAleatorio(estado) % 40);
+        reservados.push_back({inicio, fin});
+        for (uint64_t d = inicio; d <= fin; ++d) {
+            if (d >= modelo.red && d - modelo.red < modelo.tamano()) {
+                modelo.ocupada[d - modelo.red] = true;
+            }
+        }
+    }
+
+    AsignadorBloques asignador;
+    asignador.inicializar(modelo.red, modelo.cidr, reservados);
+    const string caso = "semilla " + to_string(semilla);
+    compararEstado(caso + " al inicializar", asignador, modelo);
+
+    vector<BloqueIPv4> asignados;
+    for (int paso = 0; paso < 300 && fallos == 0; ++paso) {
+        const string casoPaso = caso + ", paso " + to_string(paso);
+        const uint64_t r = siguienteAleatorio(estado);
+        const int prefijo = modelo.cidr + static_cast<int>((r >> 8) % static_cast<uint64_t>(33 - modelo.cidr));
+        switch (r % 4) {
+            case 0: { // asignar
+                uint32_t red;
+                const bool hay = modelo.hayBloqueLibre(prefijo);
+                if (asignador.asignar(prefijo, red) != hay) {
+                    fallar(casoPaso, "asignar /" + to_string(prefijo) + (hay ? " falló con espacio libre" : " asignó sin espacio"));
+                } else if (hay) {
+                    if ((red & ((uint64_t(1) << (32 - prefijo)) - 1)) != 0 || !modelo.bloqueLibre(red, prefijo)) {
+                        fallar(casoPaso, "asignar /" + to_string(prefijo) + " devolvió un bloque no alineado u ocupado");
+                    } else {
+                        modelo.marcar(red, prefijo, true);
+                        asignados.push_back({red, prefijo});
+                    }
+                }
+                break;
+            }
+            case 1: { // asignarConsecutivos
+                const size_t cantidad = 1 + (r >> 20) % 6;
+                uint32_t primera = 0;
+                const bool hay = modelo.hayBloqueLibre(prefijo);
+                const size_t tomados = asignador.asignarConsecutivos(prefijo, cantidad, primera);
+                if ((tomados > 0) != hay || tomados > cantidad) {
+                    fallar(casoPaso, "asignarConsecutivos /" + to_string(prefijo) + " tomó " + to_string(tomados));
+                    break;
+                }
+                for (size_t k = 0; k < tomados; ++k) {
+                    const uint32_t red = primera + static_cast<uint32_t>(k << (32 - prefijo));
+                    if (!modelo.bloqueLibre(red, prefijo)) {
+                        fallar(casoPaso, "asignarConsecutivos devolvió un bloque ocupado");
+                        break;
+                    }
+                    modelo.marcar(red, prefijo, true);
+                    asignados.push_back({red, prefijo});
+                }
+                break;
+            }
+            case 2: { // asignarEn
+                const uint32_t bloques = uint32_t(1) << (prefijo - modelo.cidr);
+                const uint32_t red = modelo.red + static_cast<uint32_t>((r >> 32) % bloques) * (uint32_t(1) << (32 - prefijo));
+                const bool libre = modelo.bloqueLibre(red, prefijo);
+                if (asignador.asignarEn(red, prefijo) != libre) {
+                    fallar(casoPaso, string("asignarEn ") + (libre ? "falló en un bloque libre" : "asignó un bloque ocupado"));
+                } else if (libre) {
+                    modelo.marcar(red, prefijo, true);
+                    asignados.push_back({red, prefijo});
+                }
+                break;
+            }
+            default: { // liberar
+                if (asignados.empty()) {
+                    break;
+                }
+                const size_t i = static_cast<size_t>((r >> 16) % asignados.size());
+                asignador.liberar(asignados[i].red, asignados[i].cidr);
+                modelo.marcar(asignados[i].red, asignados[i].cidr, false);
+                asignados[i] = asignados.back();
+                asignados.pop_back();
+                break;
+            }
+        }
+        compararEstado(casoPaso, asignador, modelo);
+    }
+}
+
+int main() {
+    for (uint64_t semilla = 1; semilla <= 200 && fallos == 0; ++semilla) {
+        pruebaAleatoria(semilla);
+    }
+
+    // El /0 de IPv4: 2^32 direcciones, que caben en la Cantidad de 64 bits
+    AsignadorBloques completo;
+    completo.inicializar(0, 0, {});
+    uint32_t red = 1;
+    if (completo.direccionesLibres() != (uint64_t(1) << 32) || completo.mayorBloqueLibre() != 0) {
+        fallar("/0 vacío", "libres " + to_string(completo.direccionesLibres()));
+    }
+    if (!completo.asignar(0, red) || red != 0 || completo.direccionesLibres() != 0 || completo.mayorBloqueLibre() != -1) {
+        fallar("/0 entero", "no se asignó todo el espacio");
+    }
+    completo.liberar(0, 0);
+    if (completo.direccionesLibres() != (uint64_t(1) << 32)) {
+        fallar("/0 liberado", "libres " + to_string(completo.direccionesLibres()));
+    }
+
+    // Un reservado que cubre la red base entera (y la desborda por ambos lados) no deja espacio
+    AsignadorBloques lleno;
+    lleno.inicializar(0x0A000000u, 24, {{0x09FFFFFFu, 0x0A000100u}});
+    if (lleno.direccionesLibres() != 0 || lleno.mayorBloqueLibre() != -1 || lleno.asignar(32, red)) {
+        fallar("reservado que cubre la base", "quedó espacio libre");
+    }
+
+    // Un reservado de una dirección parte la red base en los bloques alineados mínimos
+    AsignadorBloques partido;
+    partido.inicializar(0x0A000000u, 24, {{0x0A000001u, 0x0A000001u}});
+    vector<RangoIPv4> rangos;
+    partido.rangosLibres(rangos);
+    if (partido.direccionesLibres() != 255 || rangos.size() != 2 || partido.mayorBloqueLibre() != 25 ||
+        !partido.asignar(31, red) || red != 0x0A000002u) {
+        fallar("reservado de una dirección", "el espacio libre o el bloque más ajustado no son los esperados");
+    }
+
+    // El mismo asignador instanciado para IPv6
+    AsignadorBloquesIPv6 v6;
+    const uint128_t base = uint128_t(0x20010DB8u) << 96;
+    v6.inicializar(base, 32, {});
+    uint128_t red6 = 0;
+    if (!v6.asignar(48, red6) || red6 != base || !v6.asignar(48, red6) || red6 != (base | (uint128_t(1) << 80)) ||
+        v6.mayorBloqueLibre() != 33) {
+        fallar("IPv6 /32", "las dos primeras /48 no son las esperadas");
+    }
+
+    if (fallos > 0) {
+        cerr << fallos << " casos fallidos\n";
+        return 1;
+    }
+    cout << "Pruebas del asignador correctas\n";
+    return 0;
+}
@@ -0,0 +1,258 @@
+// Pruebas del analizador y el formateador IPv6 (RFC 4291 y forma canónica de RFC 5952), y de
+// las redes base IPv6. Termina con código 1 si falla algún caso.
+//
+// Compilación y ejecución: cmake -S . -B build && cmake --build build --target prueba_ipv6 && ctest --test-dir build
+
+#include <cstdint>  // Para uint64_t y otros tipos enteros de ancho fijo
+#include <iostream> // Para std::cout y std::cerr
+#include <string>   // Para std::string y std::to_string
+
+#include "ipv6.h" // Análisis, formato y redes base IPv6
+
+using namespace std;
+
+static int fallos = 0;
+
+static void fallar(const string& caso, const string& obtenido, const string& esperado) {
+    ++fallos;
+    cerr << "FALLO " << caso << ": se obtuvo '" << obtenido << "', se esperaba '" << esperado << "'\n";
+}
+
+// Entrada válida y su forma canónica
+struct CasoFormato {
+    const char* entrada;
+    const char* canonica;
+};
+
+static const CasoFormato CASOS_BORDE[] = {
+    {"::", "::"},
+    {"::0", "::"},
+    {"0:0:0:0:0:0:0:0", "::"},
+    {"::1", "::1"},
+    {"1::", "1::"},
+    {"1:0:0:0:0:0:0:0", "1::"},
+    {"FFFF:FFFF:FFFF:FFFF:FFFF:FFFF:FFFF:FFFF", "ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff"},
+    {"2001:0DB8:0000:0000:0000:0000:0000:0001", "2001:db8::1"},
+    {"2001:db8::0:1", "2001:db8::1"},
+    // Un solo grupo a cero no se comprime
+    {"2001:db8:0:1:1:1:1:1", "2001:db8:0:1:1:1:1:1"},
+    {"0:1:1:1:1:1:1:1", "0:1:1:1:1:1:1:1"},
+    {"1:1:1:1:1:1:1:0", "1:1:1:1:1:1:1:0"},
+    {"1:1:1:1:1:1::", "1:1:1:1:1:1::"},
+    {"::1:1:1:1:1:1", "::1:1:1:1:1:1"},
+    // Se comprime la secuencia más larga; con empate, la primera
+    {"2001:0:0:1:0:0:0:1", "2001:0:0:1::1"},
+    {"2001:db8:0:0:1:0:0:1", "2001:db8::1:0:0:1"},
+    {"1:0:0:1:0:0:1:1", "1::1:0:0:1:1"},
+    {"0:0:1:0:0:1:0:0", "::1:0:0:1:0:0"},
+    {"1:0:0:0:1:0:0:0", "1::1:0:0:0"},
+    // IPv4 incrustada en los últimos 32 bits
+    {"::ffff:192.0.2.1", "::ffff:c000:201"},
+    {"::192.0.2.1", "::c000:201"},
+    {"64:ff9b::203.0.113.7", "64:ff9b::cb00:7107"},
+    {"1:2:3:4:5:6:1.2.3.4", "1:2:3:4:5:6:102:304"},
+    {"::0.0.0.0", "::"},
+    // Comprobados con el módulo ipaddress de Python
+    {"0:0:0000:1203:0000:48cc:55C4:0", "::1203:0:48cc:55c4:0"},
+    {"c:0000:0000:0:0000:0:0007:0", "c::7:0"},
+    {"0000:0:0:000E:0000:57D5:0000:3", "::e:0:57d5:0:3"},
+    {"0008:0:0000:0000:1882:000C:96ca:0", "8::1882:c:96ca:0"},
+    {"0:0:CFD4:0000:0000:0:0000:0", "0:0:cfd4::"},
+    {"65DC:2505:0:590b:0:0000:b9ca:0000", "65dc:2505:0:590b::b9ca:0"},
+    {"0000:0:0004:d:0000:0000:0000:0000", "0:0:4:d::"},
+    {"aa68:74F6:4:f:0000:0:0:0000", "aa68:74f6:4:f::"},
+    {"50c9:0000:0:0000:a:38a6:0:0000", "50c9::a:38a6:0:0"},
+    {"0000:0:73da:0:0:000C:0000:0000", "::73da:0:0:c:0:0"},
+    {"0000:33be:D82E:0000:7e1d:0:0000:0003", "0:33be:d82e:0:7e1d::3"},
+    {"0:0000:0:0:6:16FB:0:0", "::6:16fb:0:0"},
+    {"0:0000:b:0000:000C:F812:0:0000", "::b:0:c:f812:0:0"},
+    {"0000:6FCD:E857:0000:0:0009:000C:0", "0:6fcd:e857::9:c:0"},
+    {"1409:0000:0:0000:0000:0000:0000:d429", "1409::d429"},
+    {"0008:6410:9:0:0005:0000:0000:6", "8:6410:9:0:5::6"},
+    {"0:0:0000:0003:0:0007:0:0000", "::3:0:7:0:0"},
+    {"0006:0006:0000:9:3:0:000B:0", "6:6:0:9:3:0:b:0"},
+    {"0000:0000:8:0000:0000:0000:0000:7", "0:0:8::7"},
+    {"0:0:0000:0000:f:0:0000:0", "::f:0:0:0"},
+    {"0000:0000:0:0003:BD50:4:0000:0000", "::3:bd50:4:0:0"},
+    {"0000:6D14:0000:0:0000:0000:0000:0000", "0:6d14::"},
+    {"0:0000:0:0000:ac3e:c9a5:0:c", "::ac3e:c9a5:0:c"},
+    {"c:DA57:0000:0000:0000:0000:0000:000A", "c:da57::a"},
+    {"5:c46c:7233:0000:8840:0:0:0000", "5:c46c:7233:0:8840::"},
+    {"3:0000:5e7e:0:0000:0:f380:7d1b", "3:0:5e7e::f380:7d1b"},
+    {"0007:3:6:4960:0:9645:0000:0000", "7:3:6:4960:0:9645::"},
+    {"a292:0:0:000C:3:0004:0:7", "a292::c:3:4:0:7"},
+    {"a413:0:0001:0000:f9f:b3ef:0000:4", "a413:0:1:0:f9f:b3ef:0:4"},
+    {"0006:0000:0000:e:7127:0:0000:D2C9", "6::e:7127:0:0:d2c9"},
+    {"A080:BFBB:0000:e:AB1F:000D:0:0003", "a080:bfbb:0:e:ab1f:d:0:3"},
+    {"0:0000:0:0:872e:0:0:EB7F", "::872e:0:0:eb7f"},
+    {"0000:0000:3007:49A0:0000:59db:5:15B1", "::3007:49a0:0:59db:5:15b1"},
+    {"7e25:4607:0000:0000:0000:0000:0000:0", "7e25:4607::"},
+    {"0000:0000:1081:0000:8:0000:0:0000", "0:0:1081:0:8::"},
+    {"000A:7:0:0000:0003:0:b3e4:0000", "a:7::3:0:b3e4:0"},
+    {"45C6:0:345f:7:0:0000:0:a", "45c6:0:345f:7::a"},
+    {"0000:0002:0:0000:0:0000:0000:0000", "0:2::"},
+    {"0000:6C48:0000:0000:695C:0000:0:C634", "0:6c48::695c:0:0:c634"},
+    {"0000:0:0:0:2:0:0:000B", "::2:0:0:b"},
+    {"000B:2734:4:6:0000:000C:0000:0000", "b:2734:4:6:0:c::"},
+    {"0008:A063:0:4:0:0000:5:bca1", "8:a063:0:4::5:bca1"},
+    {"000B:0000:0:0:0000:0:0005:0000", "b::5:0"},
+    {"b:0000:0:0000:0000:0:0000:0", "b::"},
+    {"0:0000:0:0:0000:0000:0000:49f5", "::49f5"},
+    {"54B8:5CBD:7:0000:0000:0000:642C:0", "54b8:5cbd:7::642c:0"},
+    {"b:0:0:0000:ffaf:0000:075C:0", "b::ffaf:0:75c:0"},
+    {"3037:0:0:898c:11B0:0000:000E:5", "3037::898c:11b0:0:e:5"},
+};
+
+static const char* const INVALIDAS[] = {
+    "", ":", ":::", "1", "1:2:3:4:5:6:7", "1:2:3:4:5:6:7:8:9", "1::2::3", ":1::", "1::2:", "1:2:3:4:5:6:7:8:",
+    "12345::", "g::", "::ffff:256.0.0.1", "::1.2.3", "1.2.3.4::", "::1.2.3.4:5", "1:2:3:4:5:6:7:1.2.3.4", " ::1",
+};
+
+static string texto128(uint128_t valor) {
+    char buffer[40];
+    return string(buffer, formatearEntero128(buffer, valor));
+}
+
+/**
+ * @brief Generador determinista (splitmix64) para que los casos no cambien entre ejecuciones.
+ */
+static uint64_t siguienteAleatorio(uint64_t& estado) {
+    uint64_t z = (estado += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Forma canónica de referencia, escrita de la manera más directa posible a partir de RFC 5952.
+ */
+static string canonicaReferencia(const uint16_t grupos[8]) {
+    int mejorInicio = -1;
+    int mejorLongitud = 0;
+    for (int inicio = 0; inicio < 8; ++inicio) {
+        int longitud = 0;
+        while (inicio + longitud < 8 && grupos[inicio + longitud] == 0) {
+            ++longitud;
+        }
+        if (longitud >= 2 && longitud > mejorLongitud) {
+            mejorInicio = inicio;
+            mejorLongitud = longitud;
+        }
+    }
+    static const char HEX[] = "0123456789abcdef";
+    string texto;
+    for (int g = 0; g < 8; ++g) {
+        if (g == mejorInicio) {
+            texto += "::";
+            g += mejorLongitud - 1;
+            continue;
+        }
+        if (g > 0 && g != mejorInicio + mejorLongitud) {
+            texto += ':';
+        }
+        string grupo;
+        unsigned v = grupos[g];
+        do {
+            grupo.insert(grupo.begin(), HEX[v & 0xF]);
+            v >>= 4;
+        } while (v != 0);
+        texto += grupo;
+    }
+    return texto;
+}
+
+int main() {
+    for (const CasoFormato& caso : CASOS_BORDE) {
+        uint128_t ip;
+        if (!parseIPv6(caso.entrada, ip)) {
+            fallar(caso.entrada, "(inválida)", caso.canonica);
+            continue;
+        }
+        if (ipv6AString(ip) != caso.canonica) {
+            fallar(caso.entrada, ipv6AString(ip), caso.canonica);
+        }
+        uint128_t vuelta;
+        if (!parseIPv6(caso.canonica, vuelta) || vuelta != ip) {
+            fallar(string("ida y vuelta de ") + caso.canonica, "distinta", caso.entrada);
+        }
+    }
+    for (const char* texto : INVALIDAS) {
+        uint128_t ip;
+        if (parseIPv6(texto, ip)) {
+            fallar(string("'") + texto + "'", ipv6AString(ip), "(inválida)");
+        }
+    }
+
+    // Direcciones aleatorias con muchos grupos a cero, para que abunden las secuencias y los empates
+    uint64_t estado = 5952;
+    for (int i = 0; i < 40000; ++i) {
+        uint16_t grupos[8];
+        uint128_t ip = 0;
+        string completa; // Sin comprimir, con ceros a la izquierda y mayúsculas
+        for (int g = 0; g < 8; ++g) {
+            const uint64_t r = siguienteAleatorio(estado);
+            grupos[g] = (r & 3) < 2 ? 0 : static_cast<uint16_t>((r & 4) ? (r >> 8) & 0xF : r >> 16);
+            ip = (ip << 16) | grupos[g];
+            static const char HEX[] = "0123456789ABCDEF";
+            if (g > 0) {
+                completa += ':';
+            }
+            for (int desplazamiento = 12; desplazamiento >= 0; desplazamiento -= 4) {
+                completa += HEX[(grupos[g] >> desplazamiento) & 0xF];
+            }
+        }
+        const string esperada = canonicaReferencia(grupos);
+        if (ipv6AString(ip) != esperada) {
+            fallar(completa, ipv6AString(ip), esperada);
+        }
+        uint128_t leida;
+        if (!parseIPv6(completa, leida) || leida != ip) {
+            fallar("lectura de " + completa, parseIPv6(completa, leida) ? ipv6AString(leida) : "(inválida)", esperada);
+        }
+        if (!parseIPv6(esperada, leida) || leida != ip) {
+            fallar("lectura de " + esperada, parseIPv6(esperada, leida) ? ipv6AString(leida) : "(inválida)", esperada);
+        }
+    }
+
+    // Redes base: de /0 a /128, alineadas a su prefijo
+    struct CasoRed {
+        const char* texto;
+        bool valida;
+        int prefijo;
+    };
+    static const CasoRed REDES[] = {
+        {"::/0", true, 0},          {"8000::/0", false, 0},      {"2001:db8::/32", true, 32}, {"2001:db8::1/32", false, 0},
+        {"::1/128", true, 128},     {"::/129", false, 0},        {"::", false, 0},            {"::/", false, 0},
+        {"::/-1", false, 0},        {"8000::/1", true, 1},
+    };
+    for (const CasoRed& caso : REDES) {
+        uint128_t red;
+        int prefijo = -1;
+        string error;
+        const bool valida = analizarRedIPv6(caso.texto, red, prefijo, error);
+        if (valida != caso.valida || (valida && prefijo != caso.prefijo)) {
+            fallar(string("red ") + caso.texto, valida ? "/" + to_string(prefijo) : error,
+                   caso.valida ? "/" + to_string(caso.prefijo) : "(inválida)");
+        }
+    }
+
+    // Un /0 sobre ::/0 ocupa todo el espacio; lo demás ya no cabe
+    PlanSubredesIPv6 plan;
+    planificarSubredesIPv6(plan, 0, 0, {{0, 0, 1}, {1, 0, 1}});
+    if (plan.subredes.size() != 1 || plan.subredes[0].cidr != 0 || plan.fallidas.size() != 1 ||
+        plan.fallidas[0].motivo != MotivoFallo::SinEspacio || !plan.espacioLibre.empty()) {
+        fallar("plan ::/0 con /0 y /1", to_string(plan.subredes.size()) + " subredes", "1 subred /0 y el /1 sin espacio");
+    }
+    planificarSubredesIPv6(plan, 0, 0, {{1, 0, 1}, {128, 0, 1}});
+    const uint128_t libresEsperadas = (uint128_t(1) << 127) - 1;
+    if (plan.subredes.size() != 2 || !plan.fallidas.empty() || plan.direccionesLibres != libresEsperadas) {
+        fallar("plan ::/0 con /1 y /128", texto128(plan.direccionesLibres), texto128(libresEsperadas));
+    }
+
+    if (fallos > 0) {
+        cerr << fallos << " casos fallidos\n";
+        return 1;
+    }
+    cout << "Pruebas IPv6 correctas\n";
+    return 0;
+}
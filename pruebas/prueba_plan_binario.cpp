@@ -0,0 +1,221 @@
+// Pruebas del formato .sbp: escribe planes variados (con reservados, solicitudes fallidas, redes
+// inválidas y el /0) con EscritorPlanBinario, los vuelve a leer con LectorPlanBinario y compara
+// cada campo; después comprueba que se rechazan archivos truncados y con enumeraciones dañadas.
+// Termina con código 1 si falla algún caso.
+//
+// Compilación y ejecución: cmake -S . -B build && cmake --build build --target prueba_plan_binario && ctest --test-dir build
+
+#include <cstddef>    // Para offsetof
+#include <cstdint>    // Para uint32_t y otros tipos enteros de ancho fijo
+#include <cstdio>     // Para std::remove
+#include <cstring>    // Para std::memcpy
+#include <filesystem> // Para std::filesystem::temp_directory_path
+#include <fstream>    // Para std::ifstream y std::ofstream
+#include <iostream>   // Para std::cout y std::cerr
+#include <iterator>   // Para std::istreambuf_iterator
+#include <string>     // Para std::string y std::to_string
+#include <vector>     // Para std::vector
+
+#include "plan_binario.h" // EscritorPlanBinario y LectorPlanBinario
+#include "subredes.h"     // planificarSubredes
+
+using namespace std;
+
+static int fallos = 0;
+
+static void fallar(const string& caso, const string& detalle) {
+    ++fallos;
+    cerr << "FALLO " << caso << ": " << detalle << "\n";
+}
+
+static bool rangosIguales(const vector<RangoIPv4>& a, const vector<RangoIPv4>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].inicio != b[i].inicio || a[i].fin != b[i].fin) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Compara campo a campo un plan reconstruido con el original.
+ */
+static void compararPlanes(const string& caso, const PlanSubredes& leido, const PlanSubredes& original) {
+    if (leido.ipBaseStr != original.ipBaseStr || leido.cidrBase != original.cidrBase ||
+        leido.redBase != original.redBase || leido.broadcastBase != original.broadcastBase ||
+        leido.resultado != original.resultado || leido.direccionesLibres != original.direccionesLibres) {
+        fallar(caso, "la red base, el resultado o las direcciones libres no coinciden");
+    }
+    bool subredesIguales = leido.subredes.size() == original.subredes.size();
+    for (size_t i = 0; subredesIguales && i < original.subredes.size(); ++i) {
+        const Subred& a = leido.subredes[i];
+        const Subred& b = original.subredes[i];
+        subredesIguales = a.red == b.red && a.hostsSolicitados == b.hostsSolicitados && a.cidr == b.cidr;
+    }
+    if (!subredesIguales) {
+        fallar(caso, "las subredes no coinciden");
+    }
+    bool fallidasIguales = leido.fallidas.size() == original.fallidas.size();
+    for (size_t i = 0; fallidasIguales && i < original.fallidas.size(); ++i) {
+        const SolicitudFallida& a = leido.fallidas[i];
+        const SolicitudFallida& b = original.fallidas[i];
+        fallidasIguales = a.hostsSolicitados == b.hostsSolicitados && a.cidr == b.cidr && a.motivo == b.motivo &&
+                          a.mayorBloqueLibre == b.mayorBloqueLibre && a.direccionesLibres == b.direccionesLibres;
+    }
+    if (!fallidasIguales) {
+        fallar(caso, "las solicitudes fallidas no coinciden");
+    }
+    if (!rangosIguales(leido.reservados, original.reservados)) {
+        fallar(caso, "los rangos reservados no coinciden");
+    }
+    if (!rangosIguales(leido.espacioLibre, original.espacioLibre)) {
+        fallar(caso, "el espacio libre no coincide");
+    }
+}
+
+static string leerArchivo(const string& ruta) {
+    ifstream entrada(ruta, ios::binary);
+    return string(istreambuf_iterator<char>(entrada), istreambuf_iterator<char>());
+}
+
+static void escribirArchivo(const string& ruta, const string& contenido) {
+    ofstream salida(ruta, ios::binary | ios::trunc);
+    salida.write(contenido.data(), static_cast<streamsize>(contenido.size()));
+}
+
+/**
+ * @brief Verdadero si el lector rechaza el contenido dado.
+ */
+static bool rechazado(const string& ruta, const string& contenido) {
+    escribirArchivo(ruta, contenido);
+    LectorPlanBinario lector;
+    string error;
+    return !lector.abrir(ruta, error) && !error.empty();
+}
+
+int main() {
+    const string ruta = (filesystem::temp_directory_path() / "prueba_plan_binario.sbp").string();
+    const string rutaDanada = (filesystem::temp_directory_path() / "prueba_plan_binario_danado.sbp").string();
+
+    // Planes con todas las secciones de datos adicionales ocupadas de distintas formas
+    vector<PlanSubredes> planes(6);
+    planificarSubredes(planes[0], "10.0.0.0", 24, {50, 20, 20, 10, 10});
+    planificarSubredes(planes[1], "10.0.0.0", 24, {100, 100, 100, -3}, {{0x0A000000u, 0x0A00007Fu}, {0x0A0000F0u, 0x0A0000F3u}});
+    planificarSubredes(planes[2], "300.0.0.1", 24, {10});
+    planificarSubredes(planes[3], "0.0.0.0", 0, {5, 1000000});
+    planificarSubredes(planes[4], "192.168.1.77", 30, {2, 2});
+    planificarSubredes(planes[5], "172.16.0.0", 12, {});
+
+    string error;
+    {
+        EscritorPlanBinario escritor;
+        if (!escritor.abrir(ruta, true, error)) {
+            cerr << error << "\n";
+            return 1;
+        }
+        for (size_t i = 0; i < planes.size(); ++i) {
+            escritor.agregar(planes[i], static_cast<long long>(i + 1), static_cast<long long>(2 * i + 3));
+        }
+        if (!escritor.cerrar(error)) {
+            cerr << error << "\n";
+            return 1;
+        }
+    }
+
+    LectorPlanBinario lector;
+    if (!lector.abrir(ruta, error)) {
+        fallar("lote", error);
+    } else {
+        if (!lector.esLote() || lector.cantidadPlanes() != planes.size()) {
+            fallar("lote", "cabecera con " + to_string(lector.cantidadPlanes()) + " planes");
+        }
+        size_t registros = 0;
+        for (size_t i = 0; i < lector.cantidadPlanes() && i < planes.size(); ++i) {
+            const string caso = "plan " + to_string(i);
+            const EntradaIndicePlan& entrada = lector.entrada(i);
+            if (entrada.numeroTrabajo != static_cast<int64_t>(i + 1) || entrada.numeroLinea != static_cast<int64_t>(2 * i + 3)) {
+                fallar(caso, "número de trabajo o de línea distinto");
+            }
+            if (lector.subredesDe(i).size() != planes[i].subredes.size()) {
+                fallar(caso, "la vista de subredes tiene " + to_string(lector.subredesDe(i).size()) + " registros");
+            }
+            registros += planes[i].subredes.size();
+            PlanSubredes leido;
+            lector.reconstruirPlan(i, leido);
+            compararPlanes(caso, leido, planes[i]);
+        }
+        if (lector.cantidadRegistros() != registros || lector.registros().size() != registros) {
+            fallar("lote", "cantidad total de registros distinta");
+        }
+    }
+
+    // Un archivo que no es de lote, con un solo plan
+    {
+        EscritorPlanBinario escritor;
+        if (!escritor.abrir(ruta, false, error)) {
+            fallar("plan suelto", error);
+        } else {
+            escritor.agregar(planes[1]);
+            if (!escritor.cerrar(error)) {
+                fallar("plan suelto", error);
+            }
+        }
+    }
+    LectorPlanBinario suelto;
+    if (!suelto.abrir(ruta, error)) {
+        fallar("plan suelto", error);
+    } else if (suelto.esLote() || suelto.cantidadPlanes() != 1 || suelto.entrada(0).numeroTrabajo != 0) {
+        fallar("plan suelto", "cabecera o índice inesperados");
+    } else {
+        PlanSubredes leido;
+        suelto.reconstruirPlan(0, leido);
+        compararPlanes("plan suelto", leido, planes[1]);
+    }
+
+    // Archivos dañados: el lector debe rechazarlos al abrirlos, no al recorrerlos
+    const string original = leerArchivo(ruta);
+    CabeceraPlanBinario cabecera;
+    memcpy(&cabecera, original.data(), sizeof(cabecera));
+    EntradaIndicePlan entrada;
+    memcpy(&entrada, original.data() + cabecera.desplazamientoIndice, sizeof(entrada));
+
+    string danado = original;
+    danado[cabecera.desplazamientoIndice + offsetof(EntradaIndicePlan, resultado)] = static_cast<char>(200);
+    if (!rechazado(rutaDanada, danado)) {
+        fallar("resultado fuera de rango", "el archivo se aceptó");
+    }
+
+    // La primera fallida va tras la IP base (rellenada a 8 bytes) y los reservados
+    const size_t primeraFallida = cabecera.desplazamientoDatos + entrada.desplazamientoDatos +
+                                  ((entrada.longitudIpBase + 7u) & ~size_t(7)) +
+                                  entrada.cantidadReservados * sizeof(RangoIPv4);
+    danado = original;
+    danado[primeraFallida + offsetof(FallidaBinaria, motivo)] = static_cast<char>(99);
+    if (entrada.cantidadFallidas == 0 || !rechazado(rutaDanada, danado)) {
+        fallar("motivo fuera de rango", "el archivo se aceptó");
+    }
+
+    danado = original;
+    danado[0] = 'X';
+    if (!rechazado(rutaDanada, danado)) {
+        fallar("magia incorrecta", "el archivo se aceptó");
+    }
+    for (size_t tamano : {size_t(0), size_t(32), sizeof(CabeceraPlanBinario), original.size() - 1}) {
+        if (!rechazado(rutaDanada, original.substr(0, tamano))) {
+            fallar("truncado a " + to_string(tamano) + " bytes", "el archivo se aceptó");
+        }
+    }
+
+    remove(ruta.c_str());
+    remove(rutaDanada.c_str());
+
+    if (fallos > 0) {
+        cerr << fallos << " casos fallidos\n";
+        return 1;
+    }
+    cout << "Pruebas del formato binario correctas\n";
+    return 0;
+}
@@ -0,0 +1,274 @@
+// Pruebas de la replanificación incremental: la numeración del conjunto de cambios frente al plan
+// resultante (el caso de "3=30 -4 +5", que mostraba números del plan de partida) y rondas de
+// ediciones aleatorias encadenadas, en las que se comprueba el plan resultante contra un mapa de
+// un bit por dirección: sin solapes ni salidas de la red base, subredes sin editar en su sitio,
+// números resultantes coherentes con obtenerPlan y rechazos solo cuando no hay un bloque libre.
+// Termina con código 1 si falla algún caso.
+//
+// Compilación y ejecución: cmake -S . -B build && cmake --build build --target prueba_replanificacion && ctest --test-dir build
+
+#include <cstdint>  // Para uint32_t y otros tipos enteros de ancho fijo
+#include <iostream> // Para std::cout y std::cerr
+#include <string>   // Para std::string y std::to_string
+#include <vector>   // Para std::vector
+
+#include "replanificacion.h" // PlanificadorIncremental y analizarEdicion
+#include "subredes.h"        // planificarSubredes y hostsToCidr
+
+using namespace std;
+
+static int fallos = 0;
+
+static void fallar(const string& caso, const string& detalle) {
+    ++fallos;
+    if (fallos <= 20) {
+        cerr << "FALLO " << caso << ": " << detalle << "\n";
+    }
+}
+
+/**
+ * @brief Generador determinista (splitmix64) para que los casos no cambien entre ejecuciones.
+ */
+static uint64_t siguienteAleatorio(uint64_t& estado) {
+    uint64_t z = (estado += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Busca el cambio de la subred con un número dado (de la edición); nullptr si no hay.
+ */
+static const CambioPlan* buscarCambio(const vector<CambioPlan>& cambios, size_t numero) {
+    for (const CambioPlan& cambio : cambios) {
+        if (cambio.numero == numero) {
+            return &cambio;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Caso de regresión: tras eliminar la subred 4, la 5 pasa a ser la 4 y la agregada, la 5.
+ */
+static void pruebaNumeracion() {
+    PlanSubredes plan;
+    planificarSubredes(plan, "10.0.0.0", 24, {50, 20, 20, 10, 10});
+    PlanificadorIncremental planificador;
+    planificador.cargar(plan);
+
+    vector<EdicionPlan> ediciones;
+    string error;
+    for (const string texto : {"3=30", "-4", "+5"}) {
+        EdicionPlan edicion;
+        if (!analizarEdicion(texto, edicion, error)) {
+            fallar("numeración", error);
+            return;
+        }
+        ediciones.push_back(edicion);
+    }
+    vector<CambioPlan> cambios;
+    if (!planificador.aplicar(ediciones, cambios, error)) {
+        fallar("numeración", error);
+        return;
+    }
+    const CambioPlan* redimensionada = buscarCambio(cambios, 3);
+    const CambioPlan* eliminada = buscarCambio(cambios, 4);
+    const CambioPlan* agregada = buscarCambio(cambios, 6);
+    if (cambios.size() != 3 || !redimensionada || !eliminada || !agregada) {
+        fallar("numeración", "se esperaban cambios para las subredes 3, 4 y 6");
+        return;
+    }
+    if (redimensionada->numeroResultante != 3 || eliminada->tipo != TipoCambio::Eliminada ||
+        eliminada->numeroResultante != 0 || agregada->tipo != TipoCambio::Agregada || agregada->numeroResultante != 5) {
+        fallar("numeración", "números resultantes " + to_string(redimensionada->numeroResultante) + ", " +
+                             to_string(eliminada->numeroResultante) + " y " + to_string(agregada->numeroResultante) +
+                             "; se esperaban 3, 0 y 5");
+    }
+    PlanSubredes resultante;
+    planificador.obtenerPlan(resultante);
+    if (resultante.subredes.size() != 5 || resultante.subredes[3].red != plan.subredes[4].red ||
+        resultante.subredes[4].red != agregada->redNueva) {
+        fallar("numeración", "el plan resultante no sigue la numeración del conjunto de cambios");
+    }
+}
+
+/**
+ * @brief Mapa de ocupación del plan: reservados y subredes, un bit por dirección de la red base.
+ * Marca el fallo si alguna subred se sale de la base, no está alineada o se solapa con algo.
+ */
+static vector<bool> mapaDelPlan(const string& caso, const PlanSubredes& plan) {
+    vector<bool> ocupada(plan.totalIps(), false);
+    for (const RangoIPv4& rango : plan.reservados) {
+        for (uint64_t d = rango.inicio; d <= rango.fin; ++d) {
+            if (d >= plan.redBase && d <= plan.broadcastBase) {
+                ocupada[d - plan.redBase] = true;
+            }
+        }
+    }
+    for (const Subred& subred : plan.subredes) {
+        if (subred.cidr < plan.cidrBase || subred.cidr != hostsToCidr(static_cast<int>(subred.hostsSolicitados)) ||
+            subred.red < plan.redBase || subred.broadcast() > plan.broadcastBase || (subred.red & ~subred.mascara()) != 0) {
+            fallar(caso, "subred fuera de la base, desalineada o con un prefijo que no es el de sus hosts");
+            continue;
+        }
+        for (uint64_t d = subred.red; d <= subred.broadcast(); ++d) {
+            if (ocupada[d - plan.redBase]) {
+                fallar(caso, "subredes solapadas");
+                break;
+            }
+            ocupada[d - plan.redBase] = true;
+        }
+    }
+    return ocupada;
+}
+
+static bool hayBloqueLibre(const vector<bool>& ocupada, const PlanSubredes& plan, int prefijo) {
+    if (prefijo < plan.cidrBase || prefijo > 32) {
+        return false;
+    }
+    const uint64_t tamano = uint64_t(1) << (32 - prefijo);
+    for (uint64_t inicio = 0; inicio < ocupada.size(); inicio += tamano) {
+        bool libre = true;
+        for (uint64_t d = inicio; libre && d < inicio + tamano; ++d) {
+            libre = !ocupada[d];
+        }
+        if (libre) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Rondas de ediciones aleatorias; cada ronda parte del plan resultante de la anterior,
+ * como cuando se replanifica sobre un plan guardado.
+ */
+static void pruebaAleatoria(uint64_t semilla) {
+    uint64_t estado = semilla;
+    const int cidrBase = 20 + static_cast<int>(siguienteAleatorio(estado) % 4);
+    vector<int> hosts;
+    const size_t cantidad = 1 + siguienteAleatorio(estado) % 12;
+    for (size_t i = 0; i < cantidad; ++i) {
+        hosts.push_back(static_cast<int>(siguienteAleatorio(estado) % 300));
+    }
+    vector<RangoIPv4> reservados;
+    if (siguienteAleatorio(estado) % 2 == 0) {
+        const uint32_t inicio = 0x0A000000u + static_cast<uint32_t>(siguienteAleatorio(estado) % 1024);
+        reservados.push_back({inicio, inicio + static_cast<uint32_t>(siguienteAleatorio(estado) % 200)});
+    }
+    PlanSubredes plan;
+    planificarSubredes(plan, "10.0.0.0", cidrBase, hosts, reservados);
+
+    for (int ronda = 0; ronda < 8 && fallos == 0; ++ronda) {
+        const string caso = "semilla " + to_string(semilla) + ", ronda " + to_string(ronda);
+        PlanificadorIncremental planificador;
+        planificador.cargar(plan);
+
+        // Cada subred se edita como mucho una vez
+        vector<EdicionPlan> ediciones;
+        const size_t n = plan.subredes.size();
+        for (size_t numero = 1; numero <= n; ++numero) {
+            const uint64_t r = siguienteAleatorio(estado) % 6;
+            const int nuevosHosts = static_cast<int>(siguienteAleatorio(estado) % 600);
+            if (r == 0) {
+                ediciones.push_back({TipoEdicion::Eliminar, numero, 0});
+            } else if (r == 1) {
+                ediciones.push_back({TipoEdicion::Redimensionar, numero, nuevosHosts});
+            }
+        }
+        const size_t agregadas = siguienteAleatorio(estado) % 4;
+        for (size_t i = 0; i < agregadas; ++i) {
+            ediciones.push_back({TipoEdicion::Agregar, 0, static_cast<int>(siguienteAleatorio(estado) % 400)});
+        }
+
+        vector<CambioPlan> cambios;
+        string error;
+        if (!planificador.aplicar(ediciones, cambios, error)) {
+            fallar(caso, error);
+            return;
+        }
+        PlanSubredes resultante;
+        planificador.obtenerPlan(resultante);
+        const vector<bool> ocupada = mapaDelPlan(caso, resultante);
+
+        // Las subredes sin cambio conservan todo; el número resultante descuenta las eliminadas anteriores
+        size_t eliminadasAntes = 0;
+        size_t esperadas = 0;
+        for (size_t numero = 1; numero <= n; ++numero) {
+            const CambioPlan* cambio = buscarCambio(cambios, numero);
+            if (cambio && cambio->tipo == TipoCambio::Eliminada) {
+                ++eliminadasAntes;
+                continue;
+            }
+            ++esperadas;
+            if (cambio) {
+                continue;
+            }
+            const size_t resultanteNumero = numero - eliminadasAntes;
+            const Subred& antes = plan.subredes[numero - 1];
+            if (resultanteNumero > resultante.subredes.size() || resultante.subredes[resultanteNumero - 1].red != antes.red ||
+                resultante.subredes[resultanteNumero - 1].cidr != antes.cidr ||
+                resultante.subredes[resultanteNumero - 1].hostsSolicitados != antes.hostsSolicitados) {
+                fallar(caso, "la subred " + to_string(numero) + " cambió sin figurar en el conjunto de cambios");
+            }
+        }
+
+        for (const CambioPlan& cambio : cambios) {
+            const string casoCambio = caso + ", subred " + to_string(cambio.numero);
+            const bool enPlan = cambio.tipo != TipoCambio::Eliminada &&
+                                !(cambio.tipo == TipoCambio::Rechazada && cambio.numero > n);
+            if (enPlan != (cambio.numeroResultante != 0) || cambio.numeroResultante > resultante.subredes.size()) {
+                fallar(casoCambio, "número resultante " + to_string(cambio.numeroResultante));
+                continue;
+            }
+            if (cambio.tipo == TipoCambio::Agregada && cambio.numero > n) {
+                ++esperadas;
+            }
+            if (cambio.tipo == TipoCambio::Rechazada && hayBloqueLibre(ocupada, resultante, cambio.cidrNueva)) {
+                fallar(casoCambio, "se rechazó con un bloque /" + to_string(cambio.cidrNueva) + " libre");
+            }
+            if (cambio.tipo == TipoCambio::Redimensionada && cambio.redNueva != cambio.redAnterior) {
+                fallar(casoCambio, "redimensionada cambiando de dirección de red");
+            }
+            if (!enPlan) {
+                continue;
+            }
+            const Subred& subred = resultante.subredes[cambio.numeroResultante - 1];
+            const bool rechazada = cambio.tipo == TipoCambio::Rechazada;
+            const uint32_t red = rechazada ? cambio.redAnterior : cambio.redNueva;
+            const int cidr = rechazada ? cambio.cidrAnterior : cambio.cidrNueva;
+            const uint32_t hostsSubred = rechazada ? cambio.hostsAnteriores : cambio.hostsNuevos;
+            if (subred.red != red || subred.cidr != cidr || subred.hostsSolicitados != hostsSubred) {
+                fallar(casoCambio, "no coincide con la subred " + to_string(cambio.numeroResultante) + " del plan resultante");
+            }
+        }
+        if (resultante.subredes.size() != esperadas || planificador.cantidadSubredes() != esperadas) {
+            fallar(caso, "el plan resultante tiene " + to_string(resultante.subredes.size()) + " subredes, se esperaban " +
+                         to_string(esperadas));
+        }
+
+        uint64_t libres = 0;
+        for (bool o : ocupada) {
+            libres += o ? 0 : 1;
+        }
+        if (resultante.direccionesLibres != libres) {
+            fallar(caso, "direcciones libres " + to_string(resultante.direccionesLibres) + ", esperadas " + to_string(libres));
+        }
+        plan = resultante;
+    }
+}
+
+int main() {
+    pruebaNumeracion();
+    for (uint64_t semilla = 1; semilla <= 300 && fallos == 0; ++semilla) {
+        pruebaAleatoria(semilla);
+    }
+
+    if (fallos > 0) {
+        cerr << fallos << " casos fallidos\n";
+        return 1;
+    }
+    cout << "Pruebas de la replanificación correctas\n";
+    return 0;
+}
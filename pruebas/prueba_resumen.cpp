@@ -0,0 +1,238 @@
+// Pruebas del resumen de prefijos: fusionarRangos contra un mapa de un bit por dirección (también
+// en los extremos 0.0.0.0 y 255.255.255.255), rangoABloques contra una cobertura mínima calculada
+// recorriendo el árbol de prefijos, ordenarRangosParalelo contra std::sort y algunos casos de
+// parsePrefijosLote y escribirResumen. Termina con código 1 si falla algún caso.
+//
+// Compilación y ejecución: cmake -S . -B build && cmake --build build --target prueba_resumen && ctest --test-dir build
+
+#include <algorithm> // Para std::sort y std::is_sorted
+#include <cstdint>   // Para uint32_t y otros tipos enteros de ancho fijo
+#include <iostream>  // Para std::cout y std::cerr
+#include <sstream>   // Para std::ostringstream
+#include <string>    // Para std::string y std::to_string
+#include <vector>    // Para std::vector
+
+#include "asignador.h"    // rangoABloques
+#include "pool_trabajo.h" // PoolTrabajo
+#include "resumen.h"      // fusionarRangos, ordenarRangosParalelo, parsePrefijosLote y escribirResumen
+
+using namespace std;
+
+static int fallos = 0;
+
+static void fallar(const string& caso, const string& detalle) {
+    ++fallos;
+    if (fallos <= 20) {
+        cerr << "FALLO " << caso << ": " << detalle << "\n";
+    }
+}
+
+/**
+ * @brief Generador determinista (splitmix64) para que los casos no cambien entre ejecuciones.
+ */
+static uint64_t siguienteAleatorio(uint64_t& estado) {
+    uint64_t z = (estado += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static bool ordenPorInicio(const RangoIPv4& a, const RangoIPv4& b) {
+    return a.inicio < b.inicio || (a.inicio == b.inicio && a.fin < b.fin);
+}
+
+/**
+ * @brief Cantidad mínima de bloques alineados que cubren [inicio, fin] exactamente: un nodo del
+ * árbol de prefijos contenido en el rango cuenta uno; uno que lo corta se reparte entre sus hijos.
+ */
+static uint64_t coberturaMinima(uint64_t red, int cidr, uint64_t inicio, uint64_t fin) {
+    const uint64_t ultima = red + (uint64_t(1) << (32 - cidr)) - 1;
+    if (ultima < inicio || red > fin) {
+        return 0;
+    }
+    if (red >= inicio && ultima <= fin) {
+        return 1;
+    }
+    const uint64_t mitad = uint64_t(1) << (31 - cidr);
+    return coberturaMinima(red, cidr + 1, inicio, fin) + coberturaMinima(red + mitad, cidr + 1, inicio, fin);
+}
+
+/**
+ * @brief Comprueba que los bloques de un rango estén alineados, en orden, lo cubran sin huecos y sean los mínimos.
+ */
+static void comprobarBloques(const string& caso, const RangoIPv4& rango) {
+    vector<BloqueIPv4> bloques;
+    rangoABloques(rango, bloques);
+    uint64_t siguiente = rango.inicio;
+    for (const BloqueIPv4& bloque : bloques) {
+        const uint64_t tamano = uint64_t(1) << (32 - bloque.cidr);
+        if (bloque.red != siguiente || bloque.red % tamano != 0) {
+            fallar(caso, "bloque desalineado o fuera de orden");
+            return;
+        }
+        siguiente += tamano;
+    }
+    if (siguiente != uint64_t(rango.fin) + 1) {
+        fallar(caso, "los bloques no cubren el rango exactamente");
+    } else if (bloques.size() != coberturaMinima(0, 0, rango.inicio, rango.fin)) {
+        fallar(caso, to_string(bloques.size()) + " bloques, el mínimo es " +
+                     to_string(coberturaMinima(0, 0, rango.inicio, rango.fin)));
+    }
+}
+
+/**
+ * @brief Rangos aleatorios en una ventana de 512 direcciones, fusionados y comparados con el mapa de bits.
+ */
+static void pruebaFusion(uint64_t semilla, uint32_t ventana) {
+    uint64_t estado = semilla;
+    vector<bool> cubierta(512, false);
+    vector<RangoIPv4> rangos;
+    const size_t cantidad = siguienteAleatorio(estado) % 30;
+    for (size_t i = 0; i < cantidad; ++i) {
+        const uint32_t inicio = static_cast<uint32_t>(siguienteAleatorio(estado) % 512);
+        const uint32_t fin = min<uint32_t>(511, inicio + static_cast<uint32_t>(siguienteAleatorio(estado) % 40));
+        rangos.push_back({ventana + inicio, ventana + fin});
+        for (uint32_t d = inicio; d <= fin; ++d) {
+            cubierta[d] = true;
+        }
+    }
+    vector<RangoIPv4> esperados;
+    for (uint32_t d = 0; d < 512; ++d) {
+        if (!cubierta[d]) {
+            continue;
+        }
+        if (!esperados.empty() && esperados.back().fin + 1 == ventana + d) {
+            esperados.back().fin = ventana + d;
+        } else {
+            esperados.push_back({ventana + d, ventana + d});
+        }
+    }
+
+    const string caso = "fusión, semilla " + to_string(semilla) + ", ventana " + to_string(ventana);
+    sort(rangos.begin(), rangos.end(), ordenPorInicio);
+    fusionarRangos(rangos);
+    bool iguales = rangos.size() == esperados.size();
+    for (size_t i = 0; iguales && i < rangos.size(); ++i) {
+        iguales = rangos[i].inicio == esperados[i].inicio && rangos[i].fin == esperados[i].fin;
+    }
+    if (!iguales) {
+        fallar(caso, to_string(rangos.size()) + " rangos fusionados, se esperaban " + to_string(esperados.size()));
+    }
+    for (const RangoIPv4& rango : rangos) {
+        comprobarBloques(caso, rango);
+    }
+}
+
+static void pruebaOrdenacion(PoolTrabajo& pool, size_t cantidad, uint64_t semilla) {
+    uint64_t estado = semilla;
+    vector<RangoIPv4> rangos(cantidad);
+    for (RangoIPv4& rango : rangos) {
+        // Inicios repetidos a propósito: la mitad de las veces solo varían los 8 bits bajos
+        const uint32_t mascara = siguienteAleatorio(estado) % 2 == 0 ? 0xFFu : 0xFFFFFFFFu;
+        const uint32_t inicio = static_cast<uint32_t>(siguienteAleatorio(estado)) & mascara;
+        const uint32_t longitud = static_cast<uint32_t>(siguienteAleatorio(estado) % 1000);
+        rango = {inicio, inicio + min(longitud, ~inicio)};
+    }
+    vector<RangoIPv4> referencia = rangos;
+    sort(referencia.begin(), referencia.end(), ordenPorInicio);
+    ordenarRangosParalelo(rangos, pool);
+
+    const string caso = "ordenación de " + to_string(cantidad) + " rangos";
+    if (!is_sorted(rangos.begin(), rangos.end(), [](const RangoIPv4& a, const RangoIPv4& b) { return a.inicio < b.inicio; })) {
+        fallar(caso, "no quedaron ordenados por inicio");
+    }
+    // Con inicios iguales el orden de los finales no está definido: se compara como multiconjunto
+    sort(rangos.begin(), rangos.end(), ordenPorInicio);
+    for (size_t i = 0; i < cantidad; ++i) {
+        if (rangos[i].inicio != referencia[i].inicio || rangos[i].fin != referencia[i].fin) {
+            fallar(caso, "los rangos ordenados no son los de entrada");
+            break;
+        }
+    }
+}
+
+int main() {
+    for (uint64_t semilla = 1; semilla <= 300; ++semilla) {
+        pruebaFusion(semilla, 0);
+        pruebaFusion(semilla, 0x0A0000F0u);
+        pruebaFusion(semilla, 0xFFFFFE00u);
+    }
+
+    // Fusión de rangos que tocan el final del espacio (fin + 1 desborda) y del espacio entero
+    vector<RangoIPv4> extremos = {{0, 0x7FFFFFFFu}, {0x80000000u, 0xFFFFFFF0u}, {0xFFFFFFF1u, 0xFFFFFFFFu}, {5, 6}};
+    sort(extremos.begin(), extremos.end(), ordenPorInicio);
+    fusionarRangos(extremos);
+    if (extremos.size() != 1 || extremos[0].inicio != 0 || extremos[0].fin != 0xFFFFFFFFu) {
+        fallar("espacio completo", to_string(extremos.size()) + " rangos fusionados");
+    }
+
+    // Rangos grandes, en todo el espacio de 32 bits
+    uint64_t estado = 42;
+    comprobarBloques("0.0.0.0-255.255.255.255", {0, 0xFFFFFFFFu});
+    comprobarBloques("0.0.0.1-255.255.255.254", {1, 0xFFFFFFFEu});
+    for (int i = 0; i < 2000; ++i) {
+        uint32_t a = static_cast<uint32_t>(siguienteAleatorio(estado));
+        uint32_t b = static_cast<uint32_t>(siguienteAleatorio(estado));
+        comprobarBloques("rango aleatorio " + to_string(i), {min(a, b), max(a, b)});
+    }
+
+    // rangoABloques con direcciones de 128 bits
+    vector<BloqueIPv6> bloques6;
+    rangoABloques<uint128_t>({0, ~uint128_t(0)}, bloques6);
+    if (bloques6.size() != 1 || bloques6[0].cidr != 0) {
+        fallar("IPv6 ::/0", to_string(bloques6.size()) + " bloques");
+    }
+    bloques6.clear();
+    rangoABloques<uint128_t>({1, ~uint128_t(0) - 1}, bloques6);
+    if (bloques6.size() != 254 || bloques6.front().cidr != 128 || bloques6.back().cidr != 128 ||
+        bloques6[126].cidr != 2 || bloques6[127].cidr != 2) {
+        fallar("IPv6 ::1 a ffff:...:fffe", to_string(bloques6.size()) + " bloques, se esperaban 254");
+    }
+
+    PoolTrabajo pool(4);
+    for (size_t cantidad : {size_t(0), size_t(1), size_t(7), size_t(1000), size_t(200000)}) {
+        pruebaOrdenacion(pool, cantidad, cantidad + 1);
+    }
+
+    // Formatos de parsePrefijosLote: CIDR, máscara tras '/', máscara tras espacio, /32 implícito
+    const string texto = "10.0.0.0/8\n"
+                         "192.168.1.5/24 via 10.0.0.1 dev eth0\n"
+                         "# comentario\n"
+                         "\n"
+                         "172.16.0.0/255.240.0.0\n"
+                         "1.2.3.4 255.255.255.0\n"
+                         "8.8.8.8\n"
+                         "no es un prefijo\n"
+                         "10.0.0.0/33\n";
+    vector<RangoIPv4> leidos;
+    const ResultadoLotePrefijos resultado = parsePrefijosLote(texto, leidos);
+    const vector<RangoIPv4> esperados = {{0x0A000000u, 0x0AFFFFFFu},
+                                         {0xC0A80100u, 0xC0A801FFu},
+                                         {0xAC100000u, 0xAC1FFFFFu},
+                                         {0x01020300u, 0x010203FFu},
+                                         {0x08080808u, 0x08080808u}};
+    bool iguales = leidos.size() == esperados.size();
+    for (size_t i = 0; iguales && i < esperados.size(); ++i) {
+        iguales = leidos[i].inicio == esperados[i].inicio && leidos[i].fin == esperados[i].fin;
+    }
+    if (!iguales || resultado.validos != 5 || resultado.invalidos != 2 || resultado.conBitsDeHost != 2) {
+        fallar("parsePrefijosLote", to_string(resultado.validos) + " válidos, " + to_string(resultado.invalidos) +
+                                    " inválidos, " + to_string(resultado.conBitsDeHost) + " con bits de host");
+    }
+
+    // escribirResumen: 10.0.0.0/8 absorbe 10.1.0.0/16 y forma con 11.0.0.0/8 un /7; 13.0.0.0/8 queda aparte
+    vector<RangoIPv4> resumen = {{0x0A000000u, 0x0AFFFFFFu}, {0x0A010000u, 0x0A01FFFFu}, {0x0B000000u, 0x0BFFFFFFu},
+                                 {0x0D000000u, 0x0DFFFFFFu}};
+    fusionarRangos(resumen);
+    ostringstream salida;
+    if (escribirResumen(salida, resumen) != 2 || salida.str() != "10.0.0.0/7\n13.0.0.0/8\n") {
+        fallar("escribirResumen", "salida '" + salida.str() + "'");
+    }
+
+    if (fallos > 0) {
+        cerr << fallos << " casos fallidos\n";
+        return 1;
+    }
+    cout << "Pruebas del resumen de prefijos correctas\n";
+    return 0;
+}
@@ -0,0 +1,271 @@
+// Pruebas del análisis de utilización: planes aleatorios con rangos reservados, desde un /0 hasta
+// un /32, comparados con una referencia que recorre el árbol de prefijos sobre los tramos libres
+// (válida a cualquier escala, también cuando el mapa limita la resolución) y, en las redes
+// pequeñas, con un mapa de un bit por dirección. Incluye los casos con la resolución limitada cuyos
+// totales y prefijos finos se completan a partir de los tramos libres. Termina con código 1 si falla
+// algún caso.
+//
+// Compilación y ejecución: cmake -S . -B build && cmake --build build --target prueba_utilizacion && ctest --test-dir build
+
+#include <algorithm> // Para std::sort y std::min
+#include <array>     // Para std::array
+#include <cstdint>   // Para uint32_t y otros tipos enteros de ancho fijo
+#include <iostream>  // Para std::cout y std::cerr
+#include <string>    // Para std::string y std::to_string
+#include <utility>   // Para std::pair
+#include <vector>    // Para std::vector
+
+#include "direcciones.h" // intToIp
+#include "subredes.h"    // planificarSubredes y describirErrorPlan
+#include "utilizacion.h" // analizarUtilizacion
+
+using namespace std;
+
+static int fallos = 0;
+
+static void fallar(const string& caso, const string& detalle) {
+    ++fallos;
+    if (fallos <= 20) {
+        cerr << "FALLO " << caso << ": " << detalle << "\n";
+    }
+}
+
+/**
+ * @brief Generador determinista (splitmix64) para que los casos no cambien entre ejecuciones.
+ */
+static uint64_t siguienteAleatorio(uint64_t& estado) {
+    uint64_t z = (estado += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Resultado esperado, calculado sin el mapa de ocupación.
+ */
+struct Referencia {
+    uint64_t libres = 0;
+    uint64_t enSubredes = 0;
+    uint64_t tramos = 0;
+    int mayorBloqueLibre = -1;
+    array<uint64_t, 33> bloquesLibres = {};
+};
+
+/**
+ * @brief Tramos libres de la red base: el complemento de subredes y reservados (en 64 bits).
+ */
+static vector<pair<uint64_t, uint64_t>> tramosLibres(const PlanSubredes& plan) {
+    vector<pair<uint64_t, uint64_t>> ocupados;
+    for (const Subred& subred : plan.subredes) {
+        ocupados.push_back({subred.red, subred.broadcast()});
+    }
+    for (const RangoIPv4& rango : plan.reservados) {
+        const uint64_t inicio = max<uint64_t>(rango.inicio, plan.redBase);
+        const uint64_t fin = min<uint64_t>(rango.fin, plan.broadcastBase);
+        if (inicio <= fin) {
+            ocupados.push_back({inicio, fin});
+        }
+    }
+    sort(ocupados.begin(), ocupados.end());
+    vector<pair<uint64_t, uint64_t>> libres;
+    uint64_t actual = plan.redBase;
+    for (const auto& ocupado : ocupados) {
+        if (ocupado.first > actual) {
+            libres.push_back({actual, ocupado.first - 1});
+        }
+        actual = max(actual, ocupado.second + 1);
+    }
+    if (actual <= plan.broadcastBase) {
+        libres.push_back({actual, plan.broadcastBase});
+    }
+    return libres;
+}
+
+/**
+ * @brief Recorre el árbol de prefijos: un nodo libre entero aporta 2^(p - cidr) bloques de cada
+ * prefijo p más largo; uno ocupado entero, ninguno; uno mixto se reparte entre sus hijos.
+ */
+static void contarBloques(uint64_t red, int cidr, const vector<pair<uint64_t, uint64_t>>& libres, Referencia& referencia) {
+    const uint64_t ultima = red + (uint64_t(1) << (32 - cidr)) - 1;
+    bool toca = false;
+    for (const auto& tramo : libres) {
+        if (tramo.first <= red && ultima <= tramo.second) {
+            for (int p = cidr; p <= 32; ++p) {
+                referencia.bloquesLibres[p] += uint64_t(1) << (p - cidr);
+            }
+            if (referencia.mayorBloqueLibre < 0 || cidr < referencia.mayorBloqueLibre) {
+                referencia.mayorBloqueLibre = cidr;
+            }
+            return;
+        }
+        toca = toca || (tramo.first <= ultima && red <= tramo.second);
+    }
+    if (toca) {
+        const uint64_t mitad = uint64_t(1) << (31 - cidr);
+        contarBloques(red, cidr + 1, libres, referencia);
+        contarBloques(red + mitad, cidr + 1, libres, referencia);
+    }
+}
+
+static Referencia calcularReferencia(const PlanSubredes& plan) {
+    Referencia referencia;
+    const vector<pair<uint64_t, uint64_t>> libres = tramosLibres(plan);
+    for (const auto& tramo : libres) {
+        referencia.libres += tramo.second - tramo.first + 1;
+    }
+    for (const Subred& subred : plan.subredes) {
+        referencia.enSubredes += uint64_t(subred.broadcast()) - subred.red + 1;
+    }
+    referencia.tramos = libres.size();
+    contarBloques(plan.redBase, plan.cidrBase, libres, referencia);
+    return referencia;
+}
+
+/**
+ * @brief La misma referencia con un bit por dirección, para comprobar la del árbol en redes pequeñas.
+ */
+static Referencia calcularReferenciaBits(const PlanSubredes& plan) {
+    Referencia referencia;
+    vector<bool> ocupada(plan.totalIps(), false);
+    for (const Subred& subred : plan.subredes) {
+        for (uint64_t d = subred.red; d <= subred.broadcast(); ++d) {
+            ocupada[d - plan.redBase] = true;
+        }
+        referencia.enSubredes += uint64_t(subred.broadcast()) - subred.red + 1;
+    }
+    for (const RangoIPv4& rango : plan.reservados) {
+        for (uint64_t d = rango.inicio; d <= rango.fin; ++d) {
+            if (d >= plan.redBase && d <= plan.broadcastBase) {
+                ocupada[d - plan.redBase] = true;
+            }
+        }
+    }
+    for (size_t i = 0; i < ocupada.size(); ++i) {
+        referencia.libres += ocupada[i] ? 0 : 1;
+        referencia.tramos += !ocupada[i] && (i == 0 || ocupada[i - 1]) ? 1 : 0;
+    }
+    for (int p = 32; p >= plan.cidrBase; --p) {
+        const size_t tamano = size_t(1) << (32 - p);
+        for (size_t inicio = 0; inicio < ocupada.size(); inicio += tamano) {
+            bool libre = true;
+            for (size_t d = inicio; libre && d < inicio + tamano; ++d) {
+                libre = !ocupada[d];
+            }
+            if (libre) {
+                ++referencia.bloquesLibres[p];
+                referencia.mayorBloqueLibre = p;
+            }
+        }
+    }
+    return referencia;
+}
+
+static void comparar(const string& caso, const AnalisisUtilizacion& analisis, const Referencia& referencia, const PlanSubredes& plan) {
+    if (analisis.totales != plan.totalIps() || analisis.libres != referencia.libres ||
+        analisis.usadas != plan.totalIps() - referencia.libres || analisis.enSubredes != referencia.enSubredes) {
+        fallar(caso, "libres " + to_string(analisis.libres) + " (esperadas " + to_string(referencia.libres) + "), usadas " +
+                     to_string(analisis.usadas) + ", en subredes " + to_string(analisis.enSubredes) + " (esperadas " +
+                     to_string(referencia.enSubredes) + ")");
+    }
+    if (analisis.rangosLibres != referencia.tramos || analisis.mayorBloqueLibre != referencia.mayorBloqueLibre) {
+        fallar(caso, to_string(analisis.rangosLibres) + " tramos y mayor bloque /" + to_string(analisis.mayorBloqueLibre) +
+                     ", esperados " + to_string(referencia.tramos) + " y /" + to_string(referencia.mayorBloqueLibre));
+    }
+    for (int p = 0; p <= 32; ++p) {
+        if (analisis.bloquesLibres[p] != referencia.bloquesLibres[p]) {
+            fallar(caso, "/" + to_string(p) + ": " + to_string(analisis.bloquesLibres[p]) + " bloques libres, esperados " +
+                         to_string(referencia.bloquesLibres[p]));
+            break;
+        }
+    }
+}
+
+static void pruebaAleatoria(uint64_t semilla) {
+    uint64_t estado = semilla;
+    static const int PREFIJOS[] = {0, 4, 8, 12, 16, 20, 22, 24, 26, 28, 30, 32};
+    const int cidr = PREFIJOS[siguienteAleatorio(estado) % 12];
+    const uint64_t tamano = uint64_t(1) << (32 - cidr);
+    const uint32_t base = static_cast<uint32_t>(siguienteAleatorio(estado) & ~(tamano - 1));
+
+    vector<int> hosts;
+    const size_t cantidad = siguienteAleatorio(estado) % 21;
+    for (size_t i = 0; i < cantidad; ++i) {
+        hosts.push_back(static_cast<int>(1 + siguienteAleatorio(estado) % max<uint64_t>(1, min<uint64_t>(tamano / 4, 1000000))));
+    }
+    vector<RangoIPv4> reservados;
+    const size_t cantidadReservados = siguienteAleatorio(estado) % 5;
+    for (size_t i = 0; i < cantidadReservados; ++i) {
+        const uint64_t inicio = base + siguienteAleatorio(estado) % tamano;
+        const uint64_t fin = min<uint64_t>(uint64_t(base) + tamano - 1, inicio + siguienteAleatorio(estado) % max<uint64_t>(1, tamano / 8));
+        reservados.push_back({static_cast<uint32_t>(inicio), static_cast<uint32_t>(fin)});
+    }
+
+    PlanSubredes plan;
+    planificarSubredes(plan, intToIp(base), cidr, hosts, reservados);
+    const string caso = "semilla " + to_string(semilla) + " (" + intToIp(base) + "/" + to_string(cidr) + ")";
+    if (plan.resultado != ResultadoPlan::Correcto) {
+        fallar(caso, describirErrorPlan(plan));
+        return;
+    }
+    AnalisisUtilizacion analisis;
+    analizarUtilizacion(plan, analisis);
+    const Referencia referencia = calcularReferencia(plan);
+    comparar(caso, analisis, referencia, plan);
+    if (tamano <= 4096) {
+        comparar(caso + " con un bit por dirección", analisis, calcularReferenciaBits(plan), plan);
+    }
+}
+
+/**
+ * @brief Un caso fijo: el plan de un trabajo y su análisis frente a la referencia del árbol.
+ */
+static AnalisisUtilizacion pruebaFija(const string& caso, const string& ipBase, int cidr, const vector<int>& hosts,
+                                      const vector<RangoIPv4>& reservados) {
+    PlanSubredes plan;
+    planificarSubredes(plan, ipBase, cidr, hosts, reservados);
+    AnalisisUtilizacion analisis;
+    analizarUtilizacion(plan, analisis);
+    comparar(caso, analisis, calcularReferencia(plan), plan);
+    return analisis;
+}
+
+int main() {
+    for (uint64_t semilla = 1; semilla <= 400; ++semilla) {
+        pruebaAleatoria(semilla);
+    }
+
+    // Resolución limitada: una sola dirección reservada en un /0 no cabe en el mapa de 2^26 bits
+    AnalisisUtilizacion analisis = pruebaFija("0.0.0.0/0 100 1.2.3.4-1.2.3.4", "0.0.0.0", 0, {100}, {{0x01020304u, 0x01020304u}});
+    if (analisis.exacto || analisis.usadas - analisis.enSubredes != 1 || analisis.libres != (uint64_t(1) << 32) - 128 - 1) {
+        fallar("0.0.0.0/0 100 1.2.3.4-1.2.3.4", "reservadas " + to_string(analisis.usadas - analisis.enSubredes) +
+                                                 ", libres " + to_string(analisis.libres));
+    }
+
+    // Un /30 en los 15 últimos libres del espacio: .241, .242-.243 y .248-.255 quedan libres
+    analisis = pruebaFija("0.0.0.0/0 2 0.0.0.0-255.255.255.240", "0.0.0.0", 0, {2}, {{0, 0xFFFFFFF0u}});
+    if (analisis.libres != 11 || analisis.rangosLibres != 2 || analisis.mayorBloqueLibre != 29 ||
+        analisis.bloquesLibres[30] != 2 || analisis.bloquesLibres[31] != 5 || analisis.bloquesLibres[32] != 11) {
+        fallar("0.0.0.0/0 2 0.0.0.0-255.255.255.240", "libres " + to_string(analisis.libres) + ", " +
+                                                       to_string(analisis.rangosLibres) + " tramos, mayor /" +
+                                                       to_string(analisis.mayorBloqueLibre));
+    }
+
+    // Límites alineados: el mapa trabaja a la resolución de los bloques y el resultado es exacto
+    analisis = pruebaFija("10.0.0.0/8 1000 500", "10.0.0.0", 8, {1000, 500}, {});
+    if (!analisis.exacto || analisis.resolucion != 23) {
+        fallar("10.0.0.0/8 1000 500", "resolución /" + to_string(analisis.resolucion));
+    }
+
+    // Base /32 sin espacio libre
+    analisis = pruebaFija("192.0.2.1/32 0", "192.0.2.1", 32, {0}, {});
+    if (analisis.libres != 0 || analisis.mayorBloqueLibre != -1 || analisis.fragmentacion != 0) {
+        fallar("192.0.2.1/32 0", "libres " + to_string(analisis.libres));
+    }
+
+    if (fallos > 0) {
+        cerr << fallos << " casos fallidos\n";
+        return 1;
+    }
+    cout << "Pruebas del análisis de utilización correctas\n";
+    return 0;
+}
@@ -0,0 +1,381 @@
+#include "replanificacion.h"
+
+#include <algorithm> // Para std::sort, std::stable_sort
+
+#include "bufer_salida.h"   // Escritura de la salida por bloques
+#include "calculo_subred.h" // Aritmética de subredes con enteros
+#include "direcciones.h"    // Para formatearIPv4
+
+using namespace std;
+
+/**
+ * @brief Convierte un número decimal sin signo de texto completo, sin excepciones.
+ */
+static bool parseNumero(const string& texto, size_t inicio, size_t fin, uint64_t& valor) {
+    if (inicio >= fin || fin - inicio > 10) {
+        return false;
+    }
+    uint64_t v = 0;
+    for (size_t i = inicio; i < fin; ++i) {
+        if (texto[i] < '0' || texto[i] > '9') {
+            return false;
+        }
+        v = v * 10 + static_cast<uint64_t>(texto[i] - '0');
+    }
+    valor = v;
+    return true;
+}
+
+bool analizarEdicion(const string& texto, EdicionPlan& edicion, string& error) {
+    uint64_t numero = 0;
+    uint64_t hosts = 0;
+    const size_t igual = texto.find('=');
+    bool valida;
+    if (!texto.empty() && texto[0] == '+') {
+        edicion.tipo = TipoEdicion::Agregar;
+        valida = parseNumero(texto, 1, texto.size(), hosts);
+    } else if (!texto.empty() && texto[0] == '-') {
+        edicion.tipo = TipoEdicion::Eliminar;
+        valida = parseNumero(texto, 1, texto.size(), numero) && numero > 0;
+    } else if (igual != string::npos) {
+        edicion.tipo = TipoEdicion::Redimensionar;
+        valida = parseNumero(texto, 0, igual, numero) && numero > 0 && parseNumero(texto, igual + 1, texto.size(), hosts);
+    } else {
+        valida = false;
+    }
+    if (!valida || hosts > static_cast<uint64_t>(INT32_MAX)) {
+        error = "Error: Edición inválida '" + texto + "'. Use +HOSTS para agregar, -N para eliminar la subred N o N=HOSTS para redimensionarla.";
+        return false;
+    }
+    edicion.numero = static_cast<size_t>(numero);
+    edicion.hosts = static_cast<int>(hosts);
+    return true;
+}
+
+void PlanificadorIncremental::cargar(const PlanSubredes& plan) {
+    partida.ipBaseStr = plan.ipBaseStr;
+    partida.cidrBase = plan.cidrBase;
+    partida.redBase = plan.redBase;
+    partida.broadcastBase = plan.broadcastBase;
+    partida.resultado = plan.resultado;
+    partida.reservados = plan.reservados;
+    partida.fallidas = plan.fallidas;
+    subredes = plan.subredes;
+    vigente.assign(subredes.size(), true);
+    eliminadas.clear();
+    vigentes = subredes.size();
+    rechazadas.clear();
+
+    // El espacio ocupado son los reservados más las subredes del plan
+    vector<RangoIPv4> ocupados = plan.reservados;
+    ocupados.reserve(ocupados.size() + subredes.size());
+    for (const Subred& subnet : subredes) {
+        ocupados.push_back({subnet.red, subnet.broadcast()});
+    }
+    asignador.inicializar(plan.redBase, plan.cidrBase, ocupados);
+}
+
+bool PlanificadorIncremental::aplicar(const vector<EdicionPlan>& ediciones, vector<CambioPlan>& cambios, string& error) {
+    cambios.clear();
+
+    // Validación completa antes de tocar nada
+    vector<size_t> editadas;
+    for (const EdicionPlan& e : ediciones) {
+        if (e.tipo != TipoEdicion::Eliminar && hostsToCidr(e.hosts) < 0) {
+            error = "Error: Número de hosts inválido (" + to_string(e.hosts) + ").";
+            return false;
+        }
+        if (e.tipo == TipoEdicion::Agregar) {
+            continue;
+        }
+        if (e.numero == 0 || e.numero > subredes.size() || !vigente[e.numero - 1]) {
+            error = "Error: La subred " + to_string(e.numero) + " no existe en el plan.";
+            return false;
+        }
+        editadas.push_back(e.numero);
+    }
+    sort(editadas.begin(), editadas.end());
+    if (adjacent_find(editadas.begin(), editadas.end()) != editadas.end()) {
+        error = "Error: La subred " + to_string(*adjacent_find(editadas.begin(), editadas.end())) + " se edita más de una vez.";
+        return false;
+    }
+
+    // Subredes que necesitan un bloque más grande o nuevo; se colocan al final, de mayor a menor
+    struct Pendiente {
+        size_t numero;
+        int cidr;
+        uint32_t hosts;
+        bool nueva;
+    };
+    vector<Pendiente> pendientes;
+
+    for (const EdicionPlan& e : ediciones) {
+        if (e.tipo == TipoEdicion::Agregar) {
+            subredes.push_back({0, static_cast<uint32_t>(e.hosts), 0, {}});
+            vigente.push_back(false);
+            pendientes.push_back({subredes.size(), hostsToCidr(e.hosts), static_cast<uint32_t>(e.hosts), true});
+            continue;
+        }
+        Subred& subnet = subredes[e.numero - 1];
+        if (e.tipo == TipoEdicion::Eliminar) {
+            asignador.liberar(subnet.red, subnet.cidr);
+            vigente[e.numero - 1] = false;
+            eliminadas.insert(lower_bound(eliminadas.begin(), eliminadas.end(), e.numero - 1), e.numero - 1);
+            --vigentes;
+            cambios.push_back({TipoCambio::Eliminada, e.numero, 0, subnet.red, subnet.cidr, subnet.hostsSolicitados, 0, -1, 0,
+                               MotivoFallo::HostsInvalidos});
+            continue;
+        }
+        const int cidrNuevo = hostsToCidr(e.hosts);
+        if (cidrNuevo < subnet.cidr) {
+            pendientes.push_back({e.numero, cidrNuevo, static_cast<uint32_t>(e.hosts), false});
+            continue;
+        }
+        // Mismo tamaño o más pequeña: se queda en su dirección de red
+        const CambioPlan cambio = {TipoCambio::Redimensionada, e.numero, 0, subnet.red, subnet.cidr, subnet.hostsSolicitados,
+                                   subnet.red, cidrNuevo, static_cast<uint32_t>(e.hosts), MotivoFallo::HostsInvalidos};
+        if (cidrNuevo != subnet.cidr) {
+            asignador.liberar(subnet.red, subnet.cidr);
+            asignador.asignarEn(subnet.red, cidrNuevo);
+        }
+        subnet.cidr = static_cast<uint8_t>(cidrNuevo);
+        subnet.hostsSolicitados = static_cast<uint32_t>(e.hosts);
+        cambios.push_back(cambio);
+    }
+
+    stable_sort(pendientes.begin(), pendientes.end(), [](const Pendiente& a, const Pendiente& b) { return a.cidr < b.cidr; });
+    for (const Pendiente& p : pendientes) {
+        Subred& subnet = subredes[p.numero - 1];
+        CambioPlan cambio = {TipoCambio::Rechazada, p.numero, 0, subnet.red, p.nueva ? -1 : subnet.cidr, subnet.hostsSolicitados,
+                             0, p.cidr, p.hosts, MotivoFallo::MayorQueRedBase};
+        if (p.nueva) {
+            cambio.redAnterior = 0;
+            cambio.hostsAnteriores = 0;
+        }
+        if (p.cidr < partida.cidrBase) {
+            if (p.nueva) {
+                rechazadas.push_back({static_cast<int>(p.hosts), p.cidr, MotivoFallo::MayorQueRedBase, asignador.mayorBloqueLibre(),
+                                      asignador.direccionesLibres()});
+                eliminadas.insert(lower_bound(eliminadas.begin(), eliminadas.end(), p.numero - 1), p.numero - 1);
+            }
+            cambios.push_back(cambio);
+            continue;
+        }
+
+        uint32_t red;
+        bool colocada;
+        if (p.nueva) {
+            colocada = asignador.asignar(p.cidr, red);
+        } else {
+            // Crece en su sitio si el bloque alineado que la contiene está libre; si no, se mueve
+            asignador.liberar(subnet.red, subnet.cidr);
+            red = subnet.red & mascaraDePrefijo(PrefijoIPv4(p.cidr));
+            colocada = asignador.asignarEn(red, p.cidr) || asignador.asignar(p.cidr, red);
+        }
+        if (!colocada) {
+            cambio.motivo = asignador.direccionesLibres() < tamanoBloque(PrefijoIPv4(p.cidr)) ? MotivoFallo::SinEspacio
+                                                                                               : MotivoFallo::Fragmentacion;
+            if (p.nueva) {
+                rechazadas.push_back({static_cast<int>(p.hosts), p.cidr, cambio.motivo, asignador.mayorBloqueLibre(),
+                                      asignador.direccionesLibres()});
+                eliminadas.insert(lower_bound(eliminadas.begin(), eliminadas.end(), p.numero - 1), p.numero - 1);
+            } else {
+                asignador.asignarEn(subnet.red, subnet.cidr); // Vuelve a su bloque, que sigue libre
+            }
+            cambios.push_back(cambio);
+            continue;
+        }
+
+        if (p.nueva) {
+            cambio.tipo = TipoCambio::Agregada;
+            vigente[p.numero - 1] = true;
+            ++vigentes;
+        } else {
+            cambio.tipo = red == subnet.red ? TipoCambio::Redimensionada : TipoCambio::Movida;
+        }
+        cambio.redNueva = red;
+        subnet.red = red;
+        subnet.cidr = static_cast<uint8_t>(p.cidr);
+        subnet.hostsSolicitados = p.hosts;
+        cambios.push_back(cambio);
+    }
+
+    sort(cambios.begin(), cambios.end(), [](const CambioPlan& a, const CambioPlan& b) { return a.numero < b.numero; });
+
+    // obtenerPlan() compacta las subredes no vigentes: el número resultante descuenta las anteriores
+    for (CambioPlan& c : cambios) {
+        if (vigente[c.numero - 1]) {
+            c.numeroResultante = c.numero - static_cast<size_t>(lower_bound(eliminadas.begin(), eliminadas.end(), c.numero - 1) -
+                                                                eliminadas.begin());
+        }
+    }
+    return true;
+}
+
+void PlanificadorIncremental::obtenerPlan(PlanSubredes& plan) const {
+    plan.ipBaseStr = partida.ipBaseStr;
+    plan.cidrBase = partida.cidrBase;
+    plan.redBase = partida.redBase;
+    plan.broadcastBase = partida.broadcastBase;
+    plan.resultado = partida.resultado;
+    plan.reservados = partida.reservados;
+    plan.subredes.clear();
+    plan.subredes.reserve(vigentes);
+    for (size_t i = 0; i < subredes.size(); ++i) {
+        if (vigente[i]) {
+            plan.subredes.push_back(subredes[i]);
+        }
+    }
+    plan.fallidas = partida.fallidas;
+    plan.fallidas.insert(plan.fallidas.end(), rechazadas.begin(), rechazadas.end());
+    asignador.rangosLibres(plan.espacioLibre);
+    plan.direccionesLibres = asignador.direccionesLibres();
+}
+
+static const char* nombreCambio(TipoCambio tipo) {
+    switch (tipo) {
+        case TipoCambio::Agregada: return "Agregada";
+        case TipoCambio::Eliminada: return "Eliminada";
+        case TipoCambio::Redimensionada: return "Redimensionada";
+        case TipoCambio::Movida: return "Movida";
+        case TipoCambio::Rechazada: return "Rechazada";
+    }
+    return "";
+}
+
+static const char* nombreMotivo(MotivoFallo motivo) {
+    switch (motivo) {
+        case MotivoFallo::HostsInvalidos: return "hosts inválidos";
+        case MotivoFallo::MayorQueRedBase: return "más grande que la red base";
+        case MotivoFallo::SinEspacio: return "sin espacio suficiente";
+        case MotivoFallo::Fragmentacion: return "espacio libre fragmentado";
+    }
+    return "";
+}
+
+// Ancho de cada columna de la tabla de cambios, en bytes
+static const int ANCHO_NUMERO_CAMBIO = 6;
+static const int ANCHO_TIPO_CAMBIO = 16;
+static const int ANCHO_BLOQUE_CAMBIO = 20;
+
+/**
+ * @brief Escribe "RED/CIDR" (o "-" si no hay bloque), alineado en una columna si 'ancho' > 0.
+ */
+static void escribirBloque(BuferSalida& bufer, bool hayBloque, uint32_t red, int cidr, int ancho) {
+    char* inicio = bufer.reservar(static_cast<size_t>(ancho) + 24);
+    char* p = inicio;
+    if (hayBloque) {
+        p = formatearIPv4(p, red);
+        *p++ = '/';
+        p = BuferSalida::formatearEntero(p, static_cast<uint64_t>(cidr));
+    } else {
+        *p++ = '-';
+    }
+    while (p < inicio + ancho) {
+        *p++ = ' ';
+    }
+    bufer.avanzar(p);
+}
+
+void imprimirCambios(ostream& os, const vector<CambioPlan>& cambios, size_t sinCambios, bool is_csv_output) {
+    BuferSalida bufer(os);
+    if (is_csv_output) {
+        bufer.texto("Numero,Cambio,RedAnterior,CIDRAnterior,HostsAnteriores,RedNueva,CIDRNueva,HostsNuevos,Motivo\n");
+        for (const CambioPlan& c : cambios) {
+            const bool hayAnterior = c.cidrAnterior >= 0;
+            const bool hayNueva = c.tipo != TipoCambio::Eliminada && c.tipo != TipoCambio::Rechazada;
+            if (c.numeroResultante > 0) {
+                bufer.entero(c.numeroResultante);
+            }
+            bufer.caracter(',');
+            bufer.texto(nombreCambio(c.tipo));
+            bufer.caracter(',');
+            if (hayAnterior) {
+                bufer.ipv4(c.redAnterior);
+                bufer.texto(",/");
+                bufer.entero(static_cast<uint64_t>(c.cidrAnterior));
+                bufer.caracter(',');
+                bufer.entero(c.hostsAnteriores);
+            } else {
+                bufer.texto(",,");
+            }
+            bufer.caracter(',');
+            if (hayNueva) {
+                bufer.ipv4(c.redNueva);
+            }
+            bufer.caracter(',');
+            if (c.tipo != TipoCambio::Eliminada) {
+                bufer.caracter('/');
+                bufer.entero(static_cast<uint64_t>(c.cidrNueva));
+                bufer.caracter(',');
+                bufer.entero(c.hostsNuevos);
+            } else {
+                bufer.caracter(',');
+            }
+            bufer.caracter(',');
+            if (c.tipo == TipoCambio::Rechazada) {
+                bufer.texto(nombreMotivo(c.motivo));
+            }
+            bufer.caracter('\n');
+        }
+        return;
+    }
+
+    bufer.texto("\n--- Cambios del plan ---\n");
+    bufer.columna("#", ANCHO_NUMERO_CAMBIO);
+    bufer.columna("Cambio", ANCHO_TIPO_CAMBIO);
+    bufer.columna("Antes", ANCHO_BLOQUE_CAMBIO);
+    bufer.columna("Después", ANCHO_BLOQUE_CAMBIO + 1); // La "é" ocupa dos bytes
+    bufer.texto("Hosts\n");
+    bufer.texto(string(ANCHO_NUMERO_CAMBIO + ANCHO_TIPO_CAMBIO + 2 * ANCHO_BLOQUE_CAMBIO + 16, '-'));
+    bufer.caracter('\n');
+    for (const CambioPlan& c : cambios) {
+        const bool hayAnterior = c.cidrAnterior >= 0;
+        char* inicio = bufer.reservar(ANCHO_NUMERO_CAMBIO + 24);
+        char* p = inicio;
+        if (c.numeroResultante > 0) {
+            p = BuferSalida::formatearEntero(p, c.numeroResultante);
+        } else {
+            *p++ = '-';
+        }
+        while (p < inicio + ANCHO_NUMERO_CAMBIO) {
+            *p++ = ' ';
+        }
+        bufer.avanzar(p);
+        bufer.columna(nombreCambio(c.tipo), ANCHO_TIPO_CAMBIO);
+        escribirBloque(bufer, hayAnterior, c.redAnterior, c.cidrAnterior, ANCHO_BLOQUE_CAMBIO);
+        if (c.tipo == TipoCambio::Rechazada) {
+            // Lo pedido, sin dirección
+            char* q = bufer.reservar(ANCHO_BLOQUE_CAMBIO + 24);
+            char* fin = q;
+            *fin++ = '(';
+            *fin++ = '/';
+            fin = BuferSalida::formatearEntero(fin, static_cast<uint64_t>(c.cidrNueva));
+            *fin++ = ')';
+            while (fin < q + ANCHO_BLOQUE_CAMBIO) {
+                *fin++ = ' ';
+            }
+            bufer.avanzar(fin);
+        } else {
+            escribirBloque(bufer, c.tipo != TipoCambio::Eliminada, c.redNueva, c.cidrNueva, ANCHO_BLOQUE_CAMBIO);
+        }
+        if (hayAnterior) {
+            bufer.entero(c.hostsAnteriores);
+        }
+        if (c.tipo != TipoCambio::Eliminada) {
+            if (hayAnterior) {
+                bufer.texto(" -> ");
+            }
+            bufer.entero(c.hostsNuevos);
+        }
+        if (c.tipo == TipoCambio::Rechazada) {
+            bufer.texto(" (");
+            bufer.texto(nombreMotivo(c.motivo));
+            bufer.caracter(')');
+        }
+        bufer.caracter('\n');
+    }
+    bufer.texto("\nSubredes sin cambios: ");
+    bufer.entero(sinCambios);
+    bufer.texto("\n-------------------------------------------\n");
+}
@@ -0,0 +1,131 @@
+#ifndef REPLANIFICACION_H
+#define REPLANIFICACION_H
+
+#include <cstddef> // Para size_t
+#include <cstdint> // Para uint32_t y otros tipos enteros de ancho fijo
+#include <ostream> // Para std::ostream
+#include <string>  // Para std::string
+#include <vector>  // Para std::vector
+
+#include "asignador.h" // Asignador de bloques con rangos reservados
+#include "subredes.h"  // PlanSubredes, Subred y MotivoFallo
+
+/**
+ * @brief Tipo de edición sobre un plan existente.
+ */
+enum class TipoEdicion : uint8_t {
+    Agregar,      // Nueva subred para 'hosts' hosts
+    Eliminar,     // Quitar la subred 'numero'
+    Redimensionar // Cambiar a 'hosts' los hosts de la subred 'numero'
+};
+
+/**
+ * @brief Una edición de un plan. Las subredes se identifican por su número en el plan de partida
+ * (la columna '#' de la tabla, desde 1); las agregadas reciben los números siguientes.
+ */
+struct EdicionPlan {
+    TipoEdicion tipo;
+    size_t numero; // Sin uso en Agregar
+    int hosts;     // Sin uso en Eliminar
+};
+
+/**
+ * @brief Analiza una edición: "+HOSTS" (agregar), "-N" (eliminar la subred N) o "N=HOSTS" (redimensionar).
+ * @param texto La edición.
+ * @param edicion Recibe la edición.
+ * @param error Recibe el mensaje de error.
+ * @return Verdadero si la edición es válida.
+ */
+bool analizarEdicion(const std::string& texto, EdicionPlan& edicion, std::string& error);
+
+/**
+ * @brief Resultado de una edición para una subred.
+ */
+enum class TipoCambio : uint8_t {
+    Agregada,       // Subred nueva
+    Eliminada,      // Subred quitada
+    Redimensionada, // Cambió el número de hosts (o el prefijo) sin cambiar de dirección de red
+    Movida,         // Cambió de dirección de red porque su bloque ya no cabía donde estaba
+    Rechazada       // No había espacio: la subred queda como estaba (o no se agrega)
+};
+
+/**
+ * @brief Cambio de una subred. Los campos "anteriores" no se usan en Agregada y los "nuevos"
+ * no se usan en Eliminada; en Rechazada, los nuevos son los pedidos.
+ */
+struct CambioPlan {
+    TipoCambio tipo;
+    size_t numero;           // Número de la edición (plan de partida; las agregadas, los siguientes)
+    size_t numeroResultante; // Número en el plan resultante; 0 si la subred no está en él
+    uint32_t redAnterior;
+    int cidrAnterior;
+    uint32_t hostsAnteriores;
+    uint32_t redNueva;
+    int cidrNueva;
+    uint32_t hostsNuevos;
+    MotivoFallo motivo; // Solo en Rechazada
+};
+
+/**
+ * @brief Replanificación incremental de un plan de subredes.
+ *
+ * Cargar un plan reconstruye una vez el estado del asignador (O(n log n)). Después, cada
+ * aplicación de ediciones toca solo los bloques afectados, en O(e log n) amortizado para e ediciones: el resto de
+ * las subredes conserva su dirección. Se eliminan primero las subredes quitadas, luego las que se
+ * reducen (conservan su dirección de red) y por último, de mayor a menor, las que crecen y las
+ * nuevas. Una subred que crece conserva su dirección si el bloque alineado que la contiene está
+ * libre; si no, se mueve al bloque libre más ajustado, y si tampoco lo hay, queda como estaba.
+ * Como no se reubica nada más, una edición puede rechazarse por fragmentación aunque un plan
+ * calculado desde cero sí la admitiera.
+ */
+class PlanificadorIncremental {
+public:
+    /**
+     * @brief Toma un plan como punto de partida.
+     * @param plan Plan calculado (resultado Correcto).
+     */
+    void cargar(const PlanSubredes& plan);
+
+    /**
+     * @brief Aplica un conjunto de ediciones.
+     * Las ediciones se validan todas antes de aplicar ninguna (número existente y no eliminado,
+     * hosts válidos, cada subred editada una sola vez).
+     * @param ediciones Las ediciones.
+     * @param cambios Recibe los cambios, ordenados por número de subred (se vacía antes). Como el plan
+     * resultante no deja huecos, cada cambio lleva también el número que la subred tiene en él.
+     * @param error Recibe el mensaje de error si alguna edición es inválida.
+     * @return Verdadero si las ediciones eran válidas (aunque alguna se haya rechazado por falta de espacio).
+     */
+    bool aplicar(const std::vector<EdicionPlan>& ediciones, std::vector<CambioPlan>& cambios, std::string& error);
+
+    /**
+     * @brief Obtiene el plan actual: subredes vigentes por número, espacio libre y fallidas
+     * (las del plan de partida y las subredes nuevas rechazadas). Cuesta O(n).
+     * @param plan Recibe el plan (se reutiliza su memoria).
+     */
+    void obtenerPlan(PlanSubredes& plan) const;
+
+    /** @brief Cantidad de subredes vigentes. */
+    size_t cantidadSubredes() const { return vigentes; }
+
+private:
+    PlanSubredes partida;            // Red base, reservados y fallidas (sin subredes)
+    std::vector<Subred> subredes;    // Indexadas por número - 1, incluidas las eliminadas
+    std::vector<bool> vigente;       // Falso si la subred se eliminó
+    std::vector<size_t> eliminadas;  // Índices de las subredes no vigentes, ordenados
+    std::vector<SolicitudFallida> rechazadas;
+    AsignadorBloques asignador;
+    size_t vigentes = 0;
+};
+
+/**
+ * @brief Imprime un conjunto de cambios como tabla o CSV, con los números del plan resultante
+ * ("-" para las subredes que no están en él).
+ * @param os Flujo de salida.
+ * @param cambios Los cambios.
+ * @param sinCambios Subredes que conservan dirección y tamaño (para el resumen de la tabla).
+ * @param is_csv_output Verdadero para CSV.
+ */
+void imprimirCambios(std::ostream& os, const std::vector<CambioPlan>& cambios, size_t sinCambios, bool is_csv_output);
+
+#endif // REPLANIFICACION_H
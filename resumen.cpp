@@ -0,0 +1,281 @@
+#include "resumen.h"
+
+#include <algorithm> // Para std::merge, std::copy
+#include <cstring>   // Para memchr, memmove
+
+#include "bufer_salida.h"   // Escritura de la salida por bloques
+#include "calculo_subred.h" // Aritmética de subredes con enteros
+#include "direcciones.h"    // parseIPv4, maskIntToCidr y formatearIPv4
+
+using namespace std;
+
+static inline bool esEspacio(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+/**
+ * @brief Interpreta el texto tras '/' o una máscara separada: prefijo decimal (0-32) o máscara dotted decimal.
+ * @return El prefijo, o -1 si no es válido.
+ */
+static int analizarLongitudPrefijo(string_view texto) {
+    if (texto.find('.') != string_view::npos) {
+        uint32_t mascara;
+        return parseIPv4(texto, mascara) == ErrorIPv4::Ninguno ? maskIntToCidr(mascara) : -1;
+    }
+    if (texto.empty() || texto.size() > 2) {
+        return -1;
+    }
+    int cidr = 0;
+    for (char c : texto) {
+        if (c < '0' || c > '9') {
+            return -1;
+        }
+        cidr = cidr * 10 + (c - '0');
+    }
+    return cidr <= 32 ? cidr : -1;
+}
+
+ResultadoLotePrefijos parsePrefijosLote(string_view buffer, vector<RangoIPv4>& salida) {
+    ResultadoLotePrefijos resultado;
+    const char* p = buffer.data();
+    const char* const finBuffer = p + buffer.size();
+    while (p < finBuffer) {
+        const char* finLinea = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(finBuffer - p)));
+        if (!finLinea) {
+            finLinea = finBuffer;
+        }
+        const char* siguienteLinea = finLinea < finBuffer ? finLinea + 1 : finBuffer;
+        const char* comentario = static_cast<const char*>(memchr(p, '#', static_cast<size_t>(finLinea - p)));
+        if (comentario) {
+            finLinea = comentario;
+        }
+
+        // Primer campo: el prefijo; segundo campo opcional: una máscara
+        while (p < finLinea && esEspacio(*p)) {
+            ++p;
+        }
+        if (p == finLinea) {
+            p = siguienteLinea;
+            continue; // Línea vacía o solo comentario
+        }
+        const char* finCampo = p;
+        while (finCampo < finLinea && !esEspacio(*finCampo)) {
+            ++finCampo;
+        }
+        const string_view campo(p, static_cast<size_t>(finCampo - p));
+        const size_t barra = campo.find('/');
+
+        uint32_t ip;
+        int cidr = 32;
+        bool valido = parseIPv4(campo.substr(0, barra), ip) == ErrorIPv4::Ninguno;
+        if (valido && barra != string_view::npos) {
+            cidr = analizarLongitudPrefijo(campo.substr(barra + 1));
+            valido = cidr >= 0;
+        } else if (valido) {
+            const char* q = finCampo;
+            while (q < finLinea && esEspacio(*q)) {
+                ++q;
+            }
+            const char* finMascara = q;
+            while (finMascara < finLinea && !esEspacio(*finMascara)) {
+                ++finMascara;
+            }
+            // Solo se toma como máscara si lo es; si no, es otro dato de la línea
+            uint32_t mascara;
+            if (q < finMascara && parseIPv4(string_view(q, static_cast<size_t>(finMascara - q)), mascara) == ErrorIPv4::Ninguno &&
+                maskIntToCidr(mascara) >= 0) {
+                cidr = maskIntToCidr(mascara);
+            }
+        }
+
+        if (valido) {
+            const uint32_t mascara = mascaraDePrefijo(PrefijoIPv4(cidr));
+            if ((ip & ~mascara) != 0) {
+                ++resultado.conBitsDeHost;
+            }
+            salida.push_back({ip & mascara, ip | ~mascara});
+            ++resultado.validos;
+        } else {
+            ++resultado.invalidos;
+        }
+        p = siguienteLinea;
+    }
+    return resultado;
+}
+
+ResultadoLotePrefijos leerPrefijos(FILE* entrada, PoolTrabajo& pool, vector<RangoIPv4>& rangos) {
+    const size_t TAMANO_BLOQUE = size_t(16) << 20;
+    vector<char> buffer(TAMANO_BLOQUE);
+    size_t pendiente = 0; // Bytes de una línea incompleta al final del bloque anterior
+    vector<vector<RangoIPv4>> porTramo(pool.cantidadHilos());
+    vector<ResultadoLotePrefijos> resultadosTramo(pool.cantidadHilos());
+    ResultadoLotePrefijos total;
+
+    while (true) {
+        size_t leidos = fread(buffer.data() + pendiente, 1, buffer.size() - pendiente, entrada);
+        size_t disponibles = pendiente + leidos;
+        if (disponibles == 0) {
+            break;
+        }
+        // Solo se procesan líneas completas, salvo al final del archivo
+        size_t procesables = disponibles;
+        if (leidos != 0) {
+            while (procesables > 0 && buffer[procesables - 1] != '\n') {
+                --procesables;
+            }
+            if (procesables == 0) {
+                if (disponibles < buffer.size()) {
+                    pendiente = disponibles;
+                    continue;
+                }
+                procesables = disponibles; // Línea más larga que el buffer: se analiza tal cual (será inválida)
+            }
+        }
+
+        // Cada hilo analiza un tramo del bloque que empieza y acaba en un salto de línea
+        const size_t tramos = porTramo.size();
+        vector<size_t> limites(tramos + 1, procesables);
+        limites[0] = 0;
+        for (size_t t = 1; t < tramos; ++t) {
+            size_t corte = max(limites[t - 1], procesables * t / tramos);
+            while (corte < procesables && corte > 0 && buffer[corte - 1] != '\n') {
+                ++corte;
+            }
+            limites[t] = corte;
+        }
+        pool.paraCada(tramos, [&](size_t t, unsigned) {
+            porTramo[t].clear();
+            resultadosTramo[t] = parsePrefijosLote(string_view(buffer.data() + limites[t], limites[t + 1] - limites[t]), porTramo[t]);
+        });
+        for (size_t t = 0; t < tramos; ++t) {
+            rangos.insert(rangos.end(), porTramo[t].begin(), porTramo[t].end());
+            total.validos += resultadosTramo[t].validos;
+            total.invalidos += resultadosTramo[t].invalidos;
+            total.conBitsDeHost += resultadosTramo[t].conBitsDeHost;
+        }
+
+        pendiente = disponibles - procesables;
+        memmove(buffer.data(), buffer.data() + procesables, pendiente);
+        if (leidos == 0) {
+            break;
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Ordena por dirección inicial con un radix sort LSD de 4 pasadas de 8 bits (estable).
+ * Las pasadas en las que todos los rangos tienen el mismo byte se omiten.
+ * @param datos Rangos a ordenar; al terminar quedan ordenados aquí.
+ * @param auxiliar Espacio para n rangos.
+ * @param n Cantidad de rangos.
+ */
+static void ordenarPorInicio(RangoIPv4* datos, RangoIPv4* auxiliar, size_t n) {
+    size_t cuentas[4][256] = {};
+    for (size_t i = 0; i < n; ++i) {
+        const uint32_t clave = datos[i].inicio;
+        ++cuentas[0][clave & 0xFF];
+        ++cuentas[1][(clave >> 8) & 0xFF];
+        ++cuentas[2][(clave >> 16) & 0xFF];
+        ++cuentas[3][clave >> 24];
+    }
+    RangoIPv4* origen = datos;
+    RangoIPv4* destino = auxiliar;
+    for (int pasada = 0; pasada < 4; ++pasada) {
+        const int desplazamiento = pasada * 8;
+        size_t* cuenta = cuentas[pasada];
+        if (cuenta[(origen[0].inicio >> desplazamiento) & 0xFF] == n) {
+            continue; // Todos comparten este byte
+        }
+        size_t posicion = 0;
+        for (int b = 0; b < 256; ++b) {
+            const size_t c = cuenta[b];
+            cuenta[b] = posicion;
+            posicion += c;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            destino[cuenta[(origen[i].inicio >> desplazamiento) & 0xFF]++] = origen[i];
+        }
+        swap(origen, destino);
+    }
+    if (origen != datos) {
+        copy(origen, origen + n, datos);
+    }
+}
+
+void ordenarRangosParalelo(vector<RangoIPv4>& rangos, PoolTrabajo& pool) {
+    const size_t n = rangos.size();
+    if (n < 2) {
+        return;
+    }
+    const size_t MINIMO_POR_TRAMO = 1 << 16; // Por debajo, repartir cuesta más de lo que ahorra
+    size_t tramos = max<size_t>(1, min<size_t>(pool.cantidadHilos(), n / MINIMO_POR_TRAMO));
+    vector<RangoIPv4> auxiliar(n);
+
+    vector<size_t> limites(tramos + 1);
+    for (size_t i = 0; i <= tramos; ++i) {
+        limites[i] = n * i / tramos;
+    }
+    pool.paraCada(tramos, [&](size_t i, unsigned) {
+        ordenarPorInicio(rangos.data() + limites[i], auxiliar.data() + limites[i], limites[i + 1] - limites[i]);
+    });
+
+    // Fusión por parejas de tramos consecutivos, alternando entre los dos vectores
+    auto menor = [](const RangoIPv4& a, const RangoIPv4& b) { return a.inicio < b.inicio; };
+    vector<RangoIPv4>* origen = &rangos;
+    vector<RangoIPv4>* destino = &auxiliar;
+    while (tramos > 1) {
+        const size_t parejas = (tramos + 1) / 2;
+        pool.paraCada(parejas, [&](size_t k, unsigned) {
+            const size_t a = limites[2 * k];
+            const size_t m = limites[min(2 * k + 1, tramos)];
+            const size_t b = limites[min(2 * k + 2, tramos)];
+            merge(origen->begin() + static_cast<ptrdiff_t>(a), origen->begin() + static_cast<ptrdiff_t>(m),
+                  origen->begin() + static_cast<ptrdiff_t>(m), origen->begin() + static_cast<ptrdiff_t>(b),
+                  destino->begin() + static_cast<ptrdiff_t>(a), menor);
+        });
+        vector<size_t> nuevos(parejas + 1);
+        for (size_t k = 0; k <= parejas; ++k) {
+            nuevos[k] = limites[min(2 * k, tramos)];
+        }
+        limites.swap(nuevos);
+        tramos = parejas;
+        swap(origen, destino);
+    }
+    if (origen != &rangos) {
+        rangos.swap(auxiliar);
+    }
+}
+
+void fusionarRangos(vector<RangoIPv4>& rangos) {
+    size_t fusionados = 0;
+    for (const RangoIPv4& r : rangos) {
+        // Se compara en 64 bits para que un rango que acaba en 255.255.255.255 no desborde
+        if (fusionados > 0 && uint64_t(r.inicio) <= uint64_t(rangos[fusionados - 1].fin) + 1) {
+            rangos[fusionados - 1].fin = max(rangos[fusionados - 1].fin, r.fin);
+        } else {
+            rangos[fusionados++] = r;
+        }
+    }
+    rangos.resize(fusionados);
+}
+
+size_t escribirResumen(ostream& os, const vector<RangoIPv4>& rangos) {
+    BuferSalida bufer(os);
+    vector<BloqueIPv4> bloques;
+    size_t escritos = 0;
+    for (const RangoIPv4& r : rangos) {
+        bloques.clear();
+        rangoABloques(r, bloques);
+        for (const BloqueIPv4& b : bloques) {
+            char* inicio = bufer.reservar(20);
+            char* p = formatearIPv4(inicio, b.red);
+            *p++ = '/';
+            p = BuferSalida::formatearEntero(p, static_cast<uint64_t>(b.cidr));
+            *p++ = '\n';
+            bufer.avanzar(p);
+        }
+        escritos += bloques.size();
+    }
+    return escritos;
+}
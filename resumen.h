@@ -0,0 +1,66 @@
+#ifndef RESUMEN_H
+#define RESUMEN_H
+
+#include <cstddef>     // Para size_t
+#include <cstdint>     // Para uint32_t y otros tipos enteros de ancho fijo
+#include <cstdio>      // Para FILE
+#include <ostream>     // Para std::ostream
+#include <string_view> // Para std::string_view
+#include <vector>      // Para std::vector
+
+#include "asignador.h"    // RangoIPv4, BloqueIPv4 y rangoABloques
+#include "pool_trabajo.h" // Pool de hilos con robo de trabajo
+
+/**
+ * @brief Resultado del análisis masivo de prefijos.
+ */
+struct ResultadoLotePrefijos {
+    size_t validos = 0;
+    size_t invalidos = 0;     // Líneas no vacías que no son un prefijo válido
+    size_t conBitsDeHost = 0; // Prefijos válidos cuya dirección no estaba alineada (se tomó su red)
+};
+
+/**
+ * @brief Analiza un bloque de texto con un prefijo por línea y añade cada uno como rango.
+ * Formatos: "IP/CIDR", "IP/MÁSCARA", "IP MÁSCARA" o "IP" (un /32). Lo que sigue al prefijo en la
+ * misma línea (ej. el resto de una tabla de rutas) se ignora, igual que las líneas vacías y el texto
+ * tras '#'. Si la dirección tiene bits de host, se usa la red que la contiene.
+ * @param buffer Texto con líneas completas.
+ * @param salida Vector al que se añaden los rangos (no se vacía).
+ * @return Cantidad de prefijos válidos, inválidos y con bits de host.
+ */
+ResultadoLotePrefijos parsePrefijosLote(std::string_view buffer, std::vector<RangoIPv4>& salida);
+
+/**
+ * @brief Lee todos los prefijos de un archivo por bloques grandes, analizando cada bloque en paralelo
+ * (cada hilo toma un tramo que empieza y acaba en un salto de línea).
+ * @param entrada Archivo abierto para lectura (ej. stdin).
+ * @param pool Pool de hilos.
+ * @param rangos Vector al que se añaden los rangos (no se vacía).
+ * @return Totales de prefijos válidos, inválidos y con bits de host.
+ */
+ResultadoLotePrefijos leerPrefijos(FILE* entrada, PoolTrabajo& pool, std::vector<RangoIPv4>& rangos);
+
+/**
+ * @brief Ordena rangos por su dirección inicial con varios hilos: cada hilo ordena un tramo (radix sort) y los
+ * tramos se fusionan por parejas, también en paralelo.
+ * @param rangos Los rangos.
+ * @param pool Pool de hilos.
+ */
+void ordenarRangosParalelo(std::vector<RangoIPv4>& rangos, PoolTrabajo& pool);
+
+/**
+ * @brief Fusiona, en una sola pasada, los rangos superpuestos o adyacentes de un vector ordenado.
+ * @param rangos Rangos ordenados por inicio; quedan los fusionados, disjuntos y no contiguos.
+ */
+void fusionarRangos(std::vector<RangoIPv4>& rangos);
+
+/**
+ * @brief Escribe el conjunto mínimo de prefijos CIDR que cubre exactamente unos rangos, uno por línea.
+ * @param os Flujo de salida.
+ * @param rangos Rangos fusionados (ver fusionarRangos).
+ * @return Cantidad de prefijos escritos.
+ */
+size_t escribirResumen(std::ostream& os, const std::vector<RangoIPv4>& rangos);
+
+#endif // RESUMEN_H
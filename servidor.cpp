@@ -0,0 +1,359 @@
+#include "servidor.h"
+
+#include <algorithm> // Para std::sort, std::unique
+#include <csignal> // Para sigaction, SIGINT y SIGTERM
+#include <cstdint> // Para uint32_t
+#include <cstring> // Para memchr, memcpy y strerror
+
+#ifdef __linux__
+#include <cerrno>        // Para errno
+#include <netinet/in.h>  // Para sockaddr_in
+#include <netinet/tcp.h> // Para TCP_NODELAY
+#include <sys/epoll.h>   // Para epoll_create1, epoll_ctl, epoll_wait
+#include <sys/socket.h>  // Para socket, bind, listen, accept4, recv, send
+#include <sys/stat.h>    // Para lstat
+#include <sys/un.h>      // Para sockaddr_un
+#include <unistd.h>      // Para close, unlink
+#endif
+
+#include "bufer_salida.h" // BuferSalida::formatearEntero
+
+using namespace std;
+
+void responderCorrecto(string& respuesta, string_view datos) {
+    char longitud[20];
+    respuesta.assign("OK ");
+    respuesta.append(longitud, BuferSalida::formatearEntero(longitud, datos.size()));
+    respuesta += '\n';
+    respuesta.append(datos.data(), datos.size());
+}
+
+void responderError(string& respuesta, string_view mensaje) {
+    respuesta.assign("ERROR ");
+    respuesta.append(mensaje.data(), mensaje.size());
+    respuesta += '\n';
+}
+
+/**
+ * @brief Estado de una conexión: lo recibido sin procesar y lo pendiente de enviar.
+ */
+struct ServidorLineas::Conexion {
+    int descriptor;
+    string entrada;            // Bytes recibidos que aún no forman una línea completa
+    string salida;             // Respuestas pendientes de enviar
+    size_t enviados = 0;       // Bytes de 'salida' ya enviados
+    uint32_t eventos = 0;      // Eventos registrados en epoll
+    bool cerrarAlVaciar = false; // El cliente cerró su extremo (o falló): se cierra al enviar lo pendiente
+};
+
+ServidorLineas::ServidorLineas() = default;
+
+#ifdef __linux__
+
+static volatile sig_atomic_t senalRecibida = 0;
+
+static void alRecibirSenal(int) {
+    senalRecibida = 1;
+}
+
+ServidorLineas::~ServidorLineas() {
+    for (size_t d = 0; d < porDescriptor.size(); ++d) {
+        if (porDescriptor[d]) {
+            close(static_cast<int>(d));
+        }
+    }
+    if (epoll >= 0) {
+        close(epoll);
+    }
+    if (escucha >= 0) {
+        close(escucha);
+        if (!rutaSocket.empty()) {
+            unlink(rutaSocket.c_str());
+        }
+    }
+}
+
+bool ServidorLineas::escuchar(const string& direccion, string& error) {
+    const bool esPuerto = !direccion.empty() && direccion.size() <= 5 &&
+                          direccion.find_first_not_of("0123456789") == string::npos;
+    if (esPuerto) {
+        const unsigned long puerto = stoul(direccion);
+        if (puerto == 0 || puerto > 65535) {
+            error = "Error: Puerto inválido ('" + direccion + "').";
+            return false;
+        }
+        escucha = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (escucha < 0) {
+            error = "Error: No se pudo crear el socket TCP: " + string(strerror(errno)) + ".";
+            return false;
+        }
+        int si = 1;
+        setsockopt(escucha, SOL_SOCKET, SO_REUSEADDR, &si, sizeof(si));
+        sockaddr_in local{};
+        local.sin_family = AF_INET;
+        local.sin_port = htons(static_cast<uint16_t>(puerto));
+        local.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // Solo clientes locales
+        if (bind(escucha, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+            error = "Error: No se pudo escuchar en 127.0.0.1:" + direccion + ": " + string(strerror(errno)) + ".";
+            return false;
+        }
+    } else {
+        sockaddr_un local{};
+        if (direccion.empty() || direccion.size() >= sizeof(local.sun_path)) {
+            error = "Error: Ruta de socket inválida ('" + direccion + "').";
+            return false;
+        }
+        escucha = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (escucha < 0) {
+            error = "Error: No se pudo crear el socket Unix: " + string(strerror(errno)) + ".";
+            return false;
+        }
+        // Un socket que quedó de una ejecución anterior se reemplaza; cualquier otro archivo, no
+        struct stat info;
+        if (lstat(direccion.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+            unlink(direccion.c_str());
+        }
+        local.sun_family = AF_UNIX;
+        memcpy(local.sun_path, direccion.data(), direccion.size());
+        if (bind(escucha, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+            error = "Error: No se pudo escuchar en '" + direccion + "': " + string(strerror(errno)) + ".";
+            return false;
+        }
+        rutaSocket = direccion;
+    }
+    if (listen(escucha, SOMAXCONN) != 0) {
+        error = "Error: No se pudo escuchar en '" + direccion + "': " + string(strerror(errno)) + ".";
+        return false;
+    }
+
+    epoll = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event evento{};
+    evento.events = EPOLLIN;
+    evento.data.fd = escucha;
+    if (epoll < 0 || epoll_ctl(epoll, EPOLL_CTL_ADD, escucha, &evento) != 0) {
+        error = "Error: No se pudo crear el bucle de eventos: " + string(strerror(errno)) + ".";
+        return false;
+    }
+    return true;
+}
+
+void ServidorLineas::aceptar() {
+    while (true) {
+        const int descriptor = accept4(escucha, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (descriptor < 0) {
+            return; // EAGAIN: no quedan conexiones pendientes (otros errores afectan solo a esa conexión)
+        }
+        if (rutaSocket.empty()) {
+            int si = 1;
+            setsockopt(descriptor, IPPROTO_TCP, TCP_NODELAY, &si, sizeof(si));
+        }
+        epoll_event evento{};
+        evento.events = EPOLLIN | EPOLLRDHUP;
+        evento.data.fd = descriptor;
+        if (epoll_ctl(epoll, EPOLL_CTL_ADD, descriptor, &evento) != 0) {
+            close(descriptor);
+            continue;
+        }
+        if (porDescriptor.size() <= static_cast<size_t>(descriptor)) {
+            porDescriptor.resize(static_cast<size_t>(descriptor) + 1);
+        }
+        porDescriptor[static_cast<size_t>(descriptor)].reset(new Conexion{descriptor, {}, {}});
+        porDescriptor[static_cast<size_t>(descriptor)]->eventos = evento.events;
+        ++conexiones;
+    }
+}
+
+/**
+ * @brief Lee lo disponible (hasta tener más de MAXIMO_LINEA bytes sin atender; el resto espera en el
+ * socket a la siguiente vuelta) y añade al lote las líneas completas.
+ * @return Falso si la conexión debe cerrarse ya (error o línea demasiado larga).
+ */
+bool ServidorLineas::leer(Conexion& conexion, vector<PeticionServidor>& lote) {
+    char buffer[1 << 16];
+    while (conexion.entrada.size() <= MAXIMO_LINEA) {
+        const ssize_t leidos = recv(conexion.descriptor, buffer, sizeof(buffer), 0);
+        if (leidos > 0) {
+            conexion.entrada.append(buffer, static_cast<size_t>(leidos));
+            continue;
+        }
+        if (leidos == 0) {
+            conexion.cerrarAlVaciar = true;
+            break;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        if (errno != EINTR) {
+            return false;
+        }
+    }
+
+    size_t inicio = 0;
+    const string& entrada = conexion.entrada;
+    while (inicio < entrada.size()) {
+        const char* salto = static_cast<const char*>(memchr(entrada.data() + inicio, '\n', entrada.size() - inicio));
+        if (!salto) {
+            break;
+        }
+        size_t fin = static_cast<size_t>(salto - entrada.data());
+        const size_t siguiente = fin + 1;
+        if (fin > inicio && entrada[fin - 1] == '\r') {
+            --fin;
+        }
+        PeticionServidor peticion;
+        peticion.linea.assign(entrada, inicio, fin - inicio);
+        peticion.conexion = conexion.descriptor;
+        lote.push_back(move(peticion));
+        inicio = siguiente;
+    }
+    conexion.entrada.erase(0, inicio);
+    return conexion.entrada.size() <= MAXIMO_LINEA;
+}
+
+/**
+ * @brief Envía lo pendiente sin bloquear; si el socket se llena, espera a EPOLLOUT.
+ * @return Falso si la conexión debe cerrarse.
+ */
+bool ServidorLineas::escribir(Conexion& conexion) {
+    while (conexion.enviados < conexion.salida.size()) {
+        const ssize_t enviados = send(conexion.descriptor, conexion.salida.data() + conexion.enviados,
+                                      conexion.salida.size() - conexion.enviados, MSG_NOSIGNAL);
+        if (enviados > 0) {
+            conexion.enviados += static_cast<size_t>(enviados);
+        } else if (enviados < 0 && errno == EINTR) {
+            continue;
+        } else if (enviados < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    const bool pendiente = conexion.enviados < conexion.salida.size();
+    if (!pendiente) {
+        conexion.salida.clear();
+        conexion.enviados = 0;
+    }
+    // Con el socket lleno se espera a EPOLLOUT. No se vigila la lectura si el cliente ya cerró (seguiría
+    // indicando fin de archivo en cada vuelta) ni mientras tenga demasiadas respuestas sin recoger
+    const bool vigilarLectura = !conexion.cerrarAlVaciar && conexion.salida.size() - conexion.enviados <= MAXIMO_SALIDA;
+    const uint32_t eventos = (vigilarLectura ? uint32_t(EPOLLIN | EPOLLRDHUP) : 0u) | (pendiente ? uint32_t(EPOLLOUT) : 0u);
+    if (eventos != conexion.eventos) {
+        epoll_event evento{};
+        evento.events = eventos;
+        evento.data.fd = conexion.descriptor;
+        epoll_ctl(epoll, EPOLL_CTL_MOD, conexion.descriptor, &evento);
+        conexion.eventos = eventos;
+    }
+    return pendiente || !conexion.cerrarAlVaciar;
+}
+
+void ServidorLineas::cerrar(int descriptor) {
+    epoll_ctl(epoll, EPOLL_CTL_DEL, descriptor, nullptr);
+    close(descriptor);
+    porDescriptor[static_cast<size_t>(descriptor)].reset();
+}
+
+bool ServidorLineas::ejecutar(const ManejadorLote& manejador, string& error) {
+    struct sigaction accion {};
+    accion.sa_handler = alRecibirSenal; // Sin SA_RESTART: epoll_wait vuelve con EINTR
+    sigemptyset(&accion.sa_mask);
+    sigaction(SIGINT, &accion, nullptr);
+    sigaction(SIGTERM, &accion, nullptr);
+
+    const int MAXIMO_EVENTOS = 256;
+    epoll_event eventos[MAXIMO_EVENTOS];
+    vector<PeticionServidor> lote;
+    vector<int> porCerrar;
+    vector<int> conRespuestas;
+    while (!senalRecibida) {
+        const int n = epoll_wait(epoll, eventos, MAXIMO_EVENTOS, -1);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error = "Error: Falló el bucle de eventos: " + string(strerror(errno)) + ".";
+            return false;
+        }
+
+        lote.clear();
+        porCerrar.clear();
+        for (int i = 0; i < n; ++i) {
+            const int descriptor = eventos[i].data.fd;
+            if (descriptor == escucha) {
+                aceptar();
+                continue;
+            }
+            Conexion& conexion = *porDescriptor[static_cast<size_t>(descriptor)];
+            bool seguir = true;
+            if (eventos[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                seguir = leer(conexion, lote);
+            }
+            if (seguir && (eventos[i].events & EPOLLOUT)) {
+                seguir = escribir(conexion);
+            }
+            if (!seguir) {
+                porCerrar.push_back(descriptor);
+            }
+        }
+
+        // Las conexiones que fallaron se cierran al final de la vuelta, tras intentar responder lo que ya enviaron
+        for (int descriptor : porCerrar) {
+            porDescriptor[static_cast<size_t>(descriptor)]->cerrarAlVaciar = true;
+        }
+        if (!lote.empty()) {
+            manejador(lote);
+            ++lotes;
+            peticiones += lote.size();
+            // Todas las conexiones con respuestas nuevas pasan por escribir(), que también decide si se sigue leyendo
+            conRespuestas.clear();
+            for (PeticionServidor& peticion : lote) {
+                Conexion& conexion = *porDescriptor[static_cast<size_t>(peticion.conexion)];
+                if (conRespuestas.empty() || conRespuestas.back() != peticion.conexion) {
+                    conRespuestas.push_back(peticion.conexion);
+                }
+                conexion.salida += peticion.respuesta;
+            }
+            sort(conRespuestas.begin(), conRespuestas.end());
+            conRespuestas.erase(unique(conRespuestas.begin(), conRespuestas.end()), conRespuestas.end());
+            for (int descriptor : conRespuestas) {
+                if (!escribir(*porDescriptor[static_cast<size_t>(descriptor)])) {
+                    porCerrar.push_back(descriptor);
+                }
+            }
+        }
+        // Las conexiones cerradas por el cliente se cierran en cuanto no tienen nada pendiente
+        for (int i = 0; i < n; ++i) {
+            const int descriptor = eventos[i].data.fd;
+            if (descriptor != escucha && porDescriptor[static_cast<size_t>(descriptor)]) {
+                Conexion& conexion = *porDescriptor[static_cast<size_t>(descriptor)];
+                if (conexion.cerrarAlVaciar && !escribir(conexion)) {
+                    porCerrar.push_back(descriptor);
+                }
+            }
+        }
+        for (int descriptor : porCerrar) {
+            if (porDescriptor[static_cast<size_t>(descriptor)]) {
+                cerrar(descriptor);
+            }
+        }
+    }
+    return true;
+}
+
+#else
+
+ServidorLineas::~ServidorLineas() = default;
+
+bool ServidorLineas::escuchar(const string& direccion, string& error) {
+    (void)direccion;
+    error = "Error: El modo servidor solo está disponible en Linux.";
+    return false;
+}
+
+bool ServidorLineas::ejecutar(const ManejadorLote& manejador, string& error) {
+    (void)manejador;
+    error = "Error: El modo servidor solo está disponible en Linux.";
+    return false;
+}
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef SERVIDOR_H
+#define SERVIDOR_H
+
+#include <cstddef>     // Para size_t
+#include <functional>  // Para std::function
+#include <memory>      // Para std::unique_ptr
+#include <string>      // Para std::string
+#include <string_view> // Para std::string_view
+#include <vector>      // Para std::vector
+
+/**
+ * @brief Una petición recibida por el servidor: una línea de texto y su respuesta.
+ */
+struct PeticionServidor {
+    std::string linea;     // Sin el salto de línea final
+    std::string respuesta; // Respuesta completa, ya enmarcada (ver responderCorrecto y responderError)
+    int conexion = -1;     // Uso interno del servidor
+};
+
+/**
+ * @brief Enmarca una respuesta correcta: "OK <bytes>\n" seguido de los datos.
+ * El prefijo de longitud permite a los clientes leer datos de varias líneas sin buscar un terminador.
+ * @param respuesta Recibe la respuesta (se sustituye su contenido).
+ * @param datos Los datos.
+ */
+void responderCorrecto(std::string& respuesta, std::string_view datos);
+
+/**
+ * @brief Enmarca una respuesta de error: "ERROR <mensaje>\n" (el mensaje no debe contener saltos de línea).
+ * @param respuesta Recibe la respuesta (se sustituye su contenido).
+ * @param mensaje El mensaje.
+ */
+void responderError(std::string& respuesta, std::string_view mensaje);
+
+/**
+ * @brief Atiende un lote de peticiones: debe rellenar la respuesta de cada una.
+ * Las peticiones de una misma conexión llegan en orden, y sus respuestas se envían en ese orden.
+ */
+using ManejadorLote = std::function<void(std::vector<PeticionServidor>& lote)>;
+
+/**
+ * @brief Servidor de peticiones por líneas sobre un socket Unix o TCP local, con un bucle de eventos (epoll).
+ *
+ * Un solo hilo acepta conexiones, lee y escribe sin bloquear. En cada vuelta del bucle se reúnen en
+ * un lote todas las líneas completas que han llegado de todos los clientes listos, y el manejador
+ * las atiende de una vez (y puede repartirlas entre hilos); después se envían las respuestas. Así,
+ * con muchos clientes concurrentes el coste de despertar hilos se paga por lote y no por petición.
+ * Cada conexión tiene la memoria acotada: de un cliente que envía peticiones sin leer las respuestas
+ * se deja de leer mientras tenga más de MAXIMO_SALIDA bytes por enviar (sus peticiones esperan en el
+ * socket), y de cada conexión se leen como mucho MAXIMO_LINEA bytes por vuelta.
+ * Linux únicamente.
+ */
+class ServidorLineas {
+public:
+    static constexpr size_t MAXIMO_LINEA = size_t(1) << 20;  // Una línea más larga cierra la conexión
+    static constexpr size_t MAXIMO_SALIDA = size_t(1) << 22; // Respuestas sin enviar por encima de las que no se lee
+
+    ServidorLineas();
+    ~ServidorLineas();
+    ServidorLineas(const ServidorLineas&) = delete;
+    ServidorLineas& operator=(const ServidorLineas&) = delete;
+
+    /**
+     * @brief Empieza a escuchar.
+     * @param direccion Ruta del socket Unix, o un número de puerto para TCP en 127.0.0.1.
+     * Si la ruta ya existe y es un socket (ej. de una ejecución anterior), se reemplaza.
+     * @param error Recibe el mensaje de error.
+     * @return Verdadero si el servidor quedó escuchando.
+     */
+    bool escuchar(const std::string& direccion, std::string& error);
+
+    /**
+     * @brief Atiende clientes hasta recibir SIGINT o SIGTERM.
+     * @param manejador Atiende cada lote de peticiones.
+     * @param error Recibe el mensaje de error si el bucle termina por un fallo.
+     * @return Verdadero si terminó por una señal.
+     */
+    bool ejecutar(const ManejadorLote& manejador, std::string& error);
+
+    /** @brief Peticiones atendidas. */
+    size_t peticionesAtendidas() const { return peticiones; }
+    /** @brief Lotes atendidos (una petición o más cada uno). */
+    size_t lotesAtendidos() const { return lotes; }
+    /** @brief Conexiones aceptadas. */
+    size_t conexionesAceptadas() const { return conexiones; }
+
+private:
+    struct Conexion;
+
+    void aceptar();
+    bool leer(Conexion& conexion, std::vector<PeticionServidor>& lote);
+    bool escribir(Conexion& conexion);
+    void cerrar(int descriptor);
+
+    int escucha = -1;
+    int epoll = -1;
+    std::string rutaSocket;                          // Vacía en TCP; se borra al terminar
+    std::vector<std::unique_ptr<Conexion>> porDescriptor; // Conexiones abiertas, indexadas por descriptor
+    size_t peticiones = 0;
+    size_t lotes = 0;
+    size_t conexiones = 0;
+};
+
+#endif // SERVIDOR_H
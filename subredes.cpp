@@ -0,0 +1,466 @@
+#include "subredes.h"
+
+#include <array>     // Para std::array (solicitudes por prefijo)
+#include <cstring>   // Para memcpy
+#include <string_view> // Para std::string_view
+
+#include "bufer_salida.h" // Escritura de la salida por bloques
+#include "calculo_subred.h" // Aritmética de subredes con enteros
+#include "direcciones.h" // Análisis y formato de direcciones IPv4 y máscaras
+
+using namespace std;
+
+int hostsToCidr(int num_hosts) {
+    if (num_hosts < 0) return -1; // Número de hosts negativo no válido
+
+    // 32 - ceil(log2(hosts + 2)) con enteros; /32 para 0 hosts y /0 si ni un /0 alcanza
+    return prefijoParaHosts(static_cast<uint64_t>(num_hosts)).bits;
+}
+
+int prefijoBaseMinimo(const vector<int>& requestedHostCounts, uint64_t& direccionesNecesarias) {
+    const uint64_t ESPACIO_IPV4 = uint64_t(1) << 32;
+    array<uint64_t, 33> solicitudesPorPrefijo = {};
+    for (int hosts : requestedHostCounts) {
+        const int cidr = hostsToCidr(hosts);
+        if (cidr < 0) {
+            direccionesNecesarias = 0;
+            return -1;
+        }
+        ++solicitudesPorPrefijo[cidr];
+    }
+
+    direccionesNecesarias = 0;
+    for (int cidr = 0; cidr <= 32; ++cidr) {
+        const int bits = 32 - cidr;
+        // Se compara antes de sumar para no desbordar ni con millones de /0
+        if (solicitudesPorPrefijo[cidr] > ((ESPACIO_IPV4 - direccionesNecesarias) >> bits)) {
+            direccionesNecesarias = ESPACIO_IPV4 + 1;
+            return -1;
+        }
+        direccionesNecesarias += solicitudesPorPrefijo[cidr] << bits;
+    }
+    if (direccionesNecesarias <= 1) {
+        return 32; // Sin solicitudes o una sola dirección: basta un /32
+    }
+    // 32 - ceil(log2(direccionesNecesarias))
+    return 32 - (64 - __builtin_clzll(direccionesNecesarias - 1));
+}
+
+
+// Ancho de cada columna de la tabla de consola, en bytes (como std::setw)
+static const int COL_WIDTH_NUM = 5;
+static const int COL_WIDTH_NETWORK = 18;
+static const int COL_WIDTH_CIDR = 8;
+static const int COL_WIDTH_MASK_DEC = 18;
+static const int COL_WIDTH_MASK_BIN = 37;
+static const int COL_WIDTH_RANGE_START = 18;
+static const int COL_WIDTH_RANGE_END = 18;
+static const int COL_WIDTH_BROADCAST = 18;
+static const int COL_WIDTH_HOSTS = 10;
+static const int COL_WIDTH_REQ_HOSTS = 12;
+
+// Espacio reservado para una fila formateada (una fila de la tabla ocupa 163 bytes, algo más con números de fila de más de 5 cifras)
+static const size_t LONGITUD_FILA_MAXIMA = 256;
+
+static const char ENCABEZADO_CSV[] =
+    "Numero,Red,CIDR,MascaraDecimal,MascaraBinaria,RangoInicio,RangoFin,Broadcast,HostsDisponibles,HostsSolicitados\n";
+
+/**
+ * @brief Encabezado de la tabla de consola y su línea de guiones (se construye una sola vez).
+ */
+static const string& encabezadoTabla() {
+    static const string encabezado = [] {
+        string texto;
+        auto columna = [&texto](const char* titulo, int ancho) {
+            texto += titulo;
+            const size_t longitud = char_traits<char>::length(titulo);
+            if (longitud < static_cast<size_t>(ancho)) {
+                texto.append(static_cast<size_t>(ancho) - longitud, ' ');
+            }
+        };
+        columna("#", COL_WIDTH_NUM);
+        columna("Red", COL_WIDTH_NETWORK);
+        columna("CIDR", COL_WIDTH_CIDR);
+        columna("Máscara (Dec)", COL_WIDTH_MASK_DEC);
+        columna("Máscara (Bin)", COL_WIDTH_MASK_BIN);
+        columna("Rango Inicio", COL_WIDTH_RANGE_START);
+        columna("Rango Fin", COL_WIDTH_RANGE_END);
+        columna("Broadcast", COL_WIDTH_BROADCAST);
+        columna("Hosts Disp.", COL_WIDTH_HOSTS);
+        columna("Hosts Sol.", COL_WIDTH_REQ_HOSTS);
+        texto += '\n';
+        texto.append(COL_WIDTH_NUM + COL_WIDTH_NETWORK + COL_WIDTH_CIDR + COL_WIDTH_MASK_DEC + COL_WIDTH_MASK_BIN +
+                     COL_WIDTH_RANGE_START + COL_WIDTH_RANGE_END + COL_WIDTH_BROADCAST + COL_WIDTH_HOSTS + COL_WIDTH_REQ_HOSTS, '-');
+        texto += '\n';
+        return texto;
+    }();
+    return encabezado;
+}
+
+/**
+ * @brief Completa con espacios una columna que empieza en 'inicio' hasta 'ancho' bytes.
+ * @return El final de la columna (no se trunca si el campo ya es más largo).
+ */
+static inline char* rellenarColumna(char* inicio, char* fin, int ancho) {
+    while (fin < inicio + ancho) {
+        *fin++ = ' ';
+    }
+    return fin;
+}
+
+/**
+ * @brief Formatea una fila de la tabla de consola, byte a byte igual que con std::left y std::setw.
+ * @param destino Buffer con espacio para LONGITUD_FILA_MAXIMA bytes.
+ * @param subnet La subred a formatear.
+ * @param counter El número de la subred.
+ * @return Puntero al carácter siguiente al último escrito (la fila termina en '\n').
+ */
+static char* formatearFilaTabla(char* destino, const Subred& subnet, int counter) {
+    const bool conHosts = subnet.hostsUtilizables() > 0;
+    char* p = destino;
+    char* inicio = p;
+    p = rellenarColumna(inicio, BuferSalida::formatearEntero(p, static_cast<uint32_t>(counter)), COL_WIDTH_NUM);
+    inicio = p;
+    p = rellenarColumna(inicio, formatearIPv4(p, subnet.red), COL_WIDTH_NETWORK);
+    inicio = p;
+    *p++ = '/';
+    p = rellenarColumna(inicio, BuferSalida::formatearEntero(p, subnet.cidr), COL_WIDTH_CIDR);
+    inicio = p;
+    p = rellenarColumna(inicio, formatearIPv4(p, subnet.mascara()), COL_WIDTH_MASK_DEC);
+    inicio = p;
+    p = rellenarColumna(inicio, formatearBinario(p, subnet.mascara()), COL_WIDTH_MASK_BIN);
+    for (uint32_t ip : {subnet.primerHost(), subnet.ultimoHost()}) {
+        inicio = p;
+        if (conHosts) {
+            p = formatearIPv4(p, ip);
+        } else {
+            memcpy(p, "N/A", 3);
+            p += 3;
+        }
+        p = rellenarColumna(inicio, p, COL_WIDTH_RANGE_START);
+    }
+    inicio = p;
+    p = rellenarColumna(inicio, formatearIPv4(p, subnet.broadcast()), COL_WIDTH_BROADCAST);
+    inicio = p;
+    p = rellenarColumna(inicio, BuferSalida::formatearEntero(p, subnet.hostsUtilizables()), COL_WIDTH_HOSTS);
+    inicio = p;
+    p = rellenarColumna(inicio, BuferSalida::formatearEntero(p, subnet.hostsSolicitados), COL_WIDTH_REQ_HOSTS);
+    *p++ = '\n';
+    return p;
+}
+
+/**
+ * @brief Formatea una fila CSV.
+ * @param destino Buffer con espacio para LONGITUD_FILA_MAXIMA bytes.
+ * @param subnet La subred a formatear.
+ * @param counter El número de la subred.
+ * @return Puntero al carácter siguiente al último escrito (la fila termina en '\n').
+ */
+static char* formatearFilaCSV(char* destino, const Subred& subnet, int counter) {
+    const bool conHosts = subnet.hostsUtilizables() > 0;
+    char* p = BuferSalida::formatearEntero(destino, static_cast<uint32_t>(counter));
+    *p++ = ',';
+    p = formatearIPv4(p, subnet.red);
+    *p++ = ',';
+    *p++ = '/';
+    p = BuferSalida::formatearEntero(p, subnet.cidr);
+    *p++ = ',';
+    p = formatearIPv4(p, subnet.mascara());
+    *p++ = ',';
+    p = formatearBinario(p, subnet.mascara());
+    for (uint32_t ip : {subnet.primerHost(), subnet.ultimoHost()}) {
+        *p++ = ',';
+        if (conHosts) {
+            p = formatearIPv4(p, ip);
+        } else {
+            memcpy(p, "N/A", 3);
+            p += 3;
+        }
+    }
+    *p++ = ',';
+    p = formatearIPv4(p, subnet.broadcast());
+    *p++ = ',';
+    p = BuferSalida::formatearEntero(p, subnet.hostsUtilizables());
+    *p++ = ',';
+    p = BuferSalida::formatearEntero(p, subnet.hostsSolicitados);
+    *p++ = '\n';
+    return p;
+}
+
+void printSubnetHeader(ostream& os, bool is_csv) {
+    os << (is_csv ? string_view(ENCABEZADO_CSV) : string_view(encabezadoTabla()));
+}
+
+void printSubnetRow(ostream& os, const Subred& subnet, bool is_csv, int counter) {
+    char fila[LONGITUD_FILA_MAXIMA];
+    char* fin = is_csv ? formatearFilaCSV(fila, subnet, counter) : formatearFilaTabla(fila, subnet, counter);
+    os.write(fila, fin - fila);
+}
+
+void planificarSubredes(PlanSubredes& plan, const string& ipBaseStr, int cidrBase, const vector<int>& requestedHostCounts,
+                        const vector<RangoIPv4>& reservados) {
+    uint32_t ipNumericaBase;
+    {
+        MEDIR_FASE(Analisis);
+        ipNumericaBase = ipToInt(ipBaseStr);
+    }
+    uint32_t mascaraBaseNumerica = mascaraDePrefijo(PrefijoIPv4(cidrBase));
+
+    plan.ipBaseStr = ipBaseStr;
+    plan.cidrBase = cidrBase;
+    plan.redBase = ipNumericaBase & mascaraBaseNumerica;
+    plan.broadcastBase = plan.redBase | (~mascaraBaseNumerica);
+    plan.resultado = ResultadoPlan::Correcto;
+    plan.reservados = reservados;
+    plan.subredes.clear();
+    plan.fallidas.clear();
+    plan.espacioLibre.clear();
+    plan.direccionesLibres = 0;
+
+    CONTAR(Planes, 1);
+    if (plan.redBase != ipNumericaBase) {
+        plan.resultado = ResultadoPlan::RedInvalida;
+        return;
+    }
+
+    {
+        MEDIR_FASE(Prefijos);
+        for (int hosts : requestedHostCounts) {
+            int cidr = hostsToCidr(hosts);
+            if (cidr != -1) { // -1 indica un número de hosts inválido
+                plan.subredes.push_back({0, static_cast<uint32_t>(hosts), static_cast<uint8_t>(cidr), {}});
+            } else {
+                plan.fallidas.push_back({hosts, -1, MotivoFallo::HostsInvalidos, -1, 0});
+            }
+        }
+    }
+
+    AsignadorBloques asignador;
+    {
+        MEDIR_FASE(Asignacion);
+        asignador.inicializar(plan.redBase, cidrBase, reservados);
+    }
+    asignarSolicitudes(asignador, cidrBase, plan.subredes, [&](const Subred& subnet, MotivoFallo motivo) {
+        plan.fallidas.push_back({static_cast<int>(subnet.hostsSolicitados), subnet.cidr, motivo,
+                                 asignador.mayorBloqueLibre(), asignador.direccionesLibres()});
+    });
+
+    {
+        MEDIR_FASE(Asignacion);
+        asignador.rangosLibres(plan.espacioLibre);
+    }
+    plan.direccionesLibres = asignador.direccionesLibres();
+    CONTAR(Subredes, plan.subredes.size());
+    CONTAR(Fallidas, plan.fallidas.size());
+}
+
+string describirFallo(const SolicitudFallida& fallida, int cidrBase) {
+    string descripcion = "Subred para " + to_string(fallida.hostsSolicitados) + " hosts";
+    if (fallida.cidr >= 0) {
+        descripcion += " (/" + to_string(fallida.cidr) + ")";
+    }
+    descripcion += ": ";
+    switch (fallida.motivo) {
+        case MotivoFallo::HostsInvalidos:
+            descripcion += "el número de hosts es inválido.";
+            break;
+        case MotivoFallo::MayorQueRedBase:
+            descripcion += "es más grande que la red base (/" + to_string(cidrBase) + ").";
+            break;
+        case MotivoFallo::SinEspacio:
+            descripcion += "sin espacio suficiente (IPs libres: " + to_string(fallida.direccionesLibres) + ").";
+            break;
+        case MotivoFallo::Fragmentacion:
+            descripcion += "el espacio libre está fragmentado (IPs libres: " + to_string(fallida.direccionesLibres) +
+                           ", mayor bloque libre: /" + to_string(fallida.mayorBloqueLibre) + ").";
+            break;
+    }
+    return descripcion;
+}
+
+string describirErrorPlan(const PlanSubredes& plan) {
+    if (plan.resultado == ResultadoPlan::RedInvalida) {
+        return "Error: La dirección IP de entrada '" + plan.ipBaseStr + "' no es una dirección de red válida para la máscara /" +
+               to_string(plan.cidrBase) + ". La dirección de red correcta para esta IP y máscara sería: " + intToIp(plan.redBase);
+    }
+    return string();
+}
+
+void informarProblemasPlan(ostream& os, const PlanSubredes& plan, const string& contexto) {
+    if (plan.resultado != ResultadoPlan::Correcto) {
+        os << contexto << ": " << describirErrorPlan(plan) << '\n';
+        return;
+    }
+    for (const SolicitudFallida& fallida : plan.fallidas) {
+        os << contexto << ": Solicitud no asignada: " << describirFallo(fallida, plan.cidrBase) << '\n';
+    }
+}
+
+void imprimirEncabezadoLoteCSV(ostream& os) {
+    os << "Trabajo," << ENCABEZADO_CSV;
+}
+
+void ImpresorPlan::agregarDestino(ostream& os, FormatoSalida formato, bool encabezadoEscrito) {
+    destinos.push_back({BuferSalida(os), formato, encabezadoEscrito});
+}
+
+void ImpresorPlan::imprimir(const PlanSubredes& plan) {
+    imprimirEnDestinos(plan, 0, string());
+}
+
+void ImpresorPlan::imprimirTrabajo(const PlanSubredes& plan, long long trabajo, const string& titulo) {
+    imprimirEnDestinos(plan, trabajo, titulo);
+}
+
+void ImpresorPlan::imprimirEnDestinos(const PlanSubredes& plan, long long trabajo, const string& titulo) {
+    generarEnDestinos(plan, trabajo, titulo);
+    // Todo el plan se entrega al flujo de una vez, al terminar
+    for (Destino& destino : destinos) {
+        destino.bufer.vaciar();
+    }
+}
+
+void ImpresorPlan::generarEnDestinos(const PlanSubredes& plan, long long trabajo, const string& titulo) {
+    MEDIR_FASE(Formato);
+    const bool enLote = trabajo > 0;
+    const bool planCorrecto = plan.resultado == ResultadoPlan::Correcto;
+
+    // Encabezados: resumen de la red base, advertencias y errores, y encabezado de la tabla
+    for (Destino& destino : destinos) {
+        BuferSalida& os = destino.bufer;
+        const bool is_csv_output = destino.formato == FormatoSalida::CSV;
+
+        if (enLote && is_csv_output) {
+            // En lote, el CSV es una única tabla con una columna de trabajo; los errores van a las tablas
+            if (!destino.encabezadoEscrito) {
+                os.texto("Trabajo,");
+                os.texto(ENCABEZADO_CSV);
+                destino.encabezadoEscrito = true;
+            }
+            continue;
+        }
+        if (enLote) {
+            os.texto("\n=== ");
+            os.texto(titulo);
+            os.texto(" ===\n");
+        }
+
+        if (plan.resultado == ResultadoPlan::RedInvalida) {
+            os.texto("Error: La dirección IP de entrada '");
+            os.texto(plan.ipBaseStr);
+            os.texto("' no es una dirección de red válida para la máscara /");
+            os.enteroConSigno(plan.cidrBase);
+            os.texto(".\nLa dirección de red correcta para esta IP y máscara sería: ");
+            os.ipv4(plan.redBase);
+            os.caracter('\n');
+            continue;
+        }
+
+        if (!is_csv_output) { // Solo imprime esta información en consola, no en CSV
+            os.texto("\n--- Resultados de Subneteo ---\nRed Original: ");
+            os.ipv4(plan.redBase);
+            os.caracter('/');
+            os.enteroConSigno(plan.cidrBase);
+            os.texto(" (Broadcast: ");
+            os.ipv4(plan.broadcastBase);
+            os.texto(", IPs Totales: ");
+            os.entero(plan.totalIps());
+            os.texto(")\n");
+            if (!plan.reservados.empty()) {
+                os.texto("Rangos reservados:");
+                for (const RangoIPv4& r : plan.reservados) {
+                    os.caracter(' ');
+                    os.ipv4(r.inicio);
+                    os.texto(" - ");
+                    os.ipv4(r.fin);
+                    os.caracter(';');
+                }
+                os.caracter('\n');
+            }
+            os.caracter('\n');
+        }
+
+        os.texto(is_csv_output ? string_view(ENCABEZADO_CSV) : string_view(encabezadoTabla()));
+    }
+
+    if (!planCorrecto) {
+        return;
+    }
+
+    // Filas: cada subred se formatea una sola vez por formato y se copia en todos los destinos
+    bool hayTabla = false;
+    bool hayCSV = false;
+    for (const Destino& destino : destinos) {
+        (destino.formato == FormatoSalida::CSV ? hayCSV : hayTabla) = true;
+    }
+    char filaTabla[LONGITUD_FILA_MAXIMA];
+    char filaCSV[LONGITUD_FILA_MAXIMA];
+    size_t longitudTabla = 0;
+    size_t longitudCSV = 0;
+    int subnetCounter = 0;
+    for (const Subred& subnet : plan.subredes) {
+        subnetCounter++;
+        if (hayTabla) {
+            longitudTabla = static_cast<size_t>(formatearFilaTabla(filaTabla, subnet, subnetCounter) - filaTabla);
+        }
+        if (hayCSV) {
+            longitudCSV = static_cast<size_t>(formatearFilaCSV(filaCSV, subnet, subnetCounter) - filaCSV);
+        }
+        for (Destino& destino : destinos) {
+            BuferSalida& os = destino.bufer;
+            if (destino.formato == FormatoSalida::CSV) {
+                if (enLote) {
+                    os.enteroConSigno(trabajo);
+                    os.caracter(',');
+                }
+                os.texto(string_view(filaCSV, longitudCSV));
+            } else {
+                os.texto(string_view(filaTabla, longitudTabla));
+            }
+        }
+    }
+
+    // Cierre: solicitudes fallidas y espacio remanente (solo en consola)
+    for (Destino& destino : destinos) {
+        if (destino.formato == FormatoSalida::CSV) {
+            continue;
+        }
+        BuferSalida& os = destino.bufer;
+        if (!plan.fallidas.empty()) {
+            os.texto("\nSolicitudes no asignadas:\n");
+            for (const SolicitudFallida& fallida : plan.fallidas) {
+                os.texto("  - ");
+                os.texto(describirFallo(fallida, plan.cidrBase));
+                os.caracter('\n');
+            }
+        }
+        os.caracter('\n');
+        if (!plan.espacioLibre.empty()) {
+            for (const RangoIPv4& libre : plan.espacioLibre) {
+                os.texto("Espacio remanente sin utilizar: ");
+                os.ipv4(libre.inicio);
+                os.texto(" - ");
+                os.ipv4(libre.fin);
+                os.caracter('\n');
+            }
+            os.texto("Total de IPs remanentes: ");
+            os.entero(plan.direccionesLibres);
+            os.caracter('\n');
+        } else {
+            os.texto("Toda la red ha sido utilizada o las solicitudes excedieron su capacidad.\n");
+        }
+        os.texto("-------------------------------------------\n");
+    }
+}
+
+void imprimirPlan(ostream& os, const PlanSubredes& plan, bool is_csv_output) {
+    ImpresorPlan impresor;
+    impresor.agregarDestino(os, is_csv_output ? FormatoSalida::CSV : FormatoSalida::Tabla);
+    impresor.imprimir(plan);
+}
+
+void calcularSubredes(ostream& os, const string& ipBaseStr, int cidrBase, const vector<int>& requestedHostCounts, bool is_csv_output) {
+    PlanSubredes plan;
+    planificarSubredes(plan, ipBaseStr, cidrBase, requestedHostCounts);
+    imprimirPlan(os, plan, is_csv_output);
+}
@@ -0,0 +1,329 @@
+#ifndef SUBREDES_H
+#define SUBREDES_H
+
+#include <array>    // Para std::array (grupos por prefijo)
+#include <cstdint>  // Para uint32_t y otros tipos enteros de ancho fijo
+#include <ostream>  // Para std::ostream
+#include <string>   // Para std::string
+#include <vector>   // Para std::vector
+
+#include "asignador.h" // Asignador de bloques con rangos reservados
+#include "bufer_salida.h" // Escritura de la salida por bloques
+#include "calculo_subred.h" // Aritmética de subredes con enteros
+#include "instrumentacion.h" // Mediciones por fase (--stats)
+
+/**
+ * @brief Una subred del plan, en forma puramente numérica (12 bytes).
+ * Máscara, broadcast y rango de hosts se calculan a partir de la red y el prefijo cuando se necesitan;
+ * el texto solo se genera al imprimir.
+ */
+struct Subred {
+    uint32_t red;              // Dirección de red asignada
+    uint32_t hostsSolicitados; // Número de hosts solicitado originalmente
+    uint8_t cidr;              // Prefijo CIDR (0-32)
+    uint8_t relleno[3];        // Siempre a cero (la exportación binaria copia el registro tal cual)
+
+    /** @brief Máscara de subred como entero de 32 bits. */
+    uint32_t mascara() const { return mascaraDePrefijo(PrefijoIPv4(cidr)); }
+    /** @brief Cantidad de direcciones del bloque (0 representa 2^32, el bloque /0). */
+    uint32_t tamano() const { return ~mascara() + 1; }
+    /** @brief Dirección de broadcast. */
+    uint32_t broadcast() const { return red | ~mascara(); }
+    /** @brief Cantidad de hosts utilizables (sin red ni broadcast). */
+    uint32_t hostsUtilizables() const { return (cidr < 31) ? tamano() - 2 : 0; }
+    /** @brief Primera dirección de host utilizable (solo válida si hostsUtilizables() > 0). */
+    uint32_t primerHost() const { return red + 1; }
+    /** @brief Última dirección de host utilizable (solo válida si hostsUtilizables() > 0). */
+    uint32_t ultimoHost() const { return broadcast() - 1; }
+};
+
+static_assert(sizeof(Subred) == 12, "Subred debe ocupar 12 bytes");
+
+/**
+ * @brief Resultado global de la planificación.
+ */
+enum class ResultadoPlan : uint8_t {
+    Correcto,   // Se procesaron todas las solicitudes (algunas pueden haber fallado, ver 'fallidas')
+    RedInvalida // La IP base no es la dirección de red de su máscara
+};
+
+/**
+ * @brief Motivo por el que una solicitud no pudo asignarse.
+ */
+enum class MotivoFallo : uint8_t {
+    HostsInvalidos,  // Número de hosts negativo
+    MayorQueRedBase, // El bloque necesario es más grande que la red base
+    SinEspacio,      // Quedan menos direcciones libres que las necesarias
+    Fragmentacion    // Hay direcciones libres suficientes, pero ningún bloque alineado del tamaño pedido
+};
+
+/**
+ * @brief Núcleo de la planificación, común a IPv4 e IPv6.
+ * Agrupa las solicitudes por prefijo con un ordenamiento por conteo (solo hay BITS + 1 prefijos
+ * posibles, así que cuesta O(n) y conserva el orden de entrada dentro de cada prefijo) y las asigna
+ * de mayor a menor bloque. Cada grupo se reparte en tramos consecutivos con
+ * AsignadorBloquesGenerico::asignarConsecutivos, sin dividir bloques por cada solicitud.
+ * Las asignadas quedan compactadas al inicio del vector; las demás se notifican a 'alFallar'
+ * (con el estado del asignador en ese momento) y se eliminan.
+ * @param asignador Asignador ya inicializado con la red base.
+ * @param cidrBase Prefijo de la red base.
+ * @param subredes Solicitudes: registros con los miembros 'red' (se rellena) y 'cidr' (0 a BITS).
+ * @param alFallar Función llamada como alFallar(const Registro&, MotivoFallo).
+ */
+template <typename Direccion, typename Registro, typename AlFallar>
+void asignarSolicitudes(AsignadorBloquesGenerico<Direccion>& asignador, int cidrBase, std::vector<Registro>& subredes,
+                        AlFallar&& alFallar) {
+    using Asignador = AsignadorBloquesGenerico<Direccion>;
+    using Cantidad = typename Asignador::Cantidad;
+    constexpr int BITS = Asignador::BITS;
+
+    // Ordenamiento por conteo: inicioGrupo[c] es la posición del primer registro con prefijo c
+    std::array<size_t, BITS + 2> inicioGrupo = {};
+    std::vector<Registro> ordenadas(subredes.size());
+    {
+        MEDIR_FASE(Ordenacion);
+        for (const Registro& solicitud : subredes) {
+            ++inicioGrupo[static_cast<size_t>(solicitud.cidr) + 1];
+        }
+        for (int c = 0; c <= BITS; ++c) {
+            inicioGrupo[c + 1] += inicioGrupo[c];
+        }
+        std::array<size_t, BITS + 2> siguiente = inicioGrupo;
+        for (const Registro& solicitud : subredes) {
+            ordenadas[siguiente[static_cast<size_t>(solicitud.cidr)]++] = solicitud;
+        }
+    }
+
+    MEDIR_FASE(Asignacion);
+    // Un CIDR más pequeño significa una subred más grande: las más grandes se asignan primero
+    size_t asignadas = 0;
+    for (int cidr = 0; cidr <= BITS; ++cidr) {
+        size_t i = inicioGrupo[cidr];
+        const size_t fin = inicioGrupo[cidr + 1];
+        if (i == fin) {
+            continue;
+        }
+        if (cidr < cidrBase) {
+            for (; i < fin; ++i) {
+                alFallar(ordenadas[i], MotivoFallo::MayorQueRedBase);
+            }
+            continue;
+        }
+        const Direccion bitsHost = cidr >= BITS ? Direccion(0) : static_cast<Direccion>(~Direccion(0) >> cidr);
+        const Direccion tamano = static_cast<Direccion>(bitsHost + 1); // 0 para un /0 (un único bloque)
+        while (i < fin) {
+            Direccion red;
+            const size_t tomados = asignador.asignarConsecutivos(cidr, fin - i, red);
+            CONTAR(Asignaciones, 1);
+            if (tomados == 0) {
+                break;
+            }
+            for (size_t k = 0; k < tomados; ++k, ++i, red += tamano) {
+                Registro& subnet = ordenadas[asignadas++] = ordenadas[i];
+                subnet.red = red;
+            }
+        }
+        // Sin bloque libre para el primero, tampoco lo hay para los demás del grupo
+        // 'necesarias' es 0 solo para el /0 de IPv6 (2^128), que no cabe si ya hay algo asignado
+        const Cantidad necesarias = static_cast<Cantidad>(static_cast<Cantidad>(bitsHost) + 1);
+        for (; i < fin; ++i) {
+            alFallar(ordenadas[i], necesarias == 0 || asignador.direccionesLibres() < necesarias ? MotivoFallo::SinEspacio
+                                                                                                  : MotivoFallo::Fragmentacion);
+        }
+    }
+    ordenadas.resize(asignadas);
+    subredes.swap(ordenadas);
+}
+
+/**
+ * @brief Una solicitud que no pudo asignarse, con el estado del espacio libre en el momento del fallo.
+ */
+struct SolicitudFallida {
+    int hostsSolicitados;
+    int cidr;                   // Prefijo necesario (-1 si el número de hosts es inválido)
+    MotivoFallo motivo;
+    int mayorBloqueLibre;       // Prefijo del mayor bloque libre en ese momento (-1 si no había)
+    uint64_t direccionesLibres; // Direcciones libres en ese momento
+};
+
+/**
+ * @brief Plan de subneteo de una red base: la lista de subredes en orden de asignación
+ * y los datos necesarios para informar del resultado.
+ */
+struct PlanSubredes {
+    std::string ipBaseStr;                  // IP base tal como se recibió (para los mensajes)
+    int cidrBase = 0;
+    uint32_t redBase = 0;                   // Dirección de red base
+    uint32_t broadcastBase = 0;             // Broadcast de la red base
+    ResultadoPlan resultado = ResultadoPlan::Correcto;
+    std::vector<RangoIPv4> reservados;      // Rangos que ya estaban ocupados al planificar
+    std::vector<Subred> subredes;           // Subredes en orden de asignación (de mayor a menor)
+    std::vector<SolicitudFallida> fallidas; // Solicitudes que no pudieron asignarse
+    std::vector<RangoIPv4> espacioLibre;    // Espacio libre tras el plan, en rangos contiguos
+    uint64_t direccionesLibres = 0;         // Total de direcciones libres tras el plan
+
+    /** @brief Cantidad total de direcciones de la red base (en 64 bits: un /0 tiene 2^32). */
+    uint64_t totalIps() const { return uint64_t(broadcastBase) - redBase + 1; }
+};
+
+/**
+ * @brief Calcula el prefijo CIDR más pequeño que puede contener un número dado de hosts.
+ * @param num_hosts El número de hosts deseado.
+ * @return El prefijo CIDR correspondiente. Retorna -1 si no es posible (ej. num_hosts muy grande).
+ */
+int hostsToCidr(int num_hosts);
+
+/**
+ * @brief Calcula la red base más pequeña (el prefijo más largo) en la que caben todas las subredes pedidas.
+ * Los bloques son potencias de dos y se asignan de mayor a menor, así que en una base vacía caben sin
+ * fragmentarse si y solo si la suma de sus tamaños no la supera: basta contar las solicitudes por
+ * prefijo, sin asignar nada. La suma se lleva en 64 bits, por lo que un /0 o un /1 no la desbordan.
+ * @param requestedHostCounts Números de hosts de cada subred (no negativos).
+ * @param direccionesNecesarias Recibe la suma de los tamaños de bloque (saturada en 2^32 + 1 si no cabe).
+ * @return El prefijo de la red base, o -1 si una solicitud es inválida o ni un /0 alcanza.
+ */
+int prefijoBaseMinimo(const std::vector<int>& requestedHostCounts, uint64_t& direccionesNecesarias);
+
+/**
+ * @brief Calcula el plan de subredes de una red base, sin generar texto.
+ * Asigna subredes de mayor tamaño a menor tamaño para optimizar el espacio. Cada subred ocupa el
+ * bloque libre alineado más ajustado (ver AsignadorBloques), de modo que se aprovechan los huecos
+ * que dejan los rangos reservados. Las solicitudes que no caben se registran en 'plan.fallidas'.
+ * Reutiliza la memoria de 'plan', por lo que conviene pasar el mismo objeto al planificar muchas redes.
+ * @param plan Recibe el plan calculado.
+ * @param ipBaseStr La dirección IP base de la red (ya validada).
+ * @param cidrBase El prefijo CIDR de la red base.
+ * @param requestedHostCounts Un vector de números de hosts solicitados para las nuevas subredes.
+ * @param reservados Rangos ya ocupados dentro de la red base (opcional).
+ */
+void planificarSubredes(PlanSubredes& plan, const std::string& ipBaseStr, int cidrBase,
+                        const std::vector<int>& requestedHostCounts,
+                        const std::vector<RangoIPv4>& reservados = {});
+
+/**
+ * @brief Describe el motivo de fallo de una solicitud.
+ * @param fallida La solicitud fallida.
+ * @param cidrBase El prefijo de la red base (para el mensaje de bloque demasiado grande).
+ * @return Descripción legible.
+ */
+std::string describirFallo(const SolicitudFallida& fallida, int cidrBase);
+
+/**
+ * @brief Describe en una línea por qué un plan no es correcto (resultado distinto de Correcto).
+ * @param plan El plan.
+ * @return Mensaje de error ("Error: ...").
+ */
+std::string describirErrorPlan(const PlanSubredes& plan);
+
+/**
+ * @brief Indica si un plan no es correcto o tiene solicitudes no asignadas.
+ */
+inline bool planConProblemas(const PlanSubredes& plan) {
+    return plan.resultado != ResultadoPlan::Correcto || !plan.fallidas.empty();
+}
+
+/**
+ * @brief Escribe, una por línea y precedidos de 'contexto', el error de un plan no correcto o sus
+ * solicitudes no asignadas: lo que muestran las tablas y el CSV no tiene dónde poner.
+ * @param os Flujo de salida (normalmente el de errores).
+ * @param plan El plan.
+ * @param contexto Texto al principio de cada línea (ej. "Trabajo 2 (línea 3): 10.0.0.0/24").
+ */
+void informarProblemasPlan(std::ostream& os, const PlanSubredes& plan, const std::string& contexto);
+
+/**
+ * @brief Imprime el encabezado de la tabla de subredes, para consola o CSV.
+ * @param os Flujo de salida.
+ * @param is_csv Verdadero si se imprime en CSV, falso para consola.
+ */
+void printSubnetHeader(std::ostream& os, bool is_csv);
+
+/**
+ * @brief Imprime los detalles de una única subred, para consola o CSV.
+ * @param os Flujo de salida.
+ * @param subnet La subred a imprimir.
+ * @param is_csv Verdadero si se imprime en CSV, falso para consola.
+ * @param counter El número de la subred.
+ */
+void printSubnetRow(std::ostream& os, const Subred& subnet, bool is_csv, int counter);
+
+/**
+ * @brief Formato de un destino de salida.
+ */
+enum class FormatoSalida : uint8_t {
+    Tabla, // Tabla alineada para consola o archivo de texto
+    CSV    // Valores separados por comas
+};
+
+/**
+ * @brief Imprime planes en varios destinos (consola, archivos de texto, CSV) en un único recorrido.
+ * Cada fila se formatea una sola vez por formato y se copia en todos los destinos; el plan no se recalcula.
+ * La salida de cada plan se acumula en un búfer por destino y llega al flujo en bloques grandes
+ * al terminar el plan, sin vaciar el flujo en cada línea.
+ */
+class ImpresorPlan {
+public:
+    /**
+     * @brief Añade un destino. El flujo debe seguir existiendo mientras se use el impresor.
+     * @param os Flujo de salida.
+     * @param formato Formato de ese destino.
+     * @param encabezadoEscrito Solo en lote: el encabezado CSV de ese flujo ya se escribió
+     *        (ej. cuando varios impresores generan partes de un mismo CSV).
+     */
+    void agregarDestino(std::ostream& os, FormatoSalida formato, bool encabezadoEscrito = false);
+
+    /**
+     * @brief Imprime un plan completo en cada destino, con el mismo formato que un cálculo individual.
+     * @param plan El plan a imprimir.
+     */
+    void imprimir(const PlanSubredes& plan);
+
+    /**
+     * @brief Imprime un plan como parte de un lote de trabajos.
+     * Las tablas llevan un título por trabajo; los CSV forman una única tabla con una columna
+     * "Trabajo" inicial y omiten los mensajes de error y las solicitudes fallidas (que sí aparecen en las tablas).
+     * @param plan El plan a imprimir.
+     * @param trabajo Número de trabajo (mayor que 0).
+     * @param titulo Título del trabajo para las tablas.
+     */
+    void imprimirTrabajo(const PlanSubredes& plan, long long trabajo, const std::string& titulo);
+
+private:
+    struct Destino {
+        BuferSalida bufer;      // Acumula la salida del plan y la entrega al flujo por bloques
+        FormatoSalida formato;
+        bool encabezadoEscrito; // Solo en lote: el encabezado CSV se escribe una vez
+    };
+
+    void imprimirEnDestinos(const PlanSubredes& plan, long long trabajo, const std::string& titulo);
+    void generarEnDestinos(const PlanSubredes& plan, long long trabajo, const std::string& titulo);
+
+    std::vector<Destino> destinos;
+};
+
+/**
+ * @brief Imprime el encabezado del CSV de un lote de trabajos (con la columna "Trabajo").
+ * @param os Flujo de salida.
+ */
+void imprimirEncabezadoLoteCSV(std::ostream& os);
+
+/**
+ * @brief Imprime un plan completo: resumen de la red base, tabla de subredes y espacio remanente.
+ * @param os Flujo de salida (ej. cout o un ofstream).
+ * @param plan El plan a imprimir.
+ * @param is_csv_output Verdadero si la salida debe estar en formato CSV.
+ */
+void imprimirPlan(std::ostream& os, const PlanSubredes& plan, bool is_csv_output);
+
+/**
+ * @brief Calcula y muestra/exporta las subredes solicitadas (planificarSubredes + imprimirPlan).
+ * @param os Flujo de salida (ej. cout o un ofstream).
+ * @param ipBaseStr La dirección IP base de la red (como string para mensajes de error).
+ * @param cidrBase El prefijo CIDR de la red base.
+ * @param requestedHostCounts Un vector de números de hosts solicitados para las nuevas subredes.
+ * @param is_csv_output Verdadero si la salida debe estar en formato CSV.
+ */
+void calcularSubredes(std::ostream& os, const std::string& ipBaseStr, int cidrBase,
+                      const std::vector<int>& requestedHostCounts, bool is_csv_output);
+
+#endif // SUBREDES_H
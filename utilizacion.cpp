@@ -0,0 +1,302 @@
+#include "utilizacion.h"
+
+#include <algorithm> // Para std::min, std::sort
+#include <cmath>     // Para std::llround
+#include <string>    // Para std::to_string
+
+#include "bufer_salida.h" // BuferSalida
+
+using namespace std;
+
+// Los recuentos son popcount sobre palabras de 64 bits: en x86-64 con GCC se compila una versión con
+// la instrucción POPCNT que se elige al cargar el programa, y otra genérica para procesadores sin ella
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__) && defined(__linux__)
+#define UTILIZACION_CLONES __attribute__((target_clones("popcnt", "default")))
+#else
+#define UTILIZACION_CLONES
+#endif
+
+// MASCARAS_ALINEACION[j]: un bit en cada posición múltiplo de 2^j (inicio de los bloques alineados de 2^j bits)
+static const uint64_t MASCARAS_ALINEACION[6] = {
+    ~uint64_t(0),          0x5555555555555555ULL, 0x1111111111111111ULL,
+    0x0101010101010101ULL, 0x0001000100010001ULL, 0x0000000100000001ULL,
+};
+
+/**
+ * @brief Cuenta los bloques libres alineados de 2^kBase ... 2^(kBase+5) bloques mínimos de un nivel y
+ * construye el nivel superior (un bit por palabra, activo si está entera libre).
+ * @param palabras Palabras del nivel.
+ * @param cantidad Número de palabras.
+ * @param kBase Log2 de los bloques mínimos que representa cada bit del nivel.
+ * @param porK Acumula en porK[k] los bloques libres alineados de 2^k bloques mínimos.
+ * @param superior Recibe el nivel superior.
+ */
+UTILIZACION_CLONES
+static void contarNivel(const uint64_t* palabras, size_t cantidad, int kBase, uint64_t* porK, vector<uint64_t>& superior) {
+    superior.assign((cantidad + 63) / 64, 0);
+    uint64_t cuentas[6] = {};
+    for (size_t i = 0; i < cantidad; ++i) {
+        // Tras el paso j, el bit p de y indica que los bits p ... p + 2^j - 1 están libres
+        uint64_t y = palabras[i];
+        cuentas[0] += static_cast<uint64_t>(__builtin_popcountll(y));
+        for (int j = 1; j < 6; ++j) {
+            y &= y >> (1 << (j - 1));
+            cuentas[j] += static_cast<uint64_t>(__builtin_popcountll(y & MASCARAS_ALINEACION[j]));
+        }
+        superior[i >> 6] |= uint64_t(palabras[i] == ~uint64_t(0)) << (i & 63);
+    }
+    for (int j = 0; j < 6; ++j) {
+        porK[kBase + j] += cuentas[j];
+    }
+}
+
+/**
+ * @brief Cuenta los tramos de bits libres consecutivos (los bits que empiezan un tramo).
+ */
+UTILIZACION_CLONES
+static uint64_t contarTramos(const uint64_t* palabras, size_t cantidad) {
+    uint64_t tramos = 0;
+    uint64_t acarreo = 0; // Último bit de la palabra anterior
+    for (size_t i = 0; i < cantidad; ++i) {
+        const uint64_t x = palabras[i];
+        tramos += static_cast<uint64_t>(__builtin_popcountll(x & ~((x << 1) | acarreo)));
+        acarreo = x >> 63;
+    }
+    return tramos;
+}
+
+void MapaOcupacion::inicializar(uint32_t redBase, int cidrBase, int resolucionMapa) {
+    red = redBase;
+    cidr = cidrBase;
+    resolucion = resolucionMapa;
+    bits = size_t(1) << (resolucion - cidr);
+    libres.assign((bits + 63) / 64, ~uint64_t(0));
+    if (bits % 64 != 0) {
+        libres.back() = (uint64_t(1) << bits) - 1;
+    }
+}
+
+void MapaOcupacion::ocupar(const RangoIPv4& rango) {
+    const int desplazamiento = 32 - resolucion;
+    const size_t primero = static_cast<size_t>((uint64_t(rango.inicio) - red) >> desplazamiento);
+    const size_t ultimo = static_cast<size_t>((uint64_t(rango.fin) - red) >> desplazamiento);
+    const uint64_t desdePrimero = ~uint64_t(0) << (primero & 63);
+    const uint64_t hastaUltimo = ~uint64_t(0) >> (63 - (ultimo & 63));
+    const size_t palabraPrimero = primero >> 6;
+    const size_t palabraUltimo = ultimo >> 6;
+    if (palabraPrimero == palabraUltimo) {
+        libres[palabraPrimero] &= ~(desdePrimero & hastaUltimo);
+        return;
+    }
+    libres[palabraPrimero] &= ~desdePrimero;
+    fill(libres.begin() + static_cast<ptrdiff_t>(palabraPrimero + 1), libres.begin() + static_cast<ptrdiff_t>(palabraUltimo), 0);
+    libres[palabraUltimo] &= ~hastaUltimo;
+}
+
+void MapaOcupacion::analizar(AnalisisUtilizacion& analisis) const {
+    analisis.redBase = red;
+    analisis.cidrBase = cidr;
+    analisis.resolucion = resolucion;
+    analisis.totales = uint64_t(1) << (32 - cidr);
+
+    // porK[k]: bloques libres alineados de 2^k bloques mínimos; el nivel L cuenta k = 6L ... 6L + 5
+    const int kMaximo = resolucion - cidr;
+    uint64_t porK[MAXIMO_BITS_LOG2 + 6] = {};
+    vector<uint64_t> nivel;
+    vector<uint64_t> superior;
+    contarNivel(libres.data(), libres.size(), 0, porK, superior);
+    for (int kBase = 6; kBase <= kMaximo; kBase += 6) {
+        nivel.swap(superior);
+        contarNivel(nivel.data(), nivel.size(), kBase, porK, superior);
+    }
+
+    analisis.libres = porK[0] << (32 - resolucion);
+    analisis.usadas = analisis.totales - analisis.libres;
+    analisis.rangosLibres = contarTramos(libres.data(), libres.size());
+    analisis.bloquesLibres.fill(0);
+    analisis.mayorBloqueLibre = -1;
+    for (int k = 0; k <= kMaximo; ++k) {
+        analisis.bloquesLibres[static_cast<size_t>(resolucion - k)] = porK[k];
+        if (porK[k] > 0) {
+            analisis.mayorBloqueLibre = resolucion - k;
+        }
+    }
+    // Por debajo de la resolución, cada bloque mínimo libre contiene 2^(prefijo - resolución) bloques
+    for (int prefijo = resolucion + 1; prefijo <= 32; ++prefijo) {
+        analisis.bloquesLibres[static_cast<size_t>(prefijo)] = porK[0] << (prefijo - resolucion);
+    }
+    analisis.fragmentacion = analisis.libres > 0
+        ? 1.0 - static_cast<double>(uint64_t(1) << (32 - analisis.mayorBloqueLibre)) / static_cast<double>(analisis.libres)
+        : 0;
+}
+
+void analizarUtilizacion(const PlanSubredes& plan, AnalisisUtilizacion& analisis) {
+    analisis = AnalisisUtilizacion();
+    const uint32_t red = plan.redBase;
+
+    // Los reservados pueden salirse de la red base: solo cuenta la parte que está dentro
+    vector<RangoIPv4> ocupados;
+    ocupados.reserve(plan.subredes.size() + plan.reservados.size());
+    for (const Subred& subnet : plan.subredes) {
+        ocupados.push_back({subnet.red, subnet.broadcast()});
+        analisis.enSubredes += uint64_t(subnet.broadcast()) - subnet.red + 1;
+    }
+    for (const RangoIPv4& r : plan.reservados) {
+        if (r.fin >= plan.redBase && r.inicio <= plan.broadcastBase) {
+            ocupados.push_back({max(r.inicio, plan.redBase), min(r.fin, plan.broadcastBase)});
+        }
+    }
+
+    // La resolución exacta es la del mayor bloque al que están alineados todos los límites
+    uint64_t limites = plan.totalIps();
+    for (const RangoIPv4& r : ocupados) {
+        limites |= (uint64_t(r.inicio) - red) | (uint64_t(r.fin) + 1 - red);
+    }
+    const int resolucionExacta = 32 - __builtin_ctzll(limites);
+    const int resolucionMaxima = min(32, plan.cidrBase + MapaOcupacion::MAXIMO_BITS_LOG2);
+    analisis.exacto = resolucionExacta <= resolucionMaxima;
+
+    MapaOcupacion mapa;
+    mapa.inicializar(red, plan.cidrBase, min(resolucionExacta, resolucionMaxima));
+    for (const RangoIPv4& r : ocupados) {
+        mapa.ocupar(r);
+    }
+    mapa.analizar(analisis);
+    if (analisis.exacto) {
+        return;
+    }
+
+    // Con el mapa limitado, los bloques alineados de prefijo no mayor que la resolución ya son exactos
+    // (un bloque ocupado en parte no está entero libre); los totales, los tramos y los bloques más
+    // finos salen de los tramos libres entre los rangos ordenados
+    sort(ocupados.begin(), ocupados.end(), [](const RangoIPv4& a, const RangoIPv4& b) { return a.inicio < b.inicio; });
+    analisis.libres = 0;
+    analisis.rangosLibres = 0;
+    for (int prefijo = analisis.resolucion + 1; prefijo <= 32; ++prefijo) {
+        analisis.bloquesLibres[static_cast<size_t>(prefijo)] = 0;
+    }
+    const auto contarTramo = [&](uint64_t inicio, uint64_t fin) {
+        analisis.libres += fin - inicio + 1;
+        ++analisis.rangosLibres;
+        for (int prefijo = analisis.resolucion + 1; prefijo <= 32; ++prefijo) {
+            // Bloques alineados de 2^d direcciones enteros dentro de [inicio, fin]
+            const int d = 32 - prefijo;
+            const uint64_t primero = (inicio + (uint64_t(1) << d) - 1) >> d;
+            const uint64_t finBloques = (fin + 1) >> d;
+            if (finBloques > primero) {
+                analisis.bloquesLibres[static_cast<size_t>(prefijo)] += finBloques - primero;
+            }
+        }
+    };
+    uint64_t siguiente = red; // Primera dirección aún no cubierta
+    for (const RangoIPv4& r : ocupados) {
+        if (r.inicio > siguiente) {
+            contarTramo(siguiente, uint64_t(r.inicio) - 1);
+        }
+        siguiente = max(siguiente, uint64_t(r.fin) + 1);
+    }
+    if (siguiente <= plan.broadcastBase) {
+        contarTramo(siguiente, plan.broadcastBase);
+    }
+    analisis.usadas = analisis.totales - analisis.libres;
+    for (int prefijo = analisis.resolucion + 1; prefijo <= 32 && analisis.mayorBloqueLibre < 0; ++prefijo) {
+        if (analisis.bloquesLibres[static_cast<size_t>(prefijo)] > 0) {
+            analisis.mayorBloqueLibre = prefijo;
+        }
+    }
+    analisis.fragmentacion = analisis.libres > 0
+        ? 1.0 - static_cast<double>(uint64_t(1) << (32 - analisis.mayorBloqueLibre)) / static_cast<double>(analisis.libres)
+        : 0;
+}
+
+/**
+ * @brief Escribe un valor con decimales fijos a partir de su versión escalada (ej. 1234 con 2 decimales: "12.34").
+ */
+static void decimal(BuferSalida& os, uint64_t escalado, int decimales) {
+    uint64_t divisor = 1;
+    for (int i = 0; i < decimales; ++i) {
+        divisor *= 10;
+    }
+    os.entero(escalado / divisor);
+    os.caracter('.');
+    const uint64_t resto = escalado % divisor;
+    for (uint64_t d = divisor / 10; d > 0; d /= 10) {
+        os.caracter(static_cast<char>('0' + resto / d % 10));
+    }
+}
+
+/**
+ * @brief Escribe " (P %)" con dos decimales.
+ */
+static void porcentaje(BuferSalida& os, uint64_t parte, uint64_t total) {
+    os.texto(" (");
+    decimal(os, static_cast<uint64_t>(llround(10000.0 * static_cast<double>(parte) / static_cast<double>(total))), 2);
+    os.texto(" %)");
+}
+
+void imprimirUtilizacion(ostream& os, const AnalisisUtilizacion& analisis, bool is_csv_output) {
+    BuferSalida bufer(os);
+    if (is_csv_output) {
+        bufer.texto("Prefijo,BloquesLibres\n");
+        for (int prefijo = analisis.cidrBase; prefijo <= 32; ++prefijo) {
+            bufer.caracter('/');
+            bufer.entero(static_cast<uint64_t>(prefijo));
+            bufer.caracter(',');
+            bufer.entero(analisis.bloquesLibres[static_cast<size_t>(prefijo)]);
+            bufer.caracter('\n');
+        }
+        return;
+    }
+
+    bufer.texto("\n--- Utilización de ");
+    bufer.ipv4(analisis.redBase);
+    bufer.caracter('/');
+    bufer.entero(static_cast<uint64_t>(analisis.cidrBase));
+    bufer.texto(" ---\nResolución del mapa: /");
+    bufer.entero(static_cast<uint64_t>(analisis.resolucion));
+    bufer.texto(" (");
+    bufer.entero(uint64_t(1) << (analisis.resolucion - analisis.cidrBase));
+    bufer.texto(" bloques)");
+    if (!analisis.exacto) {
+        bufer.texto("; los prefijos más finos se cuentan sobre los tramos libres");
+    }
+    bufer.texto("\nIPs Totales: ");
+    bufer.entero(analisis.totales);
+    bufer.texto("\nIPs usadas: ");
+    bufer.entero(analisis.usadas);
+    porcentaje(bufer, analisis.usadas, analisis.totales);
+    bufer.texto("; en subredes: ");
+    bufer.entero(analisis.enSubredes);
+    bufer.texto(", reservadas: ");
+    bufer.entero(analisis.usadas - min(analisis.usadas, analisis.enSubredes));
+    bufer.texto("\nIPs libres: ");
+    bufer.entero(analisis.libres);
+    porcentaje(bufer, analisis.libres, analisis.totales);
+    bufer.texto(" en ");
+    bufer.entero(analisis.rangosLibres);
+    bufer.texto(analisis.rangosLibres == 1 ? " tramo\n" : " tramos\n");
+    if (analisis.mayorBloqueLibre < 0) {
+        bufer.texto("No queda espacio libre.\n");
+    } else {
+        bufer.texto("Mayor bloque libre alineado: /");
+        bufer.entero(static_cast<uint64_t>(analisis.mayorBloqueLibre));
+        bufer.texto(" (");
+        bufer.entero(uint64_t(1) << (32 - analisis.mayorBloqueLibre));
+        bufer.texto(" IPs)\nFragmentación: ");
+        decimal(bufer, static_cast<uint64_t>(llround(analisis.fragmentacion * 10000)), 4);
+        bufer.texto(" (0 = todo el espacio libre cabe en el mayor bloque alineado)\n");
+    }
+
+    bufer.texto("\nBloques libres alineados por prefijo (disjuntos en cada prefijo; los de un prefijo incluyen los que forman los mayores):\n");
+    for (int prefijo = analisis.cidrBase; prefijo <= 32; ++prefijo) {
+        const uint64_t bloques = analisis.bloquesLibres[static_cast<size_t>(prefijo)];
+        if (bloques == 0) {
+            continue;
+        }
+        bufer.texto("  /");
+        bufer.columna(to_string(prefijo), 4);
+        bufer.entero(bloques);
+        bufer.caracter('\n');
+    }
+    bufer.texto("-------------------------------------------\n");
+}
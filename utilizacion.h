@@ -0,0 +1,91 @@
+#ifndef UTILIZACION_H
+#define UTILIZACION_H
+
+#include <array>   // Para std::array
+#include <cstddef> // Para size_t
+#include <cstdint> // Para uint32_t y otros tipos enteros de ancho fijo
+#include <ostream> // Para std::ostream
+#include <vector>  // Para std::vector
+
+#include "subredes.h" // PlanSubredes
+
+/**
+ * @brief Resultado del análisis de utilización de una red base.
+ */
+struct AnalisisUtilizacion {
+    uint32_t redBase = 0;
+    int cidrBase = 0;
+    int resolucion = 32;         // Prefijo del bloque que representa cada bit del mapa
+    bool exacto = true;          // Falso si algún rango no está alineado a la resolución: los prefijos más finos se cuentan sobre los tramos libres
+    uint64_t totales = 0;        // Direcciones de la red base
+    uint64_t usadas = 0;         // Ocupadas por subredes o rangos reservados
+    uint64_t libres = 0;
+    uint64_t enSubredes = 0;     // Direcciones de las subredes del plan
+    uint64_t rangosLibres = 0;   // Tramos contiguos de espacio libre
+    int mayorBloqueLibre = -1;   // Prefijo del mayor bloque libre alineado (-1 si no hay espacio libre)
+    double fragmentacion = 0;    // 1 - (mayor bloque libre alineado / direcciones libres); 0 si no hay libres
+    std::array<uint64_t, 33> bloquesLibres = {}; // Bloques libres alineados disjuntos de cada prefijo
+};
+
+/**
+ * @brief Mapa de ocupación jerárquico de una red base.
+ *
+ * El nivel 0 tiene un bit por bloque mínimo (1 = libre), agrupado en palabras de 64 bits; cada nivel
+ * superior tiene un bit por palabra del anterior, activo si sus 64 bloques están libres. Dentro de
+ * una palabra, los bloques libres alineados de 2, 4, ... 32 bits se cuentan con desplazamientos, una
+ * máscara y popcount, y los de 64 o más, en los niveles superiores: cada prefijo se cuenta en una
+ * sola pasada por el nivel que le corresponde.
+ *
+ * La resolución es la del mayor bloque al que están alineados todos los límites del plan y de los
+ * reservados (un bit por dirección solo si hace falta), con un máximo de 2^26 bits (8 MiB); con ese
+ * máximo, el mapa marca ocupados los bloques tocados en parte y analizarUtilizacion() completa los
+ * totales y los prefijos más finos a partir de los tramos libres.
+ */
+class MapaOcupacion {
+public:
+    static const int MAXIMO_BITS_LOG2 = 26;
+
+    /**
+     * @brief Prepara un mapa con toda la red libre.
+     * @param redBase Dirección de la red base.
+     * @param cidrBase Prefijo de la red base.
+     * @param resolucion Prefijo del bloque de cada bit (entre cidrBase y cidrBase + MAXIMO_BITS_LOG2, como mucho 32).
+     */
+    void inicializar(uint32_t redBase, int cidrBase, int resolucion);
+
+    /**
+     * @brief Marca un rango como ocupado (los bloques que toca, aunque sea en parte).
+     * @param rango Rango dentro de la red base.
+     */
+    void ocupar(const RangoIPv4& rango);
+
+    /**
+     * @brief Cuenta las direcciones libres, los tramos libres y los bloques libres alineados de cada prefijo.
+     * @param analisis Recibe los resultados (se conservan los campos del plan: enSubredes, exacto).
+     */
+    void analizar(AnalisisUtilizacion& analisis) const;
+
+private:
+    uint32_t red = 0;
+    int cidr = 0;
+    int resolucion = 32;
+    size_t bits = 0;              // Bloques de la red base (bits útiles del nivel 0)
+    std::vector<uint64_t> libres; // Nivel 0; los bits tras 'bits' quedan a 0
+};
+
+/**
+ * @brief Analiza la utilización de la red base de un plan: subredes y rangos reservados.
+ * @param plan Plan calculado (resultado Correcto).
+ * @param analisis Recibe los resultados.
+ */
+void analizarUtilizacion(const PlanSubredes& plan, AnalisisUtilizacion& analisis);
+
+/**
+ * @brief Imprime el análisis: resumen y bloques libres por prefijo (tabla), o solo estos (CSV).
+ * @param os Flujo de salida.
+ * @param analisis El análisis.
+ * @param is_csv_output Verdadero para CSV.
+ */
+void imprimirUtilizacion(std::ostream& os, const AnalisisUtilizacion& analisis, bool is_csv_output);
+
+#endif // UTILIZACION_H